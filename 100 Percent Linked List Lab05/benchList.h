@@ -0,0 +1,1110 @@
+/***********************************************************************
+ * Header:
+ *    BENCH LIST
+ * Summary:
+ *    Timings for list and the containers built alongside it.  These
+ *    are not pass/fail; they print how long each scenario took so
+ *    the alternatives can be compared on the same machine.
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "list.h"
+#include "unrolledList.h"
+#include "concurrentList.h"
+#include "spscList.h"
+#include "lockedList.h"
+#include "rcuList.h"
+#include "magazine.h"
+#include "indexedList.h"
+#include "hash.h"
+#include "lruCache.h"
+#include "lfuCache.h"
+#include "persistentList.h"
+
+#include <algorithm> // for std::sort
+#include <chrono>    // for std::chrono::steady_clock
+#include <cmath>     // for std::pow
+#include <iostream>  // for std::cout
+#include <iomanip>   // for std::setw
+#include <mutex>     // for std::mutex
+#include <string>    // for std::to_string
+#include <thread>    // for std::thread
+#include <unordered_map> // for std::unordered_map
+#include <vector>    // for std::vector
+
+class BenchList
+{
+public:
+   void run()
+   {
+      bench_iterate_unrolled();
+      bench_compact();
+      bench_prefetch();
+      bench_splice();
+      bench_concurrent();
+      bench_spsc();
+      bench_locked();
+      bench_rcu();
+      bench_hazard();
+      bench_magazine();
+      bench_indexed();
+      bench_finger();
+      bench_hash();
+      bench_lru();
+      bench_lfu();
+      bench_persistent();
+      bench_cow();
+   }
+
+   /***************************************
+    * ITERATE: list vs. unrolled_list
+    ***************************************/
+   void bench_iterate_unrolled()
+   {
+      const int num = 1000000;
+      const int passes = 20;
+
+      // a fresh list: the nodes are laid out in order
+      custom::list<int> lFresh;
+      for (int i = 0; i < num; i++)
+         lFresh.push_back(i);
+
+      // a churned list: erased nodes are reused at the back, so the
+      // traversal order no longer matches the memory order
+      custom::list<int> lChurned;
+      for (int i = 0; i < num; i++)
+         lChurned.push_back(i);
+      churn(lChurned, num);
+
+      custom::unrolled_list<int> lUnrolled;
+      for (int i = 0; i < num; i++)
+         lUnrolled.push_back(i);
+
+      std::cout << "Iterate " << num << " ints, " << passes << " passes\n";
+      report("list (fresh)",    time([&]() { return sum(lFresh,    passes); }));
+      report("list (churned)",  time([&]() { return sum(lChurned,  passes); }));
+      report("unrolled_list",   time([&]() { return sum(lUnrolled, passes); }));
+   }
+
+   /***************************************
+    * COMPACT: churned list before and after
+    ***************************************/
+   void bench_compact()
+   {
+      const int num = 1000000;
+      const int passes = 20;
+
+      custom::list<int> l;
+      for (int i = 0; i < num; i++)
+         l.push_back(i);
+      churn(l, num);
+      churn(l, num);
+
+      std::cout << "Compact " << num << " ints, fragmentation "
+                << std::setprecision(3) << l.fragmentation() << "\n";
+      report("iterate before", time([&]() { return sum(l, passes); }));
+      report("compact", time([&]() { l.compact(); return 0LL; }));
+      report("iterate after",  time([&]() { return sum(l, passes); }));
+   }
+
+   /***************************************
+    * PREFETCH: plain iterator vs. for_each
+    ***************************************/
+   void bench_prefetch()
+   {
+      const int num = 1000000;
+      const int passes = 10;
+
+      // scatter the nodes so each hop is likely a miss
+      custom::list<int> l;
+      for (int i = 0; i < num; i++)
+         l.push_back(i);
+      for (int i = 0; i < 4; i++)
+         churn(l, num);
+
+      // a little work per element, as a real visitor would do
+      long long total = 0;
+      auto visit = [&](int & data)
+      {
+         unsigned int h = (unsigned int)data;
+         for (int i = 0; i < 8; i++)
+            h = h * 2654435761u + 1;
+         total += h;
+      };
+
+      std::cout << "Prefetch " << num << " ints, fragmentation "
+                << std::setprecision(3) << l.fragmentation() << ", "
+                << passes << " passes\n";
+      report("iterator", time([&]()
+      {
+         for (int pass = 0; pass < passes; pass++)
+            for (auto it = l.begin(); it != l.end(); ++it)
+               visit(*it);
+         return total;
+      }));
+      for (size_t distance : { 1, 2, 4, 8, 16, 32 })
+      {
+         std::string name = "for_each distance " + std::to_string(distance);
+         report(name.c_str(), time([&]()
+         {
+            for (int pass = 0; pass < passes; pass++)
+               l.for_each(visit, distance);
+            return total;
+         }));
+      }
+   }
+
+   /***************************************
+    * SPLICE: moving batches between queues
+    ***************************************/
+   void bench_splice()
+   {
+      const int num = 100000;
+      const int batch = 64;
+      const int rounds = 200;
+
+      custom::list<int> lFrom;
+      custom::list<int> lTo;
+      for (int i = 0; i < num; i++)
+         lFrom.push_back(i);
+
+      std::cout << "Move " << num << " ints in batches of " << batch
+                << ", " << rounds << " rounds\n";
+      report("pop_front / push_back", time([&]()
+      {
+         for (int round = 0; round < rounds; round++)
+         {
+            custom::list<int> & src = (round % 2) ? lTo : lFrom;
+            custom::list<int> & des = (round % 2) ? lFrom : lTo;
+            while (!src.empty())
+               for (int i = 0; i < batch && !src.empty(); i++)
+               {
+                  des.push_back(src.front());
+                  src.pop_front();
+               }
+         }
+         return (long long)lFrom.size();
+      }));
+      report("splice", time([&]()
+      {
+         for (int round = 0; round < rounds; round++)
+         {
+            custom::list<int> & src = (round % 2) ? lTo : lFrom;
+            custom::list<int> & des = (round % 2) ? lFrom : lTo;
+            while (!src.empty())
+            {
+               auto last = src.begin();
+               for (int i = 0; i < batch && last != src.end(); i++)
+                  ++last;
+               des.splice(des.end(), src, src.begin(), last);
+            }
+         }
+         return (long long)lFrom.size();
+      }));
+   }
+
+   /***************************************
+    * CONCURRENT: lock-free vs. one mutex
+    ***************************************/
+   void bench_concurrent()
+   {
+      const int numOps = 200000;   // split between the threads
+      const int numKeys = 512;
+
+      std::cout << "Concurrent " << numOps << " ops on " << numKeys / 2
+                << " of " << numKeys << " keys: 25% insert, 25% erase, 50% find\n";
+      for (int numThreads : { 1, 2, 4, 8, 16, 32, 64 })
+      {
+         custom::concurrent_list<int> lLockFree;
+         MutexList lMutex;
+         for (int i = 0; i < numKeys; i += 2)
+         {
+            lLockFree.push_back(i);
+            lMutex.push_back(i);
+         }
+
+         std::string name = std::to_string(numThreads) + " threads, ";
+         report((name + "mutex list").c_str(),
+                time([&]() { return mixed(lMutex, numThreads, numOps, numKeys); }));
+         report((name + "concurrent_list").c_str(),
+                time([&]() { return mixed(lLockFree, numThreads, numOps, numKeys); }));
+      }
+   }
+
+   /***************************************
+    * SPSC: hand-off latency, one each way
+    ***************************************/
+   void bench_spsc()
+   {
+      const int num = 200000;
+
+      // a custom::list behind a single lock, used the same way
+      struct MutexQueue
+      {
+         std::mutex lock;
+         custom::list<long long> l;
+         void push_back(long long data)
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            l.push_back(data);
+         }
+         bool pop(long long & data)
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            if (l.empty())
+               return false;
+            data = l.front();
+            l.pop_front();
+            return true;
+         }
+      };
+
+      custom::spsc_list<long long> lSpsc;
+      MutexQueue lMutex;
+
+      std::cout << "Hand off " << num << " timestamps, producer to consumer\n";
+      reportLatency("mutex list", latency(num,
+         [&](long long stamp) { lMutex.push_back(stamp); },
+         [&](long long & stamp) { return lMutex.pop(stamp); }));
+      reportLatency("spsc_list", latency(num,
+         [&](long long stamp) { lSpsc.push_back(stamp); },
+         [&](long long & stamp)
+         {
+            if (lSpsc.empty())
+               return false;
+            stamp = lSpsc.front();
+            lSpsc.pop_front();
+            return true;
+         }));
+   }
+
+   /***************************************
+    * LOCKED: hand over hand vs. one mutex
+    ***************************************/
+   void bench_locked()
+   {
+      const int numOps = 100000;   // split between the threads
+      const int numKeys = 2048;    // long enough for threads to spread out
+
+      // find and erase by value, as mixed() wants them
+      struct LockedList
+      {
+         custom::locked_list<int> l;
+         void push_front(int data) { l.push_front(data); }
+         void push_back(int data)  { l.push_back(data);  }
+         bool find(int data)       { return l.find(data) != l.end(); }
+         bool erase(int data)
+         {
+            auto it = l.find(data);
+            if (it == l.end())
+               return false;
+            l.erase(std::move(it));
+            return true;
+         }
+      };
+
+      std::cout << "Locked " << numOps << " ops on " << numKeys / 2
+                << " of " << numKeys << " keys: 25% insert, 25% erase, 50% find\n";
+      for (int numThreads : { 1, 2, 4, 8, 16, 32 })
+      {
+         MutexList lMutex;
+         LockedList lLocked;
+         for (int i = 0; i < numKeys; i += 2)
+         {
+            lMutex.push_back(i);
+            lLocked.push_back(i);
+         }
+
+         std::string name = std::to_string(numThreads) + " threads, ";
+         report((name + "mutex list").c_str(),
+                time([&]() { return mixed(lMutex, numThreads, numOps, numKeys); }));
+         report((name + "locked_list").c_str(),
+                time([&]() { return mixed(lLocked, numThreads, numOps, numKeys); }));
+      }
+   }
+
+   /***************************************
+    * RCU: readers with a rare writer
+    ***************************************/
+   void bench_rcu()
+   {
+      const int numReads = 400000;   // split between the readers
+      const int numKeys = 256;
+      const int writeEvery = 1000;   // reads per replace, on the writer thread
+
+      // every reader thread looks up keys while one more thread
+      // replaces a key now and then, until the readers are done
+      auto readMostly = [&](auto & l, int numThreads)
+      {
+         std::atomic<int> numDone(0);
+         std::atomic<long long> numFound(0);
+         std::thread writer([&]()
+         {
+            int key = 0;
+            while (numDone.load() < numThreads)
+            {
+               l.replace(key, key);
+               key = (key + 2) % numKeys;
+               for (int i = 0; i < writeEvery && numDone.load() < numThreads; i++)
+                  std::this_thread::yield();
+            }
+         });
+         std::vector<std::thread> readers;
+         for (int t = 0; t < numThreads; t++)
+            readers.push_back(std::thread([&, t]()
+            {
+               unsigned int seed = 12345 + t;
+               long long found = 0;
+               for (int i = 0; i < numReads / numThreads; i++)
+               {
+                  seed = seed * 1103515245 + 12345;
+                  found += l.find((int)((seed >> 8) % numKeys));
+               }
+               numFound += found;
+               numDone++;
+            }));
+         for (auto & reader : readers)
+            reader.join();
+         writer.join();
+         return numFound.load();
+      };
+
+      // the single-mutex list, with replace written the obvious way
+      struct MutexRoutes : MutexList
+      {
+         void replace(int oldData, int newData)
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto it = l.begin(); it != l.end(); ++it)
+               if (*it == oldData)
+               {
+                  *it = newData;
+                  return;
+               }
+         }
+      };
+
+      std::cout << "Read-mostly " << numReads << " lookups in " << numKeys / 2
+                << " of " << numKeys << " keys, one writer\n";
+      for (int numThreads : { 1, 2, 4, 8, 16, 32 })
+      {
+         MutexRoutes lMutex;
+         custom::rcu_list<int> lRcu;
+         for (int i = 0; i < numKeys; i += 2)
+         {
+            lMutex.push_back(i);
+            lRcu.push_back(i);
+         }
+
+         std::string name = std::to_string(numThreads) + " readers, ";
+         report((name + "mutex list").c_str(),
+                time([&]() { return readMostly(lMutex, numThreads); }));
+         report((name + "rcu_list").c_str(),
+                time([&]() { return readMostly(lRcu, numThreads); }));
+      }
+   }
+
+   /***************************************
+    * HAZARD: cost of retiring instead of freeing
+    ***************************************/
+   void bench_hazard()
+   {
+      const int num = 200000;
+
+      // pop every node off a list, freeing or retiring each one
+      auto drain = [&](custom::hazard_domain * pDomain)
+      {
+         custom::list<int> l;
+         for (int i = 0; i < num; i++)
+            l.push_back(i);
+         l.retire_into(pDomain);
+         return time([&]()
+         {
+            while (!l.empty())
+               l.pop_front();
+            return (long long)l.capacity();
+         });
+      };
+
+      std::cout << "Erase " << num << " nodes, per erase\n";
+      double msDelete = drain(nullptr);
+      reportEach("delete at once", msDelete, num);
+      for (int numReaders : { 0, 8, 16, 32 })
+      {
+         // each reader fills its slots and holds them while we erase,
+         // so every scan has numReaders * SLOTS hazards to look through
+         custom::hazard_domain domain;
+         std::vector<int> guarded(numReaders * custom::hazard_domain::SLOTS);
+         std::atomic<int> numReady(0);
+         std::atomic<bool> done(false);
+         std::vector<std::thread> readers;
+         for (int t = 0; t < numReaders; t++)
+            readers.push_back(std::thread([&, t]()
+            {
+               custom::hazard_pointer hp0(domain), hp1(domain), hp2(domain), hp3(domain);
+               int * p = &guarded[t * custom::hazard_domain::SLOTS];
+               hp0.set(p);
+               hp1.set(p + 1);
+               hp2.set(p + 2);
+               hp3.set(p + 3);
+               numReady++;
+               while (!done)
+                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }));
+         while (numReady.load() < numReaders)
+            std::this_thread::yield();
+
+         double ms = drain(&domain);
+         done = true;
+         for (auto & reader : readers)
+            reader.join();
+
+         std::string name = "retire, " + std::to_string(numReaders) + " readers";
+         reportEach(name.c_str(), ms, num);
+         reportEach("   reclamation alone", ms - msDelete, num);
+      }
+   }
+
+   void bench_magazine()
+   {
+      const int numOps = 400000;   // split between the threads
+      const int numLive = 64;      // blocks each thread holds at once
+      const size_t size = 24;      // a list<int> node
+
+      // each thread keeps a ring of live blocks, freeing the oldest
+      // to make room for each new one
+      auto churnBlocks = [&](int numThreads, void * (*alloc)(size_t),
+                             void (*dealloc)(void *, size_t))
+      {
+         std::vector<std::thread> threads;
+         for (int t = 0; t < numThreads; t++)
+            threads.push_back(std::thread([&]()
+            {
+               void * live[numLive] = {};
+               for (int i = 0; i < numOps / numThreads; i++)
+               {
+                  void *& p = live[i % numLive];
+                  if (p)
+                     dealloc(p, size);
+                  p = alloc(size);
+               }
+               for (void * p : live)
+                  if (p)
+                     dealloc(p, size);
+            }));
+         for (auto & thread : threads)
+            thread.join();
+         return (long long)numOps;
+      };
+
+      // each thread builds and tears down short lists
+      auto churnLists = [&](int numThreads, auto tag)
+      {
+         typedef decltype(tag) List;
+         std::vector<std::thread> threads;
+         for (int t = 0; t < numThreads; t++)
+            threads.push_back(std::thread([&]()
+            {
+               for (int i = 0; i < numOps / numThreads / 8; i++)
+               {
+                  List l;
+                  for (int j = 0; j < 8; j++)
+                     l.push_back(j);
+               }
+            }));
+         for (auto & thread : threads)
+            thread.join();
+         return (long long)numOps;
+      };
+
+      auto newBlock    = [](size_t n) { return ::operator new(n); };
+      auto deleteBlock = [](void * p, size_t) { ::operator delete(p); };
+
+      std::cout << "Allocate " << numOps << " blocks of " << size << " bytes\n";
+      for (int numThreads : { 1, 8, 32 })
+      {
+         std::string name = std::to_string(numThreads) + " threads, ";
+         report((name + "new / delete").c_str(),
+                time([&]() { return churnBlocks(numThreads, newBlock, deleteBlock); }));
+         report((name + "magazine_cache").c_str(),
+                time([&]() { return churnBlocks(numThreads, custom::magazine_cache::allocate,
+                                                custom::magazine_cache::deallocate); }));
+         report((name + "list, new").c_str(),
+                time([&]() { return churnLists(numThreads, custom::list<int>()); }));
+         report((name + "list, magazine").c_str(),
+                time([&]() { return churnLists(numThreads,
+                                custom::list<int, custom::magazine_allocator<int>>()); }));
+      }
+   }
+
+   void bench_indexed()
+   {
+      const int numLookups = 20000;
+
+      std::cout << "Look up " << numLookups << " random elements, per lookup\n";
+      for (int num : { 4, 16, 64, 256, 1024, 16384, 1048576 })
+      {
+         custom::list<int> l;
+         custom::indexed_list<int> lIndexed;
+         for (int i = 0; i < num; i++)
+         {
+            l.push_back(i);
+            lIndexed.insert(lIndexed.end(), i);
+         }
+
+         // the same keys for everyone; fewer on the long lists, where
+         // a linear scan would take all day
+         int numKeys = std::min(numLookups, 20000000 / num + 1);
+         std::vector<int> keys;
+         unsigned int seed = 1;
+         for (int i = 0; i < numKeys; i++)
+         {
+            seed = seed * 1103515245 + 12345;
+            keys.push_back((seed >> 8) % num);
+         }
+
+         std::string name = std::to_string(num) + " elements, ";
+         reportEach((name + "list scan").c_str(), time([&]()
+         {
+            long long found = 0;
+            for (int key : keys)
+               for (auto it = l.begin(); it != l.end(); ++it)
+                  if (*it == key)
+                  {
+                     found++;
+                     break;
+                  }
+            return found;
+         }), numKeys);
+         reportEach((name + "indexed find").c_str(), time([&]()
+         {
+            long long found = 0;
+            for (int key : keys)
+               found += lIndexed.find(key) != lIndexed.end();
+            return found;
+         }), numKeys);
+         reportEach((name + "list advance").c_str(), time([&]()
+         {
+            long long sum = 0;
+            for (int key : keys)
+            {
+               auto it = l.begin();
+               for (int i = 0; i < key; i++)
+                  ++it;
+               sum += *it;
+            }
+            return sum;
+         }), numKeys);
+         reportEach((name + "indexed at").c_str(), time([&]()
+         {
+            long long sum = 0;
+            for (int key : keys)
+               sum += lIndexed.at(key);
+            return sum;
+         }), numKeys);
+      }
+   }
+
+   void bench_finger()
+   {
+      const int num = 20000;
+      custom::list<int> l;
+      for (int i = 0; i < num; i++)
+         l.push_back(i);
+
+      // each index a few places from the one before
+      std::vector<size_t> indexes;
+      unsigned int seed = 1;
+      size_t i = num / 2;
+      for (int j = 0; j < num; j++)
+      {
+         seed = seed * 1103515245 + 12345;
+         i = std::min<size_t>(num - 1, std::max<int>(0, (int)i + (int)((seed >> 8) % 9) - 4));
+         indexes.push_back(i);
+      }
+
+      std::cout << "Positional access at " << num << " nearby indexes of "
+                << num << ", per access\n";
+      reportEach("walk from begin()", time([&]()
+      {
+         long long sum = 0;
+         for (size_t index : indexes)
+         {
+            auto it = l.begin();
+            for (size_t k = 0; k < index; k++)
+               ++it;
+            sum += *it;
+         }
+         return sum;
+      }), num);
+      reportEach("at() with finger", time([&]()
+      {
+         long long sum = 0;
+         for (size_t index : indexes)
+            sum += l.at(index);
+         return sum;
+      }), num);
+   }
+
+   void bench_hash()
+   {
+      // keys spread out the way a real hash table would see them
+      auto keys = [](int num)
+      {
+         std::vector<int> v;
+         unsigned int seed = 1;
+         for (int i = 0; i < num; i++)
+         {
+            seed = seed * 1103515245 + 12345;
+            v.push_back((int)(seed >> 1));
+         }
+         return v;
+      };
+
+      // insert every key, then look every one up along with as many misses
+      auto insertFind = [this](auto & m, const std::vector<int> & v, double & msInsert, double & msFind)
+      {
+         msInsert = time([&]()
+         {
+            for (int key : v)
+               m[key] = key;
+            return (long long)m.size();
+         });
+         msFind = time([&]()
+         {
+            long long found = 0;
+            for (int key : v)
+               found += m.find(key) != m.end();
+            for (int key : v)
+               found += m.find(~key) != m.end();
+            return found;
+         });
+      };
+
+      for (int num : { 1000, 100000, 1000000 })
+      {
+         std::vector<int> v = keys(num);
+         std::cout << "Hash " << num << " keys, per operation\n";
+         double msInsert, msFind;
+         {
+            std::unordered_map<int, int> m;
+            insertFind(m, v, msInsert, msFind);
+            reportEach("std insert", msInsert, num);
+            reportEach("std find", msFind, 2 * num);
+         }
+         {
+            custom::unordered_map<int, int> m;
+            insertFind(m, v, msInsert, msFind);
+            reportEach("custom insert", msInsert, num);
+            reportEach("custom find", msFind, 2 * num);
+         }
+         {
+            custom::unordered_map<int, int> m;
+            m.reserve(num);
+            insertFind(m, v, msInsert, msFind);
+            reportEach("custom insert, reserved", msInsert, num);
+         }
+      }
+   }
+
+   /***************************************
+    * LRU
+    * Hits on a full cache.  lru_cache relinks
+    * the hit node to the front; the naive way
+    * erases it, pushes a copy on the front, and
+    * points the index at the new node.  Then
+    * misses, each of which evicts.
+    ***************************************/
+   void bench_lru()
+   {
+      const int numEntries = 1024;
+      const int numGets = 4000000;
+
+      // the keys to get, all of them present, in a scattered order
+      std::vector<int> v;
+      unsigned int seed = 1;
+      for (int i = 0; i < numGets; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         v.push_back((int)((seed >> 8) % numEntries));
+      }
+
+      std::cout << "LRU " << numEntries << " entries, per operation\n";
+      {
+         custom::lru_cache<int, int> cache(numEntries);
+         for (int key = 0; key < numEntries; key++)
+            cache.put(key, key);
+         reportEach("lru_cache hit", time([&]()
+         {
+            long long sum = 0;
+            for (int key : v)
+               sum += *cache.get(key);
+            return sum;
+         }), numGets);
+         reportEach("lru_cache miss", time([&]()
+         {
+            for (int i = 0; i < numGets; i++)
+               cache.put(numEntries + i, i);
+            return (long long)cache.size();
+         }), numGets);
+      }
+      {
+         typedef custom::list<std::pair<int, int>> List;
+         List entries;
+         custom::unordered_map<int, List::iterator> index;
+         for (int key = 0; key < numEntries; key++)
+         {
+            entries.push_front(std::make_pair(key, key));
+            index[key] = entries.begin();
+         }
+         reportEach("erase and push_front hit", time([&]()
+         {
+            long long sum = 0;
+            for (int key : v)
+            {
+               List::iterator & it = index.find(key)->second;
+               std::pair<int, int> entry = *it;
+               entries.erase(it);
+               entries.push_front(entry);
+               it = entries.begin();
+               sum += entry.second;
+            }
+            return sum;
+         }), numGets);
+      }
+   }
+
+   /***************************************
+    * LFU
+    * LRU against LFU on Zipfian traces: get each
+    * key and put it on a miss.  The skew is how
+    * much the popular keys dominate.
+    ***************************************/
+   void bench_lfu()
+   {
+      const int numKeys = 100000;
+      const int numEntries = 1000;
+      const int numRequests = 2000000;
+
+      for (double skew : { 0.8, 0.99, 1.2 })
+      {
+         // the chance of drawing each key or any more popular one
+         std::vector<double> cdf(numKeys);
+         double sum = 0.0;
+         for (int i = 0; i < numKeys; i++)
+            cdf[i] = sum += 1.0 / std::pow(i + 1.0, skew);
+         for (double & p : cdf)
+            p /= sum;
+
+         std::vector<int> trace;
+         unsigned long long seed = 1;
+         for (int i = 0; i < numRequests; i++)
+         {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            double u = (double)(seed >> 11) / (double)(1ULL << 53);
+            trace.push_back((int)(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()));
+         }
+
+         // run the trace, counting the hits
+         auto replay = [&](auto & cache, long long & hits)
+         {
+            return time([&]()
+            {
+               hits = 0;
+               for (int key : trace)
+               {
+                  if (cache.get(key))
+                     hits++;
+                  else
+                     cache.put(key, key);
+               }
+               return hits;
+            });
+         };
+
+         std::cout << "Zipf " << std::setprecision(2) << skew << ", " << numKeys << " keys, "
+                   << numEntries << " entries, per request\n";
+         long long hits;
+         {
+            custom::lru_cache<int, int> cache(numEntries);
+            double ms = replay(cache, hits);
+            reportEach("lru_cache", ms, numRequests);
+            reportHits("lru_cache hit rate", hits, numRequests);
+         }
+         {
+            custom::lfu_cache<int, int> cache(numEntries);
+            double ms = replay(cache, hits);
+            reportEach("lfu_cache", ms, numRequests);
+            reportHits("lfu_cache hit rate", hits, numRequests);
+         }
+      }
+   }
+
+   /***************************************
+    * PERSISTENT
+    * Snapshot a list, then change the original,
+    * over and over: a custom::list is copied
+    * element by element, a persistent_list shares.
+    ***************************************/
+   void bench_persistent()
+   {
+      for (int num : { 100, 10000, 1000000 })
+      {
+         int numSnapshots = std::max(10, 10000000 / num);
+         std::cout << "Snapshot " << num << " elements, per snapshot\n";
+         {
+            custom::list<int> l;
+            for (int i = 0; i < num; i++)
+               l.push_back(i);
+            reportEach("custom::list copy", time([&]()
+            {
+               long long sum = 0;
+               for (int i = 0; i < numSnapshots; i++)
+               {
+                  custom::list<int> snapshot(l);
+                  l.pop_front();
+                  l.push_back(i);
+                  sum += snapshot.front();
+               }
+               return sum;
+            }), numSnapshots);
+         }
+         {
+            std::vector<int> v;
+            for (int i = 0; i < num; i++)
+               v.push_back(i);
+            custom::persistent_list<int> l(v.begin(), v.end());
+            reportEach("persistent_list copy", time([&]()
+            {
+               long long sum = 0;
+               for (int i = 0; i < numSnapshots; i++)
+               {
+                  custom::persistent_list<int> snapshot(l);
+                  l.pop_front();
+                  l.push_back(i);
+                  sum += snapshot.front();
+               }
+               return sum;
+            }), numSnapshots);
+         }
+      }
+   }
+
+   /***************************************
+    * COW
+    * Copy a list and read the copy, with and
+    * without copy-on-write.  Then the same, but
+    * changing the copy, which costs the deep copy
+    * after all.
+    ***************************************/
+   void bench_cow()
+   {
+      for (int num : { 10, 1000, 100000 })
+      {
+         int numCopies = std::max(10, 10000000 / num);
+         std::cout << "Copy " << num << " elements, per copy\n";
+         for (bool cow : { false, true })
+         {
+            custom::list<int> l;
+            for (int i = 0; i < num; i++)
+               l.push_back(i);
+            l.copy_on_write(cow);
+            reportEach(cow ? "copy-on-write, read" : "deep copy, read", time([&]()
+            {
+               long long sum = 0;
+               for (int i = 0; i < numCopies; i++)
+               {
+                  custom::list<int> copy(l);
+                  const custom::list<int> & read = copy;
+                  sum += read.front() + read.back();
+               }
+               return sum;
+            }), numCopies);
+            reportEach(cow ? "copy-on-write, change" : "deep copy, change", time([&]()
+            {
+               long long sum = 0;
+               for (int i = 0; i < numCopies; i++)
+               {
+                  custom::list<int> copy(l);
+                  copy.push_back(i);
+                  sum += copy.back();
+               }
+               return sum;
+            }), numCopies);
+         }
+      }
+   }
+
+   /***************************************
+    * Helpers
+    ***************************************/
+
+   // a custom::list behind a single lock
+   struct MutexList
+   {
+      std::mutex lock;
+      custom::list<int> l;
+      void push_front(int data) { std::lock_guard<std::mutex> guard(lock); l.push_front(data); }
+      void push_back(int data)  { std::lock_guard<std::mutex> guard(lock); l.push_back(data);  }
+      bool find(int data)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         for (auto it = l.begin(); it != l.end(); ++it)
+            if (*it == data)
+               return true;
+         return false;
+      }
+      bool erase(int data)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         for (auto it = l.begin(); it != l.end(); ++it)
+            if (*it == data)
+            {
+               l.erase(it);
+               return true;
+            }
+         return false;
+      }
+   };
+
+   // walk the container passes times and add up every element
+   template <class Container>
+   long long sum(Container & c, int passes)
+   {
+      long long total = 0;
+      for (int pass = 0; pass < passes; pass++)
+         for (auto it = c.begin(); it != c.end(); ++it)
+            total += *it;
+      return total;
+   }
+
+   // erase a pseudo-random third of the nodes and append as many new ones
+   template <class Container>
+   void churn(Container & c, int num)
+   {
+      unsigned int seed = 12345;
+      auto it = c.begin();
+      for (int i = 0; i < num; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         if ((seed >> 16) % 3 == 0)
+         {
+            it = c.erase(it);
+            c.push_back(i);
+         }
+         else
+            ++it;
+      }
+   }
+
+   // split numOps of inserts, erases and finds between the threads
+   template <class Container>
+   long long mixed(Container & c, int numThreads, int numOps, int numKeys)
+   {
+      std::atomic<long long> numFound(0);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&, t]()
+         {
+            unsigned int seed = 12345 + t;
+            long long found = 0;
+            for (int i = 0; i < numOps / numThreads; i++)
+            {
+               seed = seed * 1103515245 + 12345;
+               int key = (int)((seed >> 8) % numKeys);
+               switch ((seed >> 4) & 7)
+               {
+                  case 0:  c.push_front(key); break;
+                  case 1:  c.push_back(key);  break;
+                  case 2:
+                  case 3:  c.erase(key);      break;
+                  default: found += c.find(key);
+               }
+            }
+            numFound += found;
+         }));
+      for (auto & thread : threads)
+         thread.join();
+      return numFound.load();
+   }
+
+   // the producer stamps num elements with the time they were pushed
+   // and the consumer notes how long each took to come out, in ns
+   template <class Push, class Pop>
+   std::vector<double> latency(int num, Push push, Pop pop)
+   {
+      auto now = []()
+      {
+         return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      };
+
+      std::vector<double> ns;
+      ns.reserve(num);
+      std::thread consumer([&]()
+      {
+         long long stamp;
+         while ((int)ns.size() < num)
+            if (pop(stamp))
+               ns.push_back((double)(now() - stamp));
+            else
+               std::this_thread::yield();
+      });
+      for (int i = 0; i < num; i++)
+      {
+         push(now());
+         if (i % 64 == 63)
+            std::this_thread::yield();   // let the consumer keep up
+      }
+      consumer.join();
+      return ns;
+   }
+
+   // run the function once, returning the elapsed milliseconds
+   template <class F>
+   double time(F f)
+   {
+      auto start = std::chrono::steady_clock::now();
+      volatile long long result = f();
+      (void)result;
+      auto finish = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::milli>(finish - start).count();
+   }
+
+   void report(const char * name, double ms)
+   {
+      std::cout << "\t" << std::left << std::setw(28) << name
+                << std::right << std::fixed << std::setprecision(2)
+                << std::setw(10) << ms << " ms\n";
+   }
+
+   void reportEach(const char * name, double ms, int num)
+   {
+      std::cout << "\t" << std::left << std::setw(28) << name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(10) << ms * 1000000.0 / num << " ns\n";
+   }
+
+   void reportHits(const char * name, long long hits, int num)
+   {
+      std::cout << "\t" << std::left << std::setw(28) << name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(10) << 100.0 * hits / num << " %\n";
+   }
+
+   void reportLatency(const char * name, std::vector<double> ns)
+   {
+      std::sort(ns.begin(), ns.end());
+      std::cout << "\t" << std::left << std::setw(28) << name
+                << std::right << std::fixed << std::setprecision(0)
+                << "p50 " << std::setw(8) << ns[ns.size() / 2] << " ns"
+                << "   p99 " << std::setw(8) << ns[ns.size() * 99 / 100] << " ns\n";
+   }
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,319 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT LIST
+ * Summary:
+ *    A lock-free singly linked list that any number of threads can
+ *    push onto, search and erase from at the same time.  It follows
+ *    Harris: a node is erased by first marking its pNext link, then
+ *    unlinking it.  Any thread that comes across a marked node helps
+ *    unlink it.  Unlinked nodes are freed through hazard pointers.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_list : A class that represents a lock-free list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstdint>     // for std::uintptr_t
+#include <utility>     // for std::move and std::forward
+#include "hazard.h"    // for hazard_domain and hazard_pointer
+
+class TestConcurrentList;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * CONCURRENT LIST
+ * Every member but the destructor is safe to call
+ * from any number of threads at once.  There is no
+ * iterator: a node may go away the moment we stop
+ * guarding it.
+ **************************************************/
+template <typename T>
+class concurrent_list
+{
+   friend class ::TestConcurrentList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   explicit concurrent_list(hazard_domain & domain = hazard_domain::global()) :
+      pHead(nullptr), numElements(0), domain(domain) {}
+   concurrent_list(const concurrent_list &) = delete;
+   concurrent_list & operator = (const concurrent_list &) = delete;
+  ~concurrent_list();
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  data) { pushFront(new Node(data));            }
+   void push_front(      T && data) { pushFront(new Node(std::move(data))); }
+   void push_back (const T &  data) { pushBack (new Node(data));            }
+   void push_back (      T && data) { pushBack (new Node(std::move(data))); }
+
+   //
+   // Access
+   //
+
+   bool find(const T & data) const;
+   template <class F>
+   void for_each(F f) const;
+
+   //
+   // Remove
+   //
+
+   bool erase(const T & data);
+
+   //
+   // Status
+   //
+
+   size_t size() const { return numElements.load(std::memory_order_relaxed); }
+   bool empty()  const { return size() == 0; }
+
+private:
+   class Node;
+
+   void pushFront(Node * pNew);
+   void pushBack(Node * pNew);
+   template <class Match>
+   bool search(Match match, std::atomic<Node *> * & pLink, Node * & pCurr,
+               hazard_pointer & hpPrev, hazard_pointer & hpCurr) const;
+   static void deleteNode(void * p) { delete static_cast<Node *>(p); }
+
+   // the low bit of a pNext link marks its node as erased
+   static bool   isMarked(Node * p) { return (reinterpret_cast<std::uintptr_t>(p) & 1) != 0; }
+   static Node * marked  (Node * p) { return reinterpret_cast<Node *>(reinterpret_cast<std::uintptr_t>(p) | 1); }
+   static Node * unmarked(Node * p) { return reinterpret_cast<Node *>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(1)); }
+
+   // member variables
+   mutable std::atomic<Node *> pHead;  // searches unlink erased nodes, even in find()
+   std::atomic<size_t> numElements;    // elements not yet erased
+   hazard_domain & domain;             // where unlinked nodes wait to be freed
+};
+
+/*************************************************
+ * NODE
+ * the data and a pNext link that may carry the
+ * erased mark
+ *************************************************/
+template <typename T>
+class concurrent_list <T> :: Node
+{
+public:
+   Node(const T &  data) : data(data),            pNext(nullptr) {}
+   Node(      T && data) : data(std::move(data)), pNext(nullptr) {}
+
+   T data;
+   std::atomic<Node *> pNext;
+};
+
+/*****************************************
+ * CONCURRENT LIST :: DESTRUCTOR
+ * free the nodes still linked, erased or not.
+ * Nodes already unlinked belong to the domain.
+ ****************************************/
+template <typename T>
+concurrent_list <T> :: ~concurrent_list()
+{
+   Node * p = pHead.load(std::memory_order_acquire);
+   while (p)
+   {
+      Node * pDelete = p;
+      p = unmarked(p->pNext.load(std::memory_order_acquire));
+      delete pDelete;
+   }
+}
+
+/*********************************************
+ * CONCURRENT LIST :: SEARCH
+ * walk from the head, unlinking and retiring any
+ * marked node on the way, until match() says yes
+ * or the list ends.  On return hpCurr guards pCurr
+ * and hpPrev guards the node pLink belongs to.
+ *    INPUT  : what we are looking for
+ *    OUTPUT : pLink, the link pointing to pCurr
+ *             pCurr, the match or NULL at the end
+ *             true if there was a match
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+template <class Match>
+bool concurrent_list <T> :: search(Match match, std::atomic<Node *> * & pLink, Node * & pCurr,
+                                   hazard_pointer & hpPrev, hazard_pointer & hpCurr) const
+{
+   while (true)
+   {
+      pLink = &pHead;
+      pCurr = pHead.load(std::memory_order_acquire);
+
+      bool restart = false;
+      while (pCurr && !restart)
+      {
+         // guard pCurr, then make sure it was not unlinked before we did
+         hpCurr.set(pCurr);
+         if (pLink->load(std::memory_order_seq_cst) != pCurr)
+         {
+            restart = true;
+            continue;
+         }
+
+         Node * pNext = pCurr->pNext.load(std::memory_order_acquire);
+         if (isMarked(pNext))
+         {
+            // help the eraser: whoever unlinks the node retires it
+            Node * pExpected = pCurr;
+            if (pLink->compare_exchange_strong(pExpected, unmarked(pNext),
+                                               std::memory_order_acq_rel))
+            {
+               domain.retire(pCurr, deleteNode);
+               pCurr = unmarked(pNext);
+            }
+            else
+               restart = true;
+            continue;
+         }
+
+         if (match(pCurr->data))
+            return true;
+
+         // step forward; hpPrev takes over guarding pCurr
+         pLink = &pCurr->pNext;
+         hpPrev.swap(hpCurr);
+         pCurr = pNext;
+      }
+
+      if (!restart)
+         return false;
+   }
+}
+
+/*********************************************
+ * CONCURRENT LIST :: PUSH FRONT
+ * swing the head over to a new node
+ *    INPUT  : the new node
+ *    OUTPUT :
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+void concurrent_list <T> :: pushFront(Node * pNew)
+{
+   Node * pFirst = pHead.load(std::memory_order_relaxed);
+   do
+      pNew->pNext.store(pFirst, std::memory_order_relaxed);
+   while (!pHead.compare_exchange_weak(pFirst, pNew, std::memory_order_release,
+                                       std::memory_order_relaxed));
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************
+ * CONCURRENT LIST :: PUSH BACK
+ * find the end and hang a new node off it.  If the
+ * last node is erased or grows a successor first,
+ * the CAS fails and we look again.
+ *    INPUT  : the new node
+ *    OUTPUT :
+ *    COST   : O(n), lock-free
+ *********************************************/
+template <typename T>
+void concurrent_list <T> :: pushBack(Node * pNew)
+{
+   hazard_pointer hpPrev(domain);
+   hazard_pointer hpCurr(domain);
+   std::atomic<Node *> * pLink;
+   Node * pCurr;
+   while (true)
+   {
+      search([](const T &) { return false; }, pLink, pCurr, hpPrev, hpCurr);
+      Node * pExpected = nullptr;
+      if (pLink->compare_exchange_strong(pExpected, pNew, std::memory_order_release,
+                                         std::memory_order_relaxed))
+         break;
+   }
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************
+ * CONCURRENT LIST :: FIND
+ * is there an element equal to data?
+ *    INPUT  : the value to look for
+ *    OUTPUT : true if it is in the list
+ *    COST   : O(n), lock-free
+ *********************************************/
+template <typename T>
+bool concurrent_list <T> :: find(const T & data) const
+{
+   hazard_pointer hpPrev(domain);
+   hazard_pointer hpCurr(domain);
+   std::atomic<Node *> * pLink;
+   Node * pCurr;
+   return search([&](const T & value) { return value == data; },
+                 pLink, pCurr, hpPrev, hpCurr);
+}
+
+/*********************************************
+ * CONCURRENT LIST :: FOR EACH
+ * visit every element not yet erased.  When this
+ * races with an erase the walk starts over, so an
+ * element can then be visited more than once.
+ *    INPUT  : the function to call on each element
+ *    OUTPUT :
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+template <class F>
+void concurrent_list <T> :: for_each(F f) const
+{
+   hazard_pointer hpPrev(domain);
+   hazard_pointer hpCurr(domain);
+   std::atomic<Node *> * pLink;
+   Node * pCurr;
+   search([&](const T & value) { f(value); return false; },
+          pLink, pCurr, hpPrev, hpCurr);
+}
+
+/*********************************************
+ * CONCURRENT LIST :: ERASE
+ * erase the first element equal to data.  Marking
+ * the node's pNext is the erase; unlinking it is
+ * cleanup that the next search will do if we can't.
+ *    INPUT  : the value to erase
+ *    OUTPUT : true if we erased it, false if it was not there
+ *    COST   : O(n), lock-free
+ *********************************************/
+template <typename T>
+bool concurrent_list <T> :: erase(const T & data)
+{
+   hazard_pointer hpPrev(domain);
+   hazard_pointer hpCurr(domain);
+   std::atomic<Node *> * pLink;
+   Node * pCurr;
+   while (true)
+   {
+      if (!search([&](const T & value) { return value == data; },
+                  pLink, pCurr, hpPrev, hpCurr))
+         return false;
+
+      // mark it; if another thread beat us to it, look again
+      Node * pNext = pCurr->pNext.load(std::memory_order_acquire);
+      if (isMarked(pNext) ||
+          !pCurr->pNext.compare_exchange_strong(pNext, marked(pNext),
+                                                std::memory_order_acq_rel))
+         continue;
+      numElements.fetch_sub(1, std::memory_order_relaxed);
+
+      // try to unlink it ourselves
+      Node * pExpected = pCurr;
+      if (pLink->compare_exchange_strong(pExpected, pNext, std::memory_order_acq_rel))
+         domain.retire(pCurr, deleteNode);
+      return true;
+   }
+}
+
+}; // namespace custom
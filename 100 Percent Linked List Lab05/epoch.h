@@ -0,0 +1,383 @@
+/***********************************************************************
+ * Header:
+ *    EPOCH
+ * Summary:
+ *    Epoch-based reclamation for read-mostly containers.  Readers mark
+ *    the span in which they may hold pointers into the container by
+ *    entering the current global epoch; it costs them one store and a
+ *    fence, and nothing per node.  Writers retire the nodes they unlink
+ *    into the epoch they unlinked them in.  The epoch only moves on
+ *    once every reader inside has caught up with it, so by the time it
+ *    comes back around to a retire list, no reader can still see what
+ *    is on it.
+ *
+ *    Compared to hazard pointers, readers pay less and writers wait
+ *    longer: one slow reader holds back every reclamation.
+ *
+ *    This will contain the class definition of:
+ *        epoch_domain : The global epoch, the readers, and retired nodes
+ *        epoch_guard  : A read-side critical section
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <algorithm>   // for std::remove_if
+#include <atomic>      // for std::atomic
+#include <mutex>       // for std::mutex
+#include <set>         // for std::set
+#include <thread>      // for std::this_thread::yield
+#include <vector>      // for std::vector
+
+class TestEpoch;       // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * EPOCH DOMAIN
+ * Any number of threads may read at once, and any
+ * number may retire.  A thread may outlive a domain
+ * it read from, but no thread may be using a domain
+ * as it is destroyed.
+ **************************************************/
+class epoch_domain
+{
+   friend class ::TestEpoch;
+   friend class epoch_guard;
+public:
+   enum { EPOCHS = 3 };     // retire lists: the current epoch and the two before
+   enum { THRESHOLD = 64 }; // retired nodes before a retire tries to advance
+
+   epoch_domain();
+   epoch_domain(const epoch_domain &) = delete;
+   epoch_domain & operator = (const epoch_domain &) = delete;
+  ~epoch_domain();
+
+   // the domain shared by everything that does not ask for its own
+   static epoch_domain & global()
+   {
+      static epoch_domain domain;
+      return domain;
+   }
+
+   // hand a node over to be freed once every reader has moved on
+   void retire(void * p, void (*deleter)(void *));
+
+   // wait for every reader now inside to leave, then free everything
+   // retired so far.  Must not be called from inside an epoch_guard.
+   void synchronize();
+
+private:
+   // a node waiting to be freed
+   struct Retired
+   {
+      void * p;
+      void (*deleter)(void *);
+   };
+
+   // one reading thread.  local is 0 outside a critical section,
+   // and the epoch it entered shifted up one with the low bit set
+   // inside.
+   struct Record
+   {
+      std::atomic<unsigned long> local;
+      std::atomic<bool> active;   // owned by some thread
+      unsigned int nesting;       // only touched by the owning thread
+      Record * pNext;
+   };
+
+   // the domains still alive.  A thread exiting after one of its
+   // domains is gone must not touch that domain's record.
+   struct Registry
+   {
+      std::mutex lock;
+      std::set<const epoch_domain *> live;
+      unsigned long long nextId = 0;
+   };
+   static Registry & registry()
+   {
+      static Registry r;
+      return r;
+   }
+
+   // the records this thread holds, one per domain it has read from
+   struct Owner
+   {
+      struct Entry
+      {
+         epoch_domain * pDomain;
+         unsigned long long id;   // in case another domain reuses the address
+         Record * pRecord;
+      };
+
+      Owner() { current() = this; }
+     ~Owner()
+      {
+         std::lock_guard<std::mutex> guard(registry().lock);
+         for (const Entry & entry : records)
+            if (registry().live.count(entry.pDomain) && entry.pDomain->id == entry.id)
+               entry.pRecord->active.store(false, std::memory_order_release);
+         current() = nullptr;
+      }
+      std::vector<Entry> records;
+   };
+   static Owner & owner()
+   {
+      static thread_local Owner o;
+      return o;
+   }
+
+   // this thread's owner, or NULL once it has been destroyed at exit
+   static Owner * & current()
+   {
+      static thread_local Owner * p = nullptr;
+      return p;
+   }
+
+   Record * record();
+   void enter(Record * pRecord);
+   void leave(Record * pRecord);
+   bool tryAdvance();
+   void freeAll(std::vector<Retired> & retired);
+
+   std::atomic<unsigned long> epoch;       // the global epoch
+   std::atomic<Record *> pRecords;         // every reader ever, never shrinks
+   std::mutex lock;                        // guards the retire lists
+   std::vector<Retired> retired[EPOCHS];   // retired[e % EPOCHS] holds epoch e's
+   unsigned long long id;                  // unique over the life of the program
+};
+
+/**************************************************
+ * EPOCH GUARD
+ * While one exists, nothing retired into the domain
+ * after it was made is freed.  Guards nest.  Used
+ * only by the thread that created it.
+ **************************************************/
+class epoch_guard
+{
+public:
+   explicit epoch_guard(epoch_domain & domain = epoch_domain::global()) :
+      domain(domain), pRecord(domain.record())
+   {
+      domain.enter(pRecord);
+   }
+   epoch_guard(const epoch_guard &) = delete;
+   epoch_guard & operator = (const epoch_guard &) = delete;
+  ~epoch_guard()
+   {
+      domain.leave(pRecord);
+   }
+
+private:
+   epoch_domain & domain;
+   epoch_domain::Record * pRecord;
+};
+
+/*********************************************
+ * EPOCH DOMAIN :: CONSTRUCTOR
+ *********************************************/
+inline epoch_domain :: epoch_domain() : epoch(0), pRecords(nullptr)
+{
+   std::lock_guard<std::mutex> guard(registry().lock);
+   registry().live.insert(this);
+   id = registry().nextId++;
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: DESTRUCTOR
+ * free every retired node and every record.  No
+ * thread may be using the domain any more.
+ *********************************************/
+inline epoch_domain :: ~epoch_domain()
+{
+   // from here on, exiting threads leave our records alone
+   {
+      std::lock_guard<std::mutex> guard(registry().lock);
+      registry().live.erase(this);
+   }
+
+   // the calling thread forgets its record now
+   if (Owner * pOwner = current())
+      for (auto it = pOwner->records.begin(); it != pOwner->records.end(); ++it)
+         if (it->id == id)
+         {
+            pOwner->records.erase(it);
+            break;
+         }
+
+   for (auto & list : retired)
+      freeAll(list);
+
+   Record * pRecord = pRecords.load(std::memory_order_acquire);
+   while (pRecord)
+   {
+      Record * pDelete = pRecord;
+      pRecord = pRecord->pNext;
+      delete pDelete;
+   }
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: RETIRE
+ * put an unlinked node on the current epoch's
+ * list.  Once enough have built up, try to move
+ * the epoch on, which frees the oldest list.
+ *    INPUT  : the node and how to free it
+ *    OUTPUT :
+ *    COST   : O(1) amortized, plus O(T) for T readers
+ *             every THRESHOLD retires
+ *********************************************/
+inline void epoch_domain :: retire(void * p, void (*deleter)(void *))
+{
+   std::lock_guard<std::mutex> guard(lock);
+   unsigned long e = epoch.load(std::memory_order_relaxed);
+   std::vector<Retired> & list = retired[e % EPOCHS];
+   list.push_back(Retired{ p, deleter });
+   if (list.size() >= THRESHOLD)
+      tryAdvance();
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: SYNCHRONIZE
+ * advance the epoch once for every retire list,
+ * waiting on slow readers, so every list is freed
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : as long as the slowest reader
+ *********************************************/
+inline void epoch_domain :: synchronize()
+{
+   std::lock_guard<std::mutex> guard(lock);
+   for (int i = 0; i < EPOCHS; i++)
+      while (!tryAdvance())
+         std::this_thread::yield();
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: TRY ADVANCE
+ * move the epoch from e to e + 1 if every reader
+ * inside has seen e.  No reader can then be in e - 1
+ * or before, so what was retired in e - 2, whose
+ * list e + 1 now reuses, is freed.  Called with the
+ * lock held.
+ *    INPUT  :
+ *    OUTPUT : whether the epoch moved
+ *    COST   : O(T) for T readers
+ *********************************************/
+inline bool epoch_domain :: tryAdvance()
+{
+   unsigned long e = epoch.load(std::memory_order_relaxed);
+
+   // the unlinks that retired these nodes happen before we look
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   for (Record * p = pRecords.load(std::memory_order_acquire); p; p = p->pNext)
+   {
+      unsigned long local = p->local.load(std::memory_order_acquire);
+      if ((local & 1) && (local >> 1) != e)
+         return false;
+   }
+
+   epoch.store(e + 1, std::memory_order_release);
+   freeAll(retired[(e + 1) % EPOCHS]);
+   return true;
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: FREE ALL
+ *********************************************/
+inline void epoch_domain :: freeAll(std::vector<Retired> & list)
+{
+   for (const Retired & r : list)
+      r.deleter(r.p);
+   list.clear();
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: RECORD
+ * the calling thread's record, taking one some
+ * exited thread gave up, or making a new one, the
+ * first time this thread reads from the domain.  As
+ * a new domain may be built where a destroyed one
+ * was, entries are matched by id, and those of
+ * domains that are gone are dropped on a miss.
+ *********************************************/
+inline epoch_domain::Record * epoch_domain :: record()
+{
+   auto & records = owner().records;
+   for (auto & entry : records)
+      if (entry.id == id)
+         return entry.pRecord;
+
+   {
+      std::lock_guard<std::mutex> guard(registry().lock);
+      records.erase(std::remove_if(records.begin(), records.end(),
+                                   [](const Owner::Entry & entry)
+                                   {
+                                      return !registry().live.count(entry.pDomain) ||
+                                             entry.pDomain->id != entry.id;
+                                   }),
+                    records.end());
+   }
+
+   Record * pRecord = nullptr;
+   for (Record * p = pRecords.load(std::memory_order_acquire); p && !pRecord; p = p->pNext)
+   {
+      bool expected = false;
+      if (!p->active.load(std::memory_order_relaxed) &&
+          p->active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+         pRecord = p;
+   }
+
+   if (!pRecord)
+   {
+      pRecord = new Record;
+      pRecord->local.store(0, std::memory_order_relaxed);
+      pRecord->active.store(true, std::memory_order_relaxed);
+      pRecord->nesting = 0;
+
+      Record * pHead = pRecords.load(std::memory_order_relaxed);
+      do
+         pRecord->pNext = pHead;
+      while (!pRecords.compare_exchange_weak(pHead, pRecord, std::memory_order_release,
+                                             std::memory_order_relaxed));
+   }
+
+   records.push_back(Owner::Entry{ this, id, pRecord });
+   return pRecord;
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: ENTER
+ * publish the epoch we are reading in.  If the
+ * epoch moved before the store could be seen, a
+ * writer may not have waited for us, so go again.
+ *********************************************/
+inline void epoch_domain :: enter(Record * pRecord)
+{
+   if (pRecord->nesting++)
+      return;
+
+   unsigned long e = epoch.load(std::memory_order_relaxed);
+   while (true)
+   {
+      pRecord->local.store((e << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      unsigned long eAgain = epoch.load(std::memory_order_relaxed);
+      if (eAgain == e)
+         return;
+      e = eAgain;
+   }
+}
+
+/*********************************************
+ * EPOCH DOMAIN :: LEAVE
+ * everything we read is done with
+ *********************************************/
+inline void epoch_domain :: leave(Record * pRecord)
+{
+   if (--pRecord->nesting == 0)
+      pRecord->local.store(0, std::memory_order_release);
+}
+
+}; // namespace custom
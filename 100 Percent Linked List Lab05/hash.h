@@ -0,0 +1,493 @@
+/***********************************************************************
+ * Header:
+ *    HASH
+ * Summary:
+ *    Chained hash tables whose buckets are custom::lists.  Every bucket
+ *    draws its nodes from one shared pool, so when the table grows,
+ *    rehashing splices each node into its new bucket: nothing is
+ *    copied, allocated or freed, and a reference to an element stays
+ *    good across a rehash.
+ *
+ *    A table is for one thread at a time.  Its shared pool lives on the
+ *    heap, so inserting and erasing take that pool's lock.  Only the
+ *    table's own buckets draw from it, so no other thread is ever
+ *    waiting on it.
+ *
+ *    This will contain the class definition of:
+ *        hash_table              : The buckets, shared by the two below
+ *        hash_table::iterator    : An iterator through every bucket
+ *        unordered_set           : A set of unique keys
+ *        unordered_map           : A map from unique keys to values
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cmath>       // for std::ceil
+#include <cstddef>     // for size_t
+#include <functional>  // for std::hash and std::equal_to
+#include <initializer_list> // for std::initializer_list
+#include <utility>     // for std::pair
+#include <vector>      // for std::vector
+#include "list.h"      // for the buckets
+
+class TestHash;        // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * HASH TABLE
+ * Holds Values, each with a Key that KeyOf pulls out
+ * of it; no two have equal Keys.  The table grows
+ * whenever an insert would take the load factor past
+ * max_load_factor().
+ *
+ * Inserting never invalidates an element's address,
+ * though a rehash does invalidate iterators.
+ **************************************************/
+template <typename Value, typename Key, typename KeyOf,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class hash_table
+{
+   friend class ::TestHash; // give unit tests access to the privates
+public:
+   typedef list<Value> bucket_type;
+   typedef typename bucket_type::iterator local_iterator;
+   enum { MIN_BUCKETS = 8 };
+
+   //
+   // Construct
+   //
+
+   hash_table() : buckets(MIN_BUCKETS), numElements(0), maxLoad(1.0f)
+   {
+      sharePool();
+   }
+   hash_table(hash_table & rhs);
+   hash_table & operator = (const hash_table &) = delete;
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin();
+   iterator end() { return iterator(buckets.data() + buckets.size(), buckets.data() + buckets.size(),
+                                    local_iterator()); }
+
+   //
+   // Access
+   //
+
+   iterator find(const Key & key);
+   size_t count(const Key & key) { return find(key) != end() ? 1 : 0; }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const Value & value);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it);
+   size_t erase(const Key & key);
+   void clear();
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+   //
+   // Buckets
+   //
+
+   size_t bucket_count() const         { return buckets.size();              }
+   size_t bucket_size(size_t i) const  { return buckets[i].size();           }
+   size_t bucket(const Key & key) const { return Hash()(key) % buckets.size(); }
+   local_iterator begin(size_t i)      { return buckets[i].begin();          }
+   local_iterator end(size_t i)        { return buckets[i].end();            }
+
+   //
+   // Hash policy
+   //
+
+   float load_factor() const     { return (float)numElements / (float)buckets.size(); }
+   float max_load_factor() const { return maxLoad; }
+   void max_load_factor(float f);
+   void rehash(size_t numBuckets);
+   void reserve(size_t num);
+
+private:
+   local_iterator findIn(bucket_type & b, const Key & key);
+   void sharePool();
+
+   // member variables
+   bucket_type spare;                 // holds the pool every bucket shares
+   std::vector<bucket_type> buckets;  // the chains
+   size_t numElements;
+   float maxLoad;
+};
+
+/*************************************************
+ * HASH TABLE ITERATOR
+ * A bucket and a place in its list.  Moving past
+ * the end of one bucket skips ahead to the next
+ * one that is not empty.
+ *************************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+class hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: iterator
+{
+   friend class ::TestHash; // give unit tests access to the privates
+   friend class hash_table;
+public:
+   // constructors, destructors, and assignment operator
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr) {}
+   iterator(bucket_type * pBucket, bucket_type * pBucketEnd, local_iterator it) :
+      pBucket(pBucket), pBucketEnd(pBucketEnd), it(it) {}
+   iterator(const iterator & rhs) : pBucket(rhs.pBucket), pBucketEnd(rhs.pBucketEnd), it(rhs.it) {}
+   iterator & operator = (const iterator & rhs)
+   {
+      pBucket = rhs.pBucket;
+      pBucketEnd = rhs.pBucketEnd;
+      it = rhs.it;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return pBucket == rhs.pBucket && it == rhs.it; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs);                        }
+
+   // dereference operator, fetch an element
+   Value & operator *  () { return *it;  }
+   Value * operator -> () { return &*it; }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      if (++it == pBucket->end())
+         skipEmpty(pBucket + 1);
+      return *this;
+   }
+
+   // postfix increment
+   iterator operator ++ (int postfix)
+   {
+      iterator itOld = *this;
+      ++(*this);
+      return itOld;
+   }
+
+private:
+   // land on the first element of the first non-empty
+   // bucket at or after p, or on the end
+   void skipEmpty(bucket_type * p)
+   {
+      while (p != pBucketEnd && p->empty())
+         p++;
+      pBucket = p;
+      it = p != pBucketEnd ? p->begin() : local_iterator();
+   }
+
+   bucket_type * pBucket;     // the bucket we are in
+   bucket_type * pBucketEnd;  // one past the last bucket
+   local_iterator it;         // the element in that bucket
+};
+
+/*****************************************
+ * HASH TABLE :: COPY CONSTRUCTOR
+ * the same bucket count, and every element
+ * copied into its bucket in the same order
+ ****************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: hash_table(hash_table & rhs) :
+   buckets(rhs.buckets.size()), numElements(rhs.numElements), maxLoad(rhs.maxLoad)
+{
+   sharePool();
+   spare.reserve(numElements);
+   for (size_t i = 0; i < buckets.size(); i++)
+      for (local_iterator it = rhs.buckets[i].begin(); it != rhs.buckets[i].end(); ++it)
+         buckets[i].push_back(*it);
+}
+
+/*********************************************
+ * HASH TABLE :: BEGIN
+ *    INPUT  :
+ *    OUTPUT : an iterator on the first element
+ *    COST   : O(buckets)
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+typename hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: iterator
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: begin()
+{
+   iterator it(nullptr, buckets.data() + buckets.size(), local_iterator());
+   it.skipEmpty(buckets.data());
+   return it;
+}
+
+/*********************************************
+ * HASH TABLE :: FIND
+ * walk the one bucket the key can be in
+ *    INPUT  : the key to look for
+ *    OUTPUT : an iterator on the element, or end()
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+typename hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: iterator
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: find(const Key & key)
+{
+   bucket_type & b = buckets[bucket(key)];
+   local_iterator it = findIn(b, key);
+   if (it == b.end())
+      return end();
+   return iterator(&b, buckets.data() + buckets.size(), it);
+}
+
+/*********************************************
+ * HASH TABLE :: INSERT
+ * add the value unless its key is already here,
+ * growing the table first if it is too full
+ *    INPUT  : the value to add
+ *    OUTPUT : an iterator on the element with that key,
+ *             and whether it is the one just added
+ *    COST   : O(1) expected, O(n) when it grows
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+std::pair<typename hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: iterator, bool>
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: insert(const Value & value)
+{
+   const Key & key = KeyOf()(value);
+   iterator it = find(key);
+   if (it != end())
+      return std::make_pair(it, false);
+
+   // grow the pool along with the buckets, so the nodes come from a
+   // few big slabs rather than many small ones
+   if ((float)(numElements + 1) > maxLoad * (float)buckets.size())
+   {
+      rehash(buckets.size() * 2);
+      spare.reserve(numElements);
+   }
+
+   bucket_type & b = buckets[bucket(key)];
+   b.push_front(value);
+   numElements++;
+   return std::make_pair(iterator(&b, buckets.data() + buckets.size(), b.begin()), true);
+}
+
+/*********************************************
+ * HASH TABLE :: ERASE
+ *    INPUT  : an iterator on the element to remove
+ *    OUTPUT : an iterator on the element after it
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+typename hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: iterator
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: erase(iterator it)
+{
+   if (it == end())
+      return it;
+
+   iterator itNext(it.pBucket, it.pBucketEnd, it.pBucket->erase(it.it));
+   if (itNext.it == it.pBucket->end())
+      itNext.skipEmpty(it.pBucket + 1);
+   numElements--;
+   return itNext;
+}
+
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+size_t hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: erase(const Key & key)
+{
+   bucket_type & b = buckets[bucket(key)];
+   local_iterator it = findIn(b, key);
+   if (it == b.end())
+      return 0;
+   b.erase(it);
+   numElements--;
+   return 1;
+}
+
+/*********************************************
+ * HASH TABLE :: CLEAR
+ * empty every bucket, keeping the bucket count
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+void hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: clear()
+{
+   for (bucket_type & b : buckets)
+      b.clear();
+   numElements = 0;
+}
+
+/*********************************************
+ * HASH TABLE :: MAX LOAD FACTOR
+ * change how full the table may get, growing it
+ * now if it is already fuller than that
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+void hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: max_load_factor(float f)
+{
+   if (f <= 0.0f)
+      throw("ERROR: the max load factor must be positive");
+   maxLoad = f;
+   rehash(0);
+}
+
+/*********************************************
+ * HASH TABLE :: REHASH
+ * move to at least numBuckets buckets, and at least
+ * enough to keep under the max load factor.  Each
+ * node is spliced from its old bucket into its new
+ * one; the elements themselves never move.
+ *    INPUT  : the fewest buckets wanted
+ *    OUTPUT :
+ *    COST   : O(n + buckets)
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+void hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: rehash(size_t numBuckets)
+{
+   size_t numNeeded = (size_t)std::ceil((float)numElements / maxLoad);
+   if (numBuckets < numNeeded)
+      numBuckets = numNeeded;
+   if (numBuckets < MIN_BUCKETS)
+      numBuckets = MIN_BUCKETS;
+   if (numBuckets == buckets.size())
+      return;
+
+   std::vector<bucket_type> old(numBuckets);
+   old.swap(buckets);
+   sharePool();
+
+   for (bucket_type & b : old)
+      while (!b.empty())
+      {
+         local_iterator it = b.begin();
+         local_iterator itNext = it;
+         ++itNext;
+         bucket_type & to = buckets[bucket(KeyOf()(*it))];
+         to.splice(to.begin(), b, it, itNext);
+      }
+}
+
+/*********************************************
+ * HASH TABLE :: RESERVE
+ * make room for num elements: enough buckets to
+ * hold them under the max load factor, and enough
+ * nodes in the pool that inserting them allocates
+ * nothing
+ *    INPUT  : the number of elements
+ *    OUTPUT :
+ *    COST   : O(n + buckets)
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+void hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: reserve(size_t num)
+{
+   rehash((size_t)std::ceil((float)num / maxLoad));
+   if (num > numElements)
+      spare.reserve(num - numElements);
+}
+
+/*********************************************
+ * HASH TABLE :: FIND IN
+ * the element with the key in one bucket
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+typename hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: local_iterator
+hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: findIn(bucket_type & b, const Key & key)
+{
+   local_iterator it = b.begin();
+   while (it != b.end() && !KeyEqual()(KeyOf()(*it), key))
+      ++it;
+   return it;
+}
+
+/*********************************************
+ * HASH TABLE :: SHARE POOL
+ * point every bucket at the spare list's pool, so
+ * nodes can be spliced between buckets and a bucket
+ * holding one element does not carve a slab of its
+ * own
+ *********************************************/
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+void hash_table <Value, Key, KeyOf, Hash, KeyEqual> :: sharePool()
+{
+   for (bucket_type & b : buckets)
+      spare.share_pool(b);
+}
+
+/*********************************************
+ * the keys of the two kinds of table
+ *********************************************/
+template <typename K>
+struct hash_identity
+{
+   const K & operator () (const K & k) const { return k; }
+};
+
+template <typename K, typename V>
+struct hash_first
+{
+   const K & operator () (const std::pair<const K, V> & p) const { return p.first; }
+};
+
+/**************************************************
+ * UNORDERED SET
+ * A hash table of keys
+ **************************************************/
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class unordered_set : public hash_table<T, T, hash_identity<T>, Hash, KeyEqual>
+{
+public:
+   unordered_set() {}
+   unordered_set(const std::initializer_list<T> & il)
+   {
+      this->reserve(il.size());
+      for (const T & t : il)
+         this->insert(t);
+   }
+};
+
+/**************************************************
+ * UNORDERED MAP
+ * A hash table of key-value pairs
+ **************************************************/
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class unordered_map : public hash_table<std::pair<const K, V>, K, hash_first<K, V>, Hash, KeyEqual>
+{
+public:
+   typedef std::pair<const K, V> value_type;
+
+   unordered_map() {}
+   unordered_map(const std::initializer_list<value_type> & il)
+   {
+      this->reserve(il.size());
+      for (const value_type & pair : il)
+         this->insert(pair);
+   }
+
+   // the value for the key, adding a default one if it is not there
+   V & operator [] (const K & key)
+   {
+      auto it = this->find(key);
+      if (it == this->end())
+         it = this->insert(value_type(key, V())).first;
+      return it->second;
+   }
+
+   // the value for a key that must be there
+   V & at(const K & key)
+   {
+      auto it = this->find(key);
+      if (it == this->end())
+         throw("ERROR: key not found");
+      return it->second;
+   }
+};
+
+}; // namespace custom
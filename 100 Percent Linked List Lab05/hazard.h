@@ -0,0 +1,412 @@
+/***********************************************************************
+ * Header:
+ *    HAZARD
+ * Summary:
+ *    Hazard pointers: safe memory reclamation for lock-free containers.
+ *    A thread about to read a node publishes its address in a hazard
+ *    slot.  A thread that unlinks a node retires it rather than deleting
+ *    it, and retired nodes are only freed once no slot points at them.
+ *    concurrent_list and mpmc_list_queue retire into a domain, and so
+ *    does list once it is given one with retire_into().
+ *
+ *    This will contain the class definition of:
+ *        hazard_domain  : The slots and retired nodes of a set of threads
+ *        hazard_pointer : One slot, held for the life of the object
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <algorithm>   // for std::sort, std::binary_search and std::remove_if
+#include <atomic>      // for std::atomic
+#include <cassert>     // for ASSERT
+#include <mutex>       // for std::mutex
+#include <set>         // for std::set
+#include <utility>     // for std::swap
+#include <vector>      // for std::vector
+
+class TestHazard;      // forward declaration for unit tests
+
+namespace custom
+{
+
+class hazard_pointer;
+
+/**************************************************
+ * HAZARD DOMAIN
+ * Every thread that uses the domain gets a record
+ * of SLOTS hazard pointers and its own retire list.
+ * A thread may outlive a domain it used, but no
+ * thread may be using a domain as it is destroyed.
+ **************************************************/
+class hazard_domain
+{
+   friend class ::TestHazard;
+   friend class hazard_pointer;
+public:
+   enum { SLOTS = 4 };  // hazard pointers each thread can hold at once
+
+   hazard_domain();
+   hazard_domain(const hazard_domain &) = delete;
+   hazard_domain & operator = (const hazard_domain &) = delete;
+  ~hazard_domain();
+
+   // the domain shared by everything that does not ask for its own
+   static hazard_domain & global()
+   {
+      static hazard_domain domain;
+      return domain;
+   }
+
+   // hand a node over to be freed once no hazard pointer guards it
+   void retire(void * p, void (*deleter)(void *));
+   void retire(void * p, void (*reclaim)(void *, void *), void * context);
+
+   // free whatever this thread has retired that is no longer guarded
+   void scan();
+
+private:
+   // a node waiting to be freed, either by deleter(p) or
+   // by reclaim(p, context) for owners that recycle nodes
+   struct Retired
+   {
+      void * p;
+      void (*deleter)(void *);
+      void (*reclaim)(void *, void *);
+      void * context;
+   };
+
+   // one thread's hazard pointers and the nodes it has retired
+   struct Record
+   {
+      std::atomic<const void *> slots[SLOTS];
+      std::atomic<bool> active;
+      Record * pNext;
+      unsigned int used;                  // which slots are handed out
+      std::vector<Retired> retired;       // only touched by the owning thread
+      std::vector<const void *> hazards;  // scratch space for scan()
+   };
+
+   // the domains still alive.  A thread exiting after one of its
+   // domains is gone must not touch that domain's record.
+   struct Registry
+   {
+      std::mutex lock;
+      std::set<const hazard_domain *> live;
+      unsigned long long nextId = 0;
+   };
+   static Registry & registry()
+   {
+      static Registry r;
+      return r;
+   }
+
+   // the records this thread holds, one per domain it has used
+   struct Owner
+   {
+      struct Entry
+      {
+         hazard_domain * pDomain;
+         unsigned long long id;   // in case another domain reuses the address
+         Record * pRecord;
+      };
+
+      Owner() { current() = this; }
+     ~Owner()
+      {
+         std::lock_guard<std::mutex> guard(registry().lock);
+         for (const Entry & entry : records)
+            if (registry().live.count(entry.pDomain) && entry.pDomain->id == entry.id)
+               entry.pDomain->release(entry.pRecord);
+         current() = nullptr;
+      }
+      std::vector<Entry> records;
+   };
+   static Owner & owner()
+   {
+      static thread_local Owner o;
+      return o;
+   }
+
+   // this thread's owner, or NULL once it has been destroyed at exit
+   static Owner * & current()
+   {
+      static thread_local Owner * p = nullptr;
+      return p;
+   }
+
+   Record * record();
+   Record * acquire();
+   void release(Record * pRecord);
+   void scan(Record * pRecord);
+
+   std::atomic<Record *> pRecords;  // every record ever made, never shrinks
+   std::atomic<size_t> numRecords;
+   unsigned long long id;           // unique over the life of the program
+};
+
+/**************************************************
+ * HAZARD POINTER
+ * One slot of the calling thread's record.  While a
+ * node's address is in the slot it will not be freed.
+ * Used only by the thread that created it.
+ **************************************************/
+class hazard_pointer
+{
+   friend class ::TestHazard;
+public:
+   explicit hazard_pointer(hazard_domain & domain = hazard_domain::global());
+   hazard_pointer(const hazard_pointer &) = delete;
+   hazard_pointer & operator = (const hazard_pointer &) = delete;
+  ~hazard_pointer()
+   {
+      clear();
+      pRecord->used &= ~(1u << slot);
+   }
+
+   // guard p.  The caller must then check p is still reachable.
+   void set(const void * p)
+   {
+      pRecord->slots[slot].store(p, std::memory_order_seq_cst);
+   }
+
+   void clear()
+   {
+      pRecord->slots[slot].store(nullptr, std::memory_order_release);
+   }
+
+   // guard whatever src points to, re-reading until the two agree
+   template <class P>
+   P * protect(const std::atomic<P *> & src)
+   {
+      P * p = src.load(std::memory_order_relaxed);
+      while (true)
+      {
+         set(p);
+         P * pAgain = src.load(std::memory_order_seq_cst);
+         if (pAgain == p)
+            return p;
+         p = pAgain;
+      }
+   }
+
+   // trade slots, so what one guarded the other now guards
+   void swap(hazard_pointer & rhs)
+   {
+      assert(pRecord == rhs.pRecord);
+      std::swap(slot, rhs.slot);
+   }
+
+private:
+   hazard_domain::Record * pRecord;
+   unsigned int slot;
+};
+
+/*********************************************
+ * HAZARD DOMAIN :: CONSTRUCTOR
+ *********************************************/
+inline hazard_domain :: hazard_domain() : pRecords(nullptr), numRecords(0)
+{
+   std::lock_guard<std::mutex> guard(registry().lock);
+   registry().live.insert(this);
+   id = registry().nextId++;
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: DESTRUCTOR
+ * free every retired node and every record.  No
+ * thread may be using the domain any more.
+ *********************************************/
+inline hazard_domain :: ~hazard_domain()
+{
+   // from here on, exiting threads leave our records alone
+   {
+      std::lock_guard<std::mutex> guard(registry().lock);
+      registry().live.erase(this);
+   }
+
+   // the calling thread forgets its record now
+   if (Owner * pOwner = current())
+      for (auto it = pOwner->records.begin(); it != pOwner->records.end(); ++it)
+         if (it->id == id)
+         {
+            pOwner->records.erase(it);
+            break;
+         }
+
+   Record * pRecord = pRecords.load(std::memory_order_acquire);
+   while (pRecord)
+   {
+      for (const Retired & r : pRecord->retired)
+         if (r.deleter)
+            r.deleter(r.p);
+         else
+            r.reclaim(r.p, r.context);
+      Record * pDelete = pRecord;
+      pRecord = pRecord->pNext;
+      delete pDelete;
+   }
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: RETIRE
+ * put an unlinked node on this thread's retire
+ * list.  Once the list is about twice as long as
+ * there are hazard pointers, scan it: at least half
+ * is then freed, so each node costs O(1) amortized.
+ *    INPUT  : the node and how to free it
+ *    OUTPUT :
+ *    COST   : O(1) amortized
+ *********************************************/
+inline void hazard_domain :: retire(void * p, void (*deleter)(void *))
+{
+   Record * pRecord = record();
+   pRecord->retired.push_back(Retired{ p, deleter, nullptr, nullptr });
+   if (pRecord->retired.size() >= 2 * SLOTS * numRecords.load(std::memory_order_relaxed) + 16)
+      scan(pRecord);
+}
+
+inline void hazard_domain :: retire(void * p, void (*reclaim)(void *, void *), void * context)
+{
+   Record * pRecord = record();
+   pRecord->retired.push_back(Retired{ p, nullptr, reclaim, context });
+   if (pRecord->retired.size() >= 2 * SLOTS * numRecords.load(std::memory_order_relaxed) + 16)
+      scan(pRecord);
+}
+
+inline void hazard_domain :: scan()
+{
+   scan(record());
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: SCAN
+ * collect every published hazard pointer, then free
+ * each retired node that is not among them.  The
+ * scratch space is kept, so once warmed up a scan
+ * does not allocate.  A deleter must not retire.
+ *    INPUT  : the record whose retire list to scan
+ *    OUTPUT :
+ *    COST   : O(R log H) for R retired and H hazards
+ *********************************************/
+inline void hazard_domain :: scan(Record * pRecord)
+{
+   // the unlinks that retired these nodes happen before we look
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   std::vector<const void *> & hazards = pRecord->hazards;
+   hazards.clear();
+   for (Record * p = pRecords.load(std::memory_order_acquire); p; p = p->pNext)
+      for (auto & s : p->slots)
+         if (const void * pHazard = s.load(std::memory_order_acquire))
+            hazards.push_back(pHazard);
+   std::sort(hazards.begin(), hazards.end());
+
+   // free what is not guarded, sliding what is down to the front
+   std::vector<Retired> & retired = pRecord->retired;
+   size_t numKept = 0;
+   for (size_t i = 0; i < retired.size(); i++)
+   {
+      const Retired r = retired[i];
+      if (std::binary_search(hazards.begin(), hazards.end(), (const void *)r.p))
+         retired[numKept++] = r;
+      else if (r.deleter)
+         r.deleter(r.p);
+      else
+         r.reclaim(r.p, r.context);
+   }
+   retired.resize(numKept);
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: RECORD
+ * the calling thread's record, acquiring one the
+ * first time this thread uses the domain.  A domain
+ * destroyed on another thread leaves its entry
+ * behind, and a new one may be built at the same
+ * address, so entries are matched by id.  Before
+ * adding one, drop those of domains that are gone.
+ *********************************************/
+inline hazard_domain::Record * hazard_domain :: record()
+{
+   auto & records = owner().records;
+   for (auto & entry : records)
+      if (entry.id == id)
+         return entry.pRecord;
+
+   {
+      std::lock_guard<std::mutex> guard(registry().lock);
+      records.erase(std::remove_if(records.begin(), records.end(),
+                                   [](const Owner::Entry & entry)
+                                   {
+                                      return !registry().live.count(entry.pDomain) ||
+                                             entry.pDomain->id != entry.id;
+                                   }),
+                    records.end());
+   }
+
+   Record * pRecord = acquire();
+   records.push_back(Owner::Entry{ this, id, pRecord });
+   return pRecord;
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: ACQUIRE
+ * reuse a record some exited thread gave up, or
+ * add a new one.  A reused record comes with the
+ * retire list its last owner could not free.
+ *********************************************/
+inline hazard_domain::Record * hazard_domain :: acquire()
+{
+   for (Record * p = pRecords.load(std::memory_order_acquire); p; p = p->pNext)
+   {
+      bool expected = false;
+      if (!p->active.load(std::memory_order_relaxed) &&
+          p->active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+         return p;
+   }
+
+   Record * pRecord = new Record;
+   for (auto & s : pRecord->slots)
+      s.store(nullptr, std::memory_order_relaxed);
+   pRecord->active.store(true, std::memory_order_relaxed);
+   pRecord->used = 0;
+
+   Record * pHead = pRecords.load(std::memory_order_relaxed);
+   do
+      pRecord->pNext = pHead;
+   while (!pRecords.compare_exchange_weak(pHead, pRecord, std::memory_order_release,
+                                          std::memory_order_relaxed));
+   numRecords.fetch_add(1, std::memory_order_relaxed);
+   return pRecord;
+}
+
+/*********************************************
+ * HAZARD DOMAIN :: RELEASE
+ * a thread is done with its record: free what it
+ * can and leave the rest for the next owner
+ *********************************************/
+inline void hazard_domain :: release(Record * pRecord)
+{
+   for (auto & s : pRecord->slots)
+      s.store(nullptr, std::memory_order_release);
+   pRecord->used = 0;
+   scan(pRecord);
+   pRecord->active.store(false, std::memory_order_release);
+}
+
+/*********************************************
+ * HAZARD POINTER :: CONSTRUCTOR
+ * claim a free slot in this thread's record
+ *********************************************/
+inline hazard_pointer :: hazard_pointer(hazard_domain & domain) :
+   pRecord(domain.record()), slot(0)
+{
+   while (slot < hazard_domain::SLOTS && (pRecord->used & (1u << slot)))
+      slot++;
+   if (slot == hazard_domain::SLOTS)
+      throw "ERROR: no free hazard pointers on this thread";
+   pRecord->used |= 1u << slot;
+}
+
+}; // namespace custom
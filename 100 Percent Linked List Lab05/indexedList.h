@@ -0,0 +1,549 @@
+/***********************************************************************
+ * Header:
+ *    INDEXED LIST
+ * Summary:
+ *    A sorted doubly linked list with a skip-list index above it.  The
+ *    base chain is an ordinary doubly linked list that iterators walk
+ *    one node at a time.  About one node in four also has a link on
+ *    the level above, one in sixteen on the level above that, and so
+ *    on.  Each link records how many base nodes it jumps over.  A
+ *    search by value or by position then starts on the top level and
+ *    drops a level whenever the next jump would overshoot, which is
+ *    O(log n) steps instead of a walk along the base chain.
+ *
+ *    Every level is doubly linked as well, so an iterator can find its
+ *    own place in the index by climbing up from its node.  Insert and
+ *    erase at an iterator never search from the front.
+ *
+ *    This will contain the class definition of:
+ *        indexed_list           : A class that represents an indexed list
+ *        indexed_list::iterator : An iterator through the base chain
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+
+class TestIndexedList; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * INDEXED LIST
+ * The elements are kept in ascending order by
+ * operator <, equal elements in the order they were
+ * inserted.  Inserting or erasing never invalidates
+ * an iterator other than the one erased.
+ **************************************************/
+template <typename T>
+class indexed_list
+{
+   friend class ::TestIndexedList; // give unit tests access to the privates
+public:
+   enum { MAX_LEVEL = 16 };   // enough for 4^16 elements
+
+   //
+   // Construct
+   //
+
+   indexed_list() : numElements(0), numLevels(1), pTail(nullptr),
+                    head(MAX_LEVEL), seed(0x9E3779B97F4A7C15ULL)
+   {
+      head.links[0].width = 1;
+   }
+   indexed_list(const indexed_list & rhs);
+   indexed_list & operator = (const indexed_list &) = delete;
+  ~indexed_list() { clear(); }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() { return iterator(head.links[0].pNext); }
+   iterator end()   { return iterator(nullptr); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & data);
+   T & at(size_t i);
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   iterator insert(const T & data);
+   iterator insert(iterator it, const T & data);
+
+   //
+   // Remove
+   //
+
+   iterator erase(const iterator & it);
+   void clear();
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+   class Tower;
+   class Node;
+
+   // one level of a tower: the towers on either side at that level,
+   // and how many base nodes it is to the next one.  The last link
+   // on each level counts through to one past the back.
+   struct Link
+   {
+      Link() : pNext(nullptr), pPrev(nullptr), width(0) {}
+      Node * pNext;
+      Tower * pPrev;
+      size_t width;
+   };
+
+   Node * seek(size_t pos);
+   void climb(Tower * pBefore, Tower * update[], size_t dist[]);
+   iterator link(const T & data, Tower * update[], size_t dist[]);
+   int randomHeight();
+
+   // member variables
+   size_t numElements;
+   int numLevels;        // levels in use, at least 1
+   Node * pTail;         // the last node on the base chain
+   Tower head;           // the sentinel, as tall as any tower can be
+   uint64_t seed;        // for choosing tower heights
+};
+
+/*************************************************
+ * TOWER
+ * the links of one base node on every level it
+ * reaches.  Level 0 is the base chain.
+ *************************************************/
+template <typename T>
+class indexed_list <T> :: Tower
+{
+public:
+   Tower(int height) : height(height), links(new Link[height]) {}
+   Tower(const Tower &) = delete;
+   Tower & operator = (const Tower &) = delete;
+  ~Tower() { delete [] links; }
+
+   int height;
+   Link * links;
+};
+
+/*************************************************
+ * NODE
+ * a tower with an element at the bottom
+ *************************************************/
+template <typename T>
+class indexed_list <T> :: Node : public Tower
+{
+public:
+   Node(const T & data, int height) : Tower(height), data(data) {}
+
+   T data;
+};
+
+/*************************************************
+ * INDEXED LIST ITERATOR
+ * A node on the base chain
+ *************************************************/
+template <typename T>
+class indexed_list <T> :: iterator
+{
+   friend class ::TestIndexedList; // give unit tests access to the privates
+   friend class indexed_list;
+public:
+   // constructors, destructors, and assignment operator
+   iterator()                     : p(nullptr) {}
+   iterator(Node * p)             : p(p)       {}
+   iterator(const iterator & rhs) : p(rhs.p)   {}
+   iterator & operator = (const iterator & rhs)
+   {
+      p = rhs.p;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+
+   // dereference operator, fetch an element
+   T & operator * () { return p->data; }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      p = p->links[0].pNext;
+      return *this;
+   }
+
+   // postfix increment
+   iterator operator ++ (int)
+   {
+      iterator itOld = *this;
+      ++(*this);
+      return itOld;
+   }
+
+   // prefix decrement.  Stepping back from the first element
+   // is as undefined as it is on custom::list.
+   iterator & operator -- ()
+   {
+      p = static_cast<Node *>(p->links[0].pPrev);
+      return *this;
+   }
+
+   // postfix decrement
+   iterator operator -- (int)
+   {
+      iterator itOld = *this;
+      --(*this);
+      return itOld;
+   }
+
+private:
+   Node * p;
+};
+
+/*****************************************
+ * INDEXED LIST :: COPY CONSTRUCTOR
+ * the elements are already in order, so
+ * each goes straight on the back
+ ****************************************/
+template <typename T>
+indexed_list <T> :: indexed_list(const indexed_list & rhs) :
+   numElements(0), numLevels(1), pTail(nullptr), head(MAX_LEVEL), seed(rhs.seed)
+{
+   head.links[0].width = 1;
+   for (Node * p = rhs.head.links[0].pNext; p; p = p->links[0].pNext)
+      insert(end(), p->data);
+}
+
+/*********************************************
+ * INDEXED LIST :: FIND
+ * go right on each level while the next element
+ * is smaller, then down
+ *    INPUT  : the element to look for
+ *    OUTPUT : an iterator on the first equal element, or end()
+ *    COST   : O(log n) expected
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: iterator indexed_list <T> :: find(const T & data)
+{
+   Tower * x = &head;
+   for (int k = numLevels - 1; k >= 0; k--)
+      while (x->links[k].pNext && x->links[k].pNext->data < data)
+         x = x->links[k].pNext;
+
+   Node * p = x->links[0].pNext;
+   if (p && !(data < p->data))
+      return iterator(p);
+   return end();
+}
+
+/*********************************************
+ * INDEXED LIST :: AT
+ * the element i places from the front
+ *    INPUT  : the index
+ *    OUTPUT : the element
+ *    COST   : O(log n) expected
+ *********************************************/
+template <typename T>
+T & indexed_list <T> :: at(size_t i)
+{
+   if (i >= numElements)
+      throw("ERROR: index out of range");
+   return seek(i + 1)->data;
+}
+
+/*********************************************
+ * INDEXED LIST :: FRONT and BACK
+ *********************************************/
+template <typename T>
+T & indexed_list <T> :: front()
+{
+   if (head.links[0].pNext)
+      return head.links[0].pNext->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+template <typename T>
+T & indexed_list <T> :: back()
+{
+   if (pTail)
+      return pTail->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * INDEXED LIST :: INSERT
+ * put the element after any equal to it
+ *    INPUT  : data to be added to the list
+ *    OUTPUT : an iterator on the new element
+ *    COST   : O(log n) expected
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: iterator indexed_list <T> :: insert(const T & data)
+{
+   Tower * update[MAX_LEVEL];
+   size_t rank[MAX_LEVEL];
+
+   // the last tower on each level that is not after data, and its
+   // position on the base chain, the sentinel being 0
+   Tower * x = &head;
+   size_t pos = 0;
+   for (int k = numLevels - 1; k >= 0; k--)
+   {
+      while (x->links[k].pNext && !(data < x->links[k].pNext->data))
+      {
+         pos += x->links[k].width;
+         x = x->links[k].pNext;
+      }
+      update[k] = x;
+      rank[k] = pos;
+   }
+
+   // how far the new node will be from each of them
+   size_t dist[MAX_LEVEL];
+   for (int k = 0; k < numLevels; k++)
+      dist[k] = pos + 1 - rank[k];
+   for (int k = numLevels; k < MAX_LEVEL; k++)
+   {
+      update[k] = &head;
+      dist[k] = pos + 1;
+   }
+   return link(data, update, dist);
+}
+
+/*********************************************
+ * INDEXED LIST :: INSERT with a hint
+ * put the element just before the iterator.  The
+ * index is found by climbing up from there rather
+ * than searching down from the top.  If the element
+ * does not belong there, it goes where it belongs.
+ *    INPUT  : where to insert, data to be added
+ *    OUTPUT : an iterator on the new element
+ *    COST   : O(log n) expected, but only O(1) expected
+ *             base and index links are touched
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: iterator indexed_list <T> :: insert(iterator it, const T & data)
+{
+   Tower * pBefore = it.p ? it.p->links[0].pPrev : (pTail ? pTail : &head);
+   if ((pBefore != &head && data < static_cast<Node *>(pBefore)->data) ||
+       (it.p && it.p->data < data))
+      return insert(data);
+
+   Tower * update[MAX_LEVEL];
+   size_t dist[MAX_LEVEL];
+   climb(pBefore, update, dist);
+   return link(data, update, dist);
+}
+
+/*********************************************
+ * INDEXED LIST :: ERASE
+ * unlink the node from every level it is on, and
+ * shorten every jump over it from the levels above
+ *    INPUT  : an iterator on the element to remove
+ *    OUTPUT : an iterator on the element after it
+ *    COST   : O(log n) expected
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: iterator indexed_list <T> :: erase(const iterator & it)
+{
+   Node * p = it.p;
+   if (!p)
+      return it;
+
+   Tower * update[MAX_LEVEL];
+   size_t dist[MAX_LEVEL];
+   climb(p->links[0].pPrev, update, dist);
+
+   for (int k = 0; k < numLevels; k++)
+      if (k < p->height)
+      {
+         Node * pNext = p->links[k].pNext;
+         update[k]->links[k].pNext = pNext;
+         update[k]->links[k].width += p->links[k].width - 1;
+         if (pNext)
+            pNext->links[k].pPrev = update[k];
+      }
+      else
+         update[k]->links[k].width--;
+
+   if (pTail == p)
+      pTail = (p->links[0].pPrev == &head) ? nullptr : static_cast<Node *>(p->links[0].pPrev);
+   while (numLevels > 1 && !head.links[numLevels - 1].pNext)
+      numLevels--;
+   numElements--;
+
+   iterator itNext(p->links[0].pNext);
+   delete p;
+   return itNext;
+}
+
+/*********************************************
+ * INDEXED LIST :: CLEAR
+ *********************************************/
+template <typename T>
+void indexed_list <T> :: clear()
+{
+   Node * p = head.links[0].pNext;
+   while (p)
+   {
+      Node * pDelete = p;
+      p = p->links[0].pNext;
+      delete pDelete;
+   }
+
+   for (int k = 0; k < MAX_LEVEL; k++)
+      head.links[k] = Link();
+   head.links[0].width = 1;
+   numLevels = 1;
+   numElements = 0;
+   pTail = nullptr;
+}
+
+/*********************************************
+ * INDEXED LIST :: SEEK
+ * the node at a position on the base chain,
+ * counting the sentinel as 0
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: Node * indexed_list <T> :: seek(size_t pos)
+{
+   Tower * x = &head;
+   size_t at = 0;
+   for (int k = numLevels - 1; k >= 0; k--)
+      while (x->links[k].pNext && at + x->links[k].width <= pos)
+      {
+         at += x->links[k].width;
+         x = x->links[k].pNext;
+      }
+   return static_cast<Node *>(x);
+}
+
+/*********************************************
+ * INDEXED LIST :: CLIMB
+ * the last tower on each level at or before
+ * pBefore, and how far past each one the base node
+ * after pBefore is.  Each level is walked back until
+ * a tower tall enough for the next level turns up,
+ * about four towers per level.
+ *    INPUT  : a tower on the base chain
+ *    OUTPUT : update[] and dist[] filled for every level
+ *    COST   : O(log n) expected
+ *********************************************/
+template <typename T>
+void indexed_list <T> :: climb(Tower * pBefore, Tower * update[], size_t dist[])
+{
+   Tower * x = pBefore;
+   size_t d = 1;
+   for (int k = 0; k < numLevels; k++)
+   {
+      while (x->height <= k)
+      {
+         x = x->links[k - 1].pPrev;
+         d += x->links[k - 1].width;
+      }
+      update[k] = x;
+      dist[k] = d;
+   }
+
+   // a new top level starts at the sentinel
+   int top = numLevels - 1;
+   while (x != &head)
+   {
+      x = x->links[top].pPrev;
+      d += x->links[top].width;
+   }
+   for (int k = numLevels; k < MAX_LEVEL; k++)
+   {
+      update[k] = &head;
+      dist[k] = d;
+   }
+}
+
+/*********************************************
+ * INDEXED LIST :: LINK
+ * build a node and splice it in after update[k] on
+ * each level it reaches, splitting their jumps.  The
+ * jumps on the levels above it get one longer.
+ *    INPUT  : the data, the towers before the new node
+ *             on each level, and how far it is from each
+ *    OUTPUT : an iterator on the new node
+ *    COST   : O(log n) for the levels above it
+ *********************************************/
+template <typename T>
+typename indexed_list <T> :: iterator indexed_list <T> :: link(const T & data, Tower * update[], size_t dist[])
+{
+   int height = randomHeight();
+   Node * pNew = new Node(data, height);
+
+   // a taller tower than any yet opens new levels on the sentinel,
+   // each jumping straight to one past the back
+   for (; numLevels < height; numLevels++)
+      head.links[numLevels].width = numElements + 1;
+
+   for (int k = 0; k < numLevels; k++)
+   {
+      Link & before = update[k]->links[k];
+      if (k < height)
+      {
+         Node * pNext = before.pNext;
+         pNew->links[k].pNext = pNext;
+         pNew->links[k].pPrev = update[k];
+         pNew->links[k].width = before.width + 1 - dist[k];
+         before.pNext = pNew;
+         before.width = dist[k];
+         if (pNext)
+            pNext->links[k].pPrev = pNew;
+      }
+      else
+         before.width++;
+   }
+
+   if (!pNew->links[0].pNext)
+      pTail = pNew;
+   numElements++;
+   return iterator(pNew);
+}
+
+/*********************************************
+ * INDEXED LIST :: RANDOM HEIGHT
+ * 1 with chance 3/4, 2 with 3/16, and so on: each
+ * pair of zero bits in a random number adds a level
+ *********************************************/
+template <typename T>
+int indexed_list <T> :: randomHeight()
+{
+   // xorshift64*: cheap and plenty random for this
+   seed ^= seed >> 12;
+   seed ^= seed << 25;
+   seed ^= seed >> 27;
+   uint64_t bits = seed * 0x2545F4914F6CDD1DULL;
+
+   int height = 1;
+   while (height < MAX_LEVEL && (bits & 3) == 0)
+   {
+      height++;
+      bits >>= 2;
+   }
+   return height;
+}
+
+}; // namespace custom
@@ -0,0 +1,287 @@
+/***********************************************************************
+ * Header:
+ *    LFU CACHE
+ * Summary:
+ *    A fixed-capacity cache that forgets the least frequently used
+ *    entry first, and of those the least recently used.  The entries
+ *    are kept in frequency buckets: a custom::list of buckets in
+ *    increasing order of use count, each holding a custom::list of
+ *    the entries used that many times, most recent first.  A
+ *    custom::unordered_map finds an entry's bucket and node by key.
+ *
+ *    Every bucket's list shares one node pool, so a hit splices the
+ *    entry's node from its bucket into the next one without
+ *    allocating, and a miss on a full cache overwrites the victim's
+ *    node and splices it into the bucket for a single use.
+ *
+ *    A cache is for one thread at a time.  That shared pool lives on
+ *    the heap, so taking a node from it or giving one back takes its
+ *    lock.  Splicing does neither.
+ *
+ *    This will contain the class definition of:
+ *        lfu_cache : A class that represents an LFU cache
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cstddef>     // for size_t
+#include <utility>     // for std::pair
+#include "list.h"      // for the buckets and their entries
+#include "hash.h"      // for the index
+
+class TestLfuCache;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * LFU CACHE
+ * Holds at most capacity() key-value pairs.  Both
+ * get() and put() count as a use; contains() does
+ * not.
+ **************************************************/
+template <typename K, typename V, typename Hash = std::hash<K>>
+class lfu_cache
+{
+   friend class ::TestLfuCache; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   explicit lfu_cache(size_t capacity);
+   lfu_cache(const lfu_cache &) = delete;
+   lfu_cache & operator = (const lfu_cache &) = delete;
+
+   //
+   // Access
+   //
+
+   V * get(const K & key);
+   bool contains(const K & key) { return index.count(key) != 0; }
+
+   //
+   // Insert and remove
+   //
+
+   void put(const K & key, const V & value);
+   bool erase(const K & key);
+   void clear();
+
+   //
+   // Status
+   //
+
+   size_t size() const     { return index.size(); }
+   size_t capacity() const { return maxEntries;   }
+   bool empty() const      { return index.size() == 0; }
+
+private:
+   typedef std::pair<K, V> Entry;
+
+   // every entry used the same number of times
+   struct Bucket
+   {
+      Bucket(size_t uses) : uses(uses) {}
+      size_t uses;
+      list<Entry> entries;                      // most recently used first
+   };
+   typedef typename list<Entry>::iterator EntryPosition;
+   typedef typename list<Bucket>::iterator BucketPosition;
+
+   // where an entry is
+   struct Where
+   {
+      BucketPosition bucket;
+      EntryPosition entry;
+   };
+
+   BucketPosition bucketBefore(BucketPosition pos, size_t uses);
+   void moveTo(Where & where, BucketPosition bucket);
+   void promote(Where & where);
+
+   // member variables
+   list<Entry> spare;                           // holds the pool the buckets share
+   list<Bucket> buckets;                        // fewest uses first
+   unordered_map<K, Where, Hash> index;         // where each key's entry is
+   size_t maxEntries;
+};
+
+/*****************************************
+ * LFU CACHE :: CONSTRUCTOR
+ * every node and bucket the cache will ever
+ * need is made up front.  There can be one
+ * bucket per entry, plus one made by a hit
+ * before the one it left is let go.
+ ****************************************/
+template <typename K, typename V, typename Hash>
+lfu_cache <K, V, Hash> :: lfu_cache(size_t capacity) : maxEntries(capacity)
+{
+   spare.reserve(capacity);
+   buckets.reserve(capacity + 1);
+   index.reserve(capacity);
+}
+
+/*********************************************
+ * LFU CACHE :: GET
+ * look up a key, counting it as a use
+ *    INPUT  : the key
+ *    OUTPUT : its value, or NULL on a miss.  Good until
+ *             the entry is evicted or erased.
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+V * lfu_cache <K, V, Hash> :: get(const K & key)
+{
+   auto it = index.find(key);
+   if (it == index.end())
+      return nullptr;
+   promote(it->second);
+   return &(*it->second.entry).second;
+}
+
+/*********************************************
+ * LFU CACHE :: PUT
+ * set a key's value, counting it as a use.  A new
+ * key starts with a single use; on a full cache it
+ * takes over the node of the least recently used of
+ * the least frequently used entries.
+ *    INPUT  : the key and its value
+ *    OUTPUT :
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lfu_cache <K, V, Hash> :: put(const K & key, const V & value)
+{
+   if (maxEntries == 0)
+      return;
+
+   auto it = index.find(key);
+   if (it != index.end())
+   {
+      (*it->second.entry).second = value;
+      promote(it->second);
+      return;
+   }
+
+   if (index.size() < maxEntries)
+   {
+      BucketPosition bucket = bucketBefore(buckets.begin(), 1);
+      (*bucket).entries.push_front(Entry(key, value));
+      Where where = { bucket, (*bucket).entries.begin() };
+      index.insert(std::make_pair(key, where));
+      return;
+   }
+
+   // recycle the victim's node for the new entry
+   Where where;
+   where.bucket = buckets.begin();
+   where.entry = (*where.bucket).entries.rbegin();
+   index.erase((*where.entry).first);
+   (*where.entry).first = key;
+   (*where.entry).second = value;
+   if ((*where.bucket).uses != 1)
+      moveTo(where, bucketBefore(where.bucket, 1));
+   else if (where.entry != (*where.bucket).entries.begin())
+      moveTo(where, where.bucket);
+   index.insert(std::make_pair(key, where));
+}
+
+/*********************************************
+ * LFU CACHE :: ERASE
+ *    INPUT  : the key to forget
+ *    OUTPUT : whether it was there
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+bool lfu_cache <K, V, Hash> :: erase(const K & key)
+{
+   auto it = index.find(key);
+   if (it == index.end())
+      return false;
+   BucketPosition bucket = it->second.bucket;
+   (*bucket).entries.erase(it->second.entry);
+   if ((*bucket).entries.empty())
+      buckets.erase(bucket);
+   index.erase(it);
+   return true;
+}
+
+/*********************************************
+ * LFU CACHE :: CLEAR
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lfu_cache <K, V, Hash> :: clear()
+{
+   buckets.clear();
+   index.clear();
+}
+
+/*********************************************
+ * LFU CACHE :: BUCKET BEFORE
+ * find the bucket for a use count, making it if
+ * need be
+ *    INPUT  : the bucket that comes after it if it is
+ *             not there, and the use count
+ *    OUTPUT : the bucket, sharing the entries' pool
+ *    COST   : O(1)
+ *********************************************/
+template <typename K, typename V, typename Hash>
+typename lfu_cache <K, V, Hash> :: BucketPosition
+lfu_cache <K, V, Hash> :: bucketBefore(BucketPosition pos, size_t uses)
+{
+   if (pos != buckets.end() && (*pos).uses == uses)
+      return pos;
+   pos = buckets.emplace(pos, uses);
+   spare.share_pool((*pos).entries);
+   return pos;
+}
+
+/*********************************************
+ * LFU CACHE :: MOVE TO
+ * relink an entry to the front of a bucket,
+ * letting go of the one it left if that is now
+ * empty.  Its node, and so the index, stays good.
+ *    INPUT  : where the entry is, and where it goes
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lfu_cache <K, V, Hash> :: moveTo(Where & where, BucketPosition bucket)
+{
+   EntryPosition itNext = where.entry;
+   ++itNext;
+   list<Entry> & from = (*where.bucket).entries;
+   (*bucket).entries.splice((*bucket).entries.begin(), from, where.entry, itNext);
+   if (from.empty())
+      buckets.erase(where.bucket);
+   where.bucket = bucket;
+}
+
+/*********************************************
+ * LFU CACHE :: PROMOTE
+ * count one more use of an entry
+ *    INPUT  : where the entry is
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lfu_cache <K, V, Hash> :: promote(Where & where)
+{
+   size_t uses = (*where.bucket).uses + 1;
+   BucketPosition next = where.bucket;
+   ++next;
+
+   // alone in its bucket, and no bucket to join: the bucket moves up instead
+   if ((*where.bucket).entries.size() == 1 &&
+       (next == buckets.end() || (*next).uses != uses))
+   {
+      (*where.bucket).uses = uses;
+      return;
+   }
+
+   moveTo(where, bucketBefore(next, uses));
+}
+
+}; // namespace custom
@@ -23,58 +23,114 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <functional>  // for std::less
+#include <utility>     // for std::forward and std::piecewise_construct
+#include <iterator>    // for std::distance
+#include <type_traits> // for std::enable_if
+#include <vector>      // for std::vector
+#include <algorithm>   // for std::sort
+#include <atomic>      // for std::atomic, std::atomic_flag
+#include <thread>      // for std::this_thread::yield
+#include "hazard.h"    // for hazard_domain
  
+// a hint to start loading a node into the cache
+#if defined(__GNUC__) || defined(__clang__)
+#define LIST_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define LIST_PREFETCH(p) _mm_prefetch((const char *)(p), _MM_HINT_T0)
+#else
+#define LIST_PREFETCH(p)
+#endif
+
 class TestList;        // forward declaration for unit tests
 class TestHash;
+class TestLruCache;
+class TestLfuCache;
 
 namespace custom
 {
 
 /**************************************************
  * LIST
- * Just like std::list
+ * Just like std::list.  Every Node is allocated and
+ * released through A, rebound to the Node type.
  **************************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>>
 class list
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
-   friend void swap(list& lhs, list& rhs);
+   friend class ::TestLruCache;
+   friend class ::TestLfuCache;
+   template <typename TT, typename AA>
+   friend void swap(list <TT, AA> & lhs, list <TT, AA> & rhs);
 public:  
    // 
    // Construct
    //
 
    list();
-   list(list <T> & rhs);
-   list(list <T>&& rhs);
+   explicit list(const A & a);
+   list(list <T, A> & rhs);
+   list(list <T, A>&& rhs);
    list(size_t num, const T & t);
    list(size_t num);
    list(const std::initializer_list<T>& il);
-   template <class Iterator>
+   template <class Iterator, class = typename
+             std::enable_if<!std::is_integral<Iterator>::value>::type>
    list(Iterator first, Iterator last);
   ~list() 
    {
-      pHead = pTail = nullptr;
-      numElements= 0;
+      clear();
+      endCompaction();
+      orphanRetirement();
+      releasePool();
    }
 
    // 
    // Assign
    //
 
-   list <T> & operator = (list &  rhs);
-   list <T> & operator = (list && rhs);
-   list <T> & operator = (const std::initializer_list<T>& il);
+   list <T, A> & operator = (list &  rhs);
+   list <T, A> & operator = (list && rhs);
+   list <T, A> & operator = (const std::initializer_list<T>& il);
 
    //
    // Iterator
    //
 
    class  iterator;
-   iterator begin()  { return iterator(pHead); }
-   iterator rbegin() { return iterator(nullptr); }
+   iterator begin()  { leak(); return iterator(pHead); }
+   iterator rbegin() { leak(); return iterator(pTail); }
    iterator end()    { return iterator(nullptr); }
+   class  const_iterator;
+   const_iterator begin()  const { return const_iterator(pHead);   }
+   const_iterator rbegin() const { return const_iterator(pTail);   }
+   const_iterator end()    const { return const_iterator(nullptr); }
+   const_iterator cbegin() const { return const_iterator(pHead);   }
+   const_iterator cend()   const { return const_iterator(nullptr); }
+
+   //
+   // Traverse
+   //
+
+   template <class F>
+   F for_each(F f, size_t distance = 4);
+
+   //
+   // Operations
+   //
+
+   void sort() { sort(std::less<T>()); }
+   template <class Compare>
+   void sort(Compare comp);
+   void splice(iterator pos, list <T, A> & rhs);
+   void splice(iterator pos, list <T, A> & rhs, iterator first, iterator last);
+   void merge(list <T, A> & rhs) { merge(rhs, std::less<T>()); }
+   template <class Compare>
+   void merge(list <T, A> & rhs, Compare comp);
+   list <T, A> split_at(iterator it);
 
    //
    // Access
@@ -82,6 +138,10 @@ public:
 
    T& front();
    T& back();
+   const T& front() const;
+   const T& back() const;
+   T& at(size_t i);
+   iterator advance(size_t i);
 
    //
    // Insert
@@ -93,6 +153,12 @@ public:
    void push_back (      T&& data);
    iterator insert(iterator it, const T& data);
    iterator insert(iterator it, T&& data);
+   template <class ... Args>
+   T & emplace_front(Args && ... args);
+   template <class ... Args>
+   T & emplace_back(Args && ... args);
+   template <class ... Args>
+   iterator emplace(iterator it, Args && ... args);
 
    //
    // Remove
@@ -109,16 +175,222 @@ public:
 
    bool empty()  const { return numElements ==0; }
    size_t size() const { return numElements;   }
+   A get_allocator() const { return A(alloc); }
+
+   //
+   // Node pool
+   //
+
+   size_t capacity() const;
+   void reserve(size_t num);
+   void shrink_to_fit();
+   void share_pool(list <T, A> & rhs) { sharePool(rhs); }
+
+   //
+   // Compaction
+   //
+
+   // Both move elements to new nodes, leaving every iterator and
+   // reference into the list dangling; the finger at() keeps is
+   // reset.  Do not compact a list whose iterators are kept, as a
+   // cache's are.
+   double fragmentation() const;
+   void compact();
+   bool compact_step(size_t budget);
+
+   //
+   // Reclamation
+   //
+
+   void retire_into(hazard_domain * pDomain);
+
+   //
+   // Copy on write
+   //
+
+   // A copy shares our nodes until one side writes.  Anything that
+   // hands out a way to write, such as begin(), front() or at() on
+   // a list that is not const, copies the nodes and stops sharing them
+   // for good.  Read through a const list, or cbegin(), to keep them.
+   void copy_on_write(bool on = true)
+   {
+      static_assert(std::is_copy_constructible<T>::value,
+                    "only a list of elements that can be copied can share them");
+      copyOnWrite = on;
+   }
+   bool shares_nodes() const { return pShare && pShare->numRefs > 1; }
 
 
 private:
    // nested linked list class
    class Node;
 
+   // the allocator we actually use: A rebound to the Node
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+   typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+   // every Node goes through these two
+   Node * createNode();
+   Node * createNode(const T & data);
+   Node * createNode(T && data);
+   template <class ... Args>
+   Node * emplaceNode(Args && ... args);
+   void destroyNode(Node * p);
+   void retireNode(Node * p);
+
+   // detach or attach a run of nodes, first through last inclusive
+   void unlink(Node * pFirst, Node * pLast);
+   void linkBefore(Node * pPos, Node * pFirst, Node * pLast);
+
+   // positional access walks from the head, the tail, or the last
+   // position it reached, whichever is closest.  Anything that moves
+   // nodes around without keeping that position right forgets it.
+   Node * locate(size_t i);
+   void forgetFinger() { pFinger = nullptr; }
+
+   // the slab pool: nodes are carved out of large blocks and, once
+   // released, wait on the free list until they are needed again
+   struct Slab;
+   static const size_t SLAB_MIN = 8;
+   static const size_t SLAB_MAX = 1024;
+   Node * allocateNode();
+   void releaseNode(Node * p);
+   Slab * allocateSlab(size_t num);
+   void addSlab(size_t num);
+   Node * relocate(Node * pFirst, size_t num, Node * pDest);
+   void relocateData(Node * pNew, T & data, std::true_type)
+   {
+      NodeTraits::construct(alloc, pNew, static_cast<const T &>(data));
+   }
+   void relocateData(Node * pNew, T & data, std::false_type)
+   {
+      NodeTraits::construct(alloc, pNew, std::move(data));
+   }
+   void endCompaction();
+   static Node * & nextFree(Node * p) { return *reinterpret_cast<Node **>(p); }
+
+   // a flag to test and set, for what more than one thread can
+   // reach.  A copy starts out unlocked.
+   class Spinlock
+   {
+   public:
+      Spinlock() {}
+      Spinlock(const Spinlock &) {}
+      Spinlock & operator = (const Spinlock &) { return *this; }
+      void lock() const
+      {
+         for (int spins = 1; flag.test_and_set(std::memory_order_acquire); spins++)
+            if (spins % 64 == 0)
+               std::this_thread::yield();
+      }
+      void unlock() const { flag.clear(std::memory_order_release); }
+   private:
+      mutable std::atomic_flag flag = ATOMIC_FLAG_INIT;
+   };
+
+   // the pool the slabs belong to.  A list starts out with its own;
+   // once nodes move between two lists they share one on the heap,
+   // released by whichever of them is destroyed last.  Lists sharing
+   // a pool may each be used on a thread of their own, unless they
+   // share nodes as well: a heap pool is only touched under its own
+   // lock, through a PoolLock.
+   struct Pool
+   {
+      Pool() {}
+      Pool(const Pool & rhs) { *this = rhs; }
+      Pool & operator = (const Pool & rhs)
+      {
+         pFree = rhs.pFree;
+         pSlabs = rhs.pSlabs;
+         numFree = rhs.numFree;
+         numRefs.store(rhs.numRefs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+         pForward.store(rhs.pForward.load(std::memory_order_relaxed), std::memory_order_relaxed);
+         return *this;
+      }
+
+      Node * pFree    = nullptr; // released nodes, ready to be reused
+      Slab * pSlabs   = nullptr; // every block nodes were carved from
+      size_t numFree  = 0;       // number of nodes on the free list
+      std::atomic<size_t> numRefs{ 0 };       // lists and pools holding a shared pool
+      std::atomic<Pool *> pForward{ nullptr }; // the pool this one was merged into
+      Spinlock lock;             // guards the rest, once the pool is on the heap
+   };
+   class PoolLock;
+   typedef typename NodeTraits::template rebind_alloc<Pool> PoolAlloc;
+   typedef std::allocator_traits<PoolAlloc> PoolTraits;
+   Pool & pool();
+   const Pool & pool() const;
+   void heapPool();
+   void sharePool(list <T, A> & rhs);
+   void stealPool(list <T, A> & rhs);
+   void releasePool();
+   static Pool & follow(Pool * & pPool, NodeAlloc & alloc);
+   static Pool & lockShared(Pool * & pPool, NodeAlloc & alloc);
+   static Slab * carveSlab(Pool & pool, NodeAlloc & alloc, size_t num);
+   static void threadSlab(Pool & pool, Slab * pSlab);
+   static void pushFree(Pool & pool, Node * p);
+   static void unrefPool(Pool * p, NodeAlloc & alloc);
+   static void freeSlabs(Pool & pool, NodeAlloc & alloc);
+
+   // erased nodes retired into a hazard domain still belong to the
+   // pool.  This is what they need to find their way back to it,
+   // even after the list itself is gone.
+   struct Retirement
+   {
+      NodeAlloc alloc;       // to destroy the node and, last out, free the pool
+      Pool * pPool;          // one reference, held until the last node is back
+      size_t numPending;     // nodes retired but not yet reclaimed
+      bool orphaned;         // the list has let go; the last node frees this
+      Spinlock lock;         // guards the rest, as any thread may reclaim
+   };
+   typedef typename NodeTraits::template rebind_alloc<Retirement> RetirementAlloc;
+   typedef std::allocator_traits<RetirementAlloc> RetirementTraits;
+   static void reclaimNode(void * p, void * context);
+   static void freeRetirement(Retirement * pRetirement);
+   void orphanRetirement();
+
+   // in copy-on-write mode a copy shares the source's nodes, and
+   // whichever of them changes first gets nodes of its own.  Every
+   // list sharing the nodes holds one reference to the same count.
+   // A write through an iterator or reference would go straight to
+   // the shared nodes, so a list that has handed one out is copied
+   // in full, and one that is about to gets its own nodes first.
+   // Neither the count nor the leaked flag is locked: lists sharing
+   // nodes belong to one thread until they stop.
+   struct Share
+   {
+      size_t numRefs;        // lists sharing the nodes
+   };
+   typedef typename NodeTraits::template rebind_alloc<Share> ShareAlloc;
+   typedef std::allocator_traits<ShareAlloc> ShareTraits;
+   bool canShare(const list <T, A> & rhs) const;
+   void shareWith(list <T, A> & rhs);
+   void unshare() { unshare(std::is_copy_constructible<T>()); }
+   void unshare(std::true_type) { if (pShare) detach(); }
+   void unshare(std::false_type) {}  // copy_on_write() refuses such a T
+   void leak() { unshare(); leaked = true; }
+   void detach();
+   Node * cloneChain();
+   bool dropShare();
+   void freeShare();
+
    // member variables
    size_t numElements; // though we could count, it is faster to keep a variable
    Node * pHead;    // pointer to the beginning of the list
    Node * pTail;    // pointer to the ending of the list
+   NodeAlloc alloc; // where the nodes come from
+   Pool local;            // our own pool, until we share one
+   Pool * pPool = &local; // the pool in use: local or shared
+   Node * pCompact = nullptr; // next node compact_step() will move
+   Node * pCompactNext = nullptr; // the slots this pass of compact_step() has
+   Node * pCompactEnd = nullptr;  // yet to fill, or NULL between passes
+   hazard_domain * pDomain = nullptr;   // where erased nodes go, or NULL to free at once
+   Retirement * pRetirement = nullptr;  // made on the first retire
+   Node * pFinger = nullptr;  // the node at() or advance() last reached, or NULL
+   size_t iFinger = 0;        // and its index
+   bool copyOnWrite = false;  // whether copies of this list share its nodes
+   Share * pShare = nullptr;  // the count, while the nodes are or were shared
+   bool leaked = false;       // whether an iterator or reference to a node may be out
 };
 
 /*************************************************
@@ -128,26 +400,31 @@ private:
  * private.  This is the case because only the
  * List class can make validation decisions
  *************************************************/
-template <typename T>
-class list <T> :: Node
+template <typename T, typename A>
+class list <T, A> :: Node
 {
 public:
    //
    // Construct
    //
-   Node()  
+   Node() : data()
+   {
+      pNext = pPrev = nullptr;
+   }
+   Node(const T &  data) : data(data)
    {
-      this->data = 0;
       pNext = pPrev = nullptr;
    }
-   Node(const T &  data)  
+   Node(      T && data) : data(std::move(data))
    {
-      this->data = data;
       pNext = pPrev = nullptr;
    }
-   Node(      T && data)  
+
+   // build the data in place from whatever T's constructor takes
+   template <class ... Args>
+   explicit Node(std::piecewise_construct_t, Args && ... args) :
+      data(std::forward<Args>(args)...)
    {
-      this->data = std::move(data);
       pNext = pPrev = nullptr;
    }
 
@@ -160,17 +437,34 @@ public:
    Node * pPrev;       // pointer to previous node
 };
 
+/*************************************************
+ * SLAB
+ * The header of one block of nodes.  It occupies the
+ * first node's worth of space and the nodes follow it.
+ *************************************************/
+template <typename T, typename A>
+struct list <T, A> :: Slab
+{
+   Slab * pNext;    // the next block in the pool
+   size_t numNodes; // number of nodes following this header
+   size_t numFree;  // scratch count used by shrink_to_fit()
+
+   Node * begin() { return reinterpret_cast<Node *>(this) + 1; }
+   Node * end()   { return begin() + numNodes; }
+};
+
 /*************************************************
  * LIST ITERATOR
  * Iterate through a List, non-constant version
  ************************************************/
-template <typename T>
-class list <T> :: iterator
+template <typename T, typename A>
+class list <T, A> :: iterator
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
-   template <typename TT>
+   template <typename TT, typename AA>
    friend class custom::list;
+   friend class list <T, A> :: const_iterator;
 public:
    // constructors, destructors, and assignment operator
    iterator() 
@@ -232,213 +526,160 @@ public:
    } 
 
    // two friends who need to access p directly
-   friend iterator list <T> :: insert(iterator it, const T &  data);
-   friend iterator list <T> :: insert(iterator it,       T && data);
-   friend iterator list <T> :: erase(const iterator & it);
+   friend iterator list <T, A> :: insert(iterator it, const T &  data);
+   friend iterator list <T, A> :: insert(iterator it,       T && data);
+   friend iterator list <T, A> :: erase(const iterator & it);
 
 private:
 
-   typename list <T> :: Node * p;
+   typename list <T, A> :: Node * p;
 };
 
-/*****************************************
- * LIST :: NON-DEFAULT constructors
- * Create a list initialized to a value
- ****************************************/
-template <typename T>
-list <T> ::list(size_t num, const T & t):pHead(nullptr), pTail(nullptr), numElements(num)
+/*************************************************
+ * LIST CONST ITERATOR
+ * Iterate through a List, constant version.  This
+ * is how to read a copy-on-write copy without
+ * giving it nodes of its own.
+ ************************************************/
+template <typename T, typename A>
+class list <T, A> :: const_iterator
 {
-   if(num >= 0)
-   {
-      pHead = pTail = new list::Node(t);  // Create a New Node
+   friend class ::TestList; // give unit tests access to the privates
+public:
+   // constructors, destructors, and assignment operator
+   const_iterator()                 : p(nullptr) {}
+   const_iterator(const Node * p)   : p(p)       {}
+   const_iterator(const iterator & rhs) : p(rhs.p) {}
 
-      // Current Head
-      Node *currentHead = pHead;
-         
-      for (size_t it = 0; (it != num - 1) && currentHead; it++)
-      {
-         // Create a Node
-         Node* newNode = new list::Node(t);  
+   // equals, not equals operator
+   bool operator == (const const_iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const const_iterator & rhs) const { return p != rhs.p; }
 
-         currentHead->pNext = newNode; // Assing currenthead next to new node
+   // dereference operator, fetch a node
+   const T & operator * () const { return p->data; }
 
-         // Assign currenthead prev to currentHead
-         newNode->pPrev = currentHead;
+   // postfix increment
+   const_iterator operator ++ (int postfix)
+   {
+      const_iterator itOld = *this;
+      p = p->pNext;
+      return itOld;
+   }
 
-         // Update Tail
-         pTail = newNode;
+   // prefix increment
+   const_iterator & operator ++ ()
+   {
+      p = p->pNext;
+      return *this;
+   }
 
-         // Update Pointers
-         currentHead = currentHead->pNext;
-      }
+   // postfix decrement
+   const_iterator operator -- (int postfix)
+   {
+      const_iterator itOld = *this;
+      p = p->pPrev;
+      return itOld;
+   }
 
-      // Assign Null pointers
-      pHead->pPrev = pTail->pNext = nullptr;
+   // prefix decrement
+   const_iterator & operator -- ()
+   {
+      p = p->pPrev;
+      return *this;
    }
 
-   numElements = num;
+private:
+   const typename list <T, A> :: Node * p;
+};
+
+/*****************************************
+ * LIST :: NON-DEFAULT constructors
+ * Create a list initialized to a value.  All
+ * the nodes come from one block, in list order.
+ ****************************************/
+template <typename T, typename A>
+list <T, A> ::list(size_t num, const T & t):numElements(0), pHead(nullptr), pTail(nullptr)
+{
+   reserve(num);
+   for (size_t i = 0; i < num; i++)
+      push_back(t);
 }
 
 /*****************************************
  * LIST :: ITERATOR constructors
- * Create a list initialized to a set of values
+ * Create a list initialized to a set of values.
+ * When the size of the range is known up front,
+ * all the nodes come from one block, in list order.
  ****************************************/
-template <typename T>
-template <class Iterator>
-list <T> ::list(Iterator first, Iterator last)
+template <typename T, typename A>
+template <class Iterator, class>
+list <T, A> ::list(Iterator first, Iterator last):numElements(0), pHead(nullptr), pTail(nullptr)
 {
-   if(first)
-   {
-      int count = 0;
-
-      // Çreate a Head Node
-      Node * headNode = new list::Node();
-      pHead = pTail = headNode;
-          
-      for(auto it = first; it != last-2; ++it)
-      {
-         headNode->data = *it;
-         count++;
-      }
+   typedef typename std::iterator_traits<Iterator>::iterator_category Category;
+   if (std::is_base_of<std::forward_iterator_tag, Category>::value)
+      reserve(std::distance(first, last));
 
-      Node * currentHead = headNode;   // Keep Track of Current Head
-        
-      // Loop Over Remaining Value
-      for(auto it = first + 1; it != last; ++it)
-      {
-         Node *newNode = new list::Node();   // Create New Node
-            
-         newNode->data = *it;  // Assign Value to newNode
-            
-         // Update the Pointers
-         currentHead->pNext = newNode;
-         newNode->pPrev = currentHead;
-            
-         // Update the Tail and currentHead
-         currentHead = pTail = newNode;
-            
-         count++;
-      }
-        
-      // Point next and previous to NULL
-      pHead->pPrev = pTail->pNext = nullptr;
-        
-      numElements = count;
-   }
-   else
-   {
-      pHead = pTail = nullptr;
-      numElements = 0;
-   }
+   for (Iterator it = first; it != last; ++it)
+      push_back(*it);
 }
 
 /*****************************************
  * LIST :: INITIALIZER constructors
- * Create a list initialized to a set of values
+ * Create a list initialized to a set of values.
+ * All the nodes come from one block, in list order.
  ****************************************/
-template <typename T>
-list <T> ::list(const std::initializer_list<T>& il)
+template <typename T, typename A>
+list <T, A> ::list(const std::initializer_list<T>& il):numElements(0), pHead(nullptr), pTail(nullptr)
 {
-   if(il.size())
-   {
-      // Create a Head Node
-      Node * headNode = new list::Node();
-      pHead = pTail = headNode;
-        
-      // Assign Value to First Node
-      for(auto it = il.begin(); it!= il.end()-2 ; ++it)
-         headNode->data = *it;
-
-
-      Node * currentHead = headNode;
-        
-      // Loop Over Remaining Value
-      for(auto it = il.begin() + 1; it != il.end(); ++it)
-      {
-         // Create New Node
-         Node *newNode = new list::Node();
-            
-         // Assign Value to newNode
-         newNode->data = *it;
-            
-         // Update the Pointers
-         currentHead->pNext = newNode;
-         newNode->pPrev = currentHead;
-            
-         // Update the Tail and currentHead
-         pTail = newNode;
-         currentHead = newNode;
-            
-      }
-        
-      // Point next and previous to NULL
-      pHead->pPrev = nullptr;
-      pTail->pNext = nullptr;
-        
-   }
-     
-   // Change the numElements
-   numElements = il.size();
+   reserve(il.size());
+   for (const T & t : il)
+      push_back(t);
 }
 
 /*****************************************
  * LIST :: NON-DEFAULT constructors
- * Create a list initialized to a value
+ * Create a list of default values.  All the
+ * nodes come from one block, in list order.
  ****************************************/
-template <typename T>
-list <T> ::list(size_t num)
+template <typename T, typename A>
+list <T, A> ::list(size_t num):numElements(0), pHead(nullptr), pTail(nullptr)
 {
-   // Check if size was less than Zero
-   if(num <= 0)
-   {
-      pHead = pTail = nullptr;
-   } 
-   else 
-   {
-      // Create a New Node
-      pHead = pTail = new list::Node();
-
-      // Current Head
-      Node *currentHead = pHead;
-
-      for (size_t it = 0; (it != num - 1) && currentHead; it++)
-      {
-         // Create a Node
-         Node* newNode = new list::Node(0);
-
-         // Assign Currenthead next to new Node
-         currentHead->pNext = newNode;
-         newNode->pPrev = currentHead;
-
-         // Update the Tail
-         pTail = newNode;
-
-         // Update the Head
-         currentHead = currentHead->pNext;
-      }
-
-      // Assign to Null Pointers
-      pHead->pPrev = pTail->pNext = nullptr;
-   }
-    
-   numElements = num;
+   reserve(num);
+   for (size_t i = 0; i < num; i++)
+      emplace_back();
 }
 
 /*****************************************
  * LIST :: DEFAULT constructors
  ****************************************/
-template <typename T>
-list <T> ::list():numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list():numElements(0), pHead(nullptr), pTail(nullptr)
 {
    pHead = pTail = nullptr;
    numElements = 0;
 }
 
+/*****************************************
+ * LIST :: ALLOCATOR constructors
+ * An empty list drawing its nodes from a
+ * given allocator (a pool or an arena)
+ ****************************************/
+template <typename T, typename A>
+list <T, A> ::list(const A & a):numElements(0), pHead(nullptr), pTail(nullptr), alloc(a)
+{
+}
+
 /*****************************************
  * LIST :: COPY constructors
+ * A copy of a list in copy-on-write mode is in
+ * that mode too, and shares its nodes, unless the
+ * list has handed out an iterator or a reference
+ * since it was last cleared.
  ****************************************/
-template <typename T>
-list <T> ::list(list& rhs) :pHead(nullptr), pTail(nullptr), numElements(0)
+template <typename T, typename A>
+list <T, A> ::list(list& rhs) :pHead(nullptr), pTail(nullptr), numElements(0),
+   alloc(NodeTraits::select_on_container_copy_construction(rhs.alloc)),
+   copyOnWrite(rhs.copyOnWrite)
 {
    if(!rhs.pHead)
       this->pHead = nullptr;
@@ -452,8 +693,9 @@ list <T> ::list(list& rhs) :pHead(nullptr), pTail(nullptr), numElements(0)
  * LIST :: MOVE constructors
  * Steal the values from the RHS
  ****************************************/
-template <typename T>
-list <T> ::list(list <T>&& rhs): numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(list <T, A>&& rhs): numElements(0), pHead(nullptr), pTail(nullptr),
+   alloc(std::move(rhs.alloc))
 {
    pHead = rhs.pHead;
    pTail = rhs.pTail;
@@ -462,6 +704,28 @@ list <T> ::list(list <T>&& rhs): numElements(0), pHead(nullptr), pTail(nullptr)
     
    numElements = rhs.numElements;
    rhs.numElements = 0;
+
+   // the pool comes along with the nodes
+   stealPool(rhs);
+   pCompact = rhs.pCompact;
+   rhs.pCompact = nullptr;
+   pCompactNext = rhs.pCompactNext;
+   pCompactEnd = rhs.pCompactEnd;
+   rhs.pCompactNext = rhs.pCompactEnd = nullptr;
+
+   // and so do the nodes still waiting to go back to it
+   pDomain = rhs.pDomain;
+   pRetirement = rhs.pRetirement;
+   rhs.pDomain = nullptr;
+   rhs.pRetirement = nullptr;
+   pFinger = rhs.pFinger;
+   iFinger = rhs.iFinger;
+   rhs.forgetFinger();
+   copyOnWrite = rhs.copyOnWrite;
+   pShare = rhs.pShare;
+   rhs.pShare = nullptr;
+   leaked = rhs.leaked;
+   rhs.leaked = false;
 }
 
 /**********************************************
@@ -471,9 +735,16 @@ list <T> ::list(list <T>&& rhs): numElements(0), pHead(nullptr), pTail(nullptr)
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS 
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (list <T> && rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (list <T, A> && rhs)
 {
+   // our nodes go back to our allocator before we take the RHS's
+   clear();
+   endCompaction();
+   orphanRetirement();
+   releasePool();
+   alloc = std::move(rhs.alloc);
+
    pHead = rhs.pHead;
    pTail = rhs.pTail;
 
@@ -482,51 +753,96 @@ list <T>& list <T> :: operator = (list <T> && rhs)
    numElements = rhs.numElements;
    rhs.numElements = 0;
 
+   // the pool comes along with the nodes
+   stealPool(rhs);
+   pCompact = rhs.pCompact;
+   rhs.pCompact = nullptr;
+   pCompactNext = rhs.pCompactNext;
+   pCompactEnd = rhs.pCompactEnd;
+   rhs.pCompactNext = rhs.pCompactEnd = nullptr;
+   pDomain = rhs.pDomain;
+   pRetirement = rhs.pRetirement;
+   rhs.pDomain = nullptr;
+   rhs.pRetirement = nullptr;
+   pFinger = rhs.pFinger;
+   iFinger = rhs.iFinger;
+   rhs.forgetFinger();
+   copyOnWrite = rhs.copyOnWrite;
+   pShare = rhs.pShare;
+   rhs.pShare = nullptr;
+   leaked = rhs.leaked;
+   rhs.leaked = false;
+
    return *this;
 }
 
 /**********************************************
  * LIST :: assignment operator
- * Copy one list onto another
+ * Copy one list onto another, reusing the nodes
+ * already in this list.  Only the shortfall is
+ * allocated and only the surplus is freed.  If the
+ * RHS is in copy-on-write mode we let go of ours
+ * and share its nodes instead.
  *     INPUT  : a list to be copied
  *     OUTPUT :
- *     COST   : O(n) with respect to the number of nodes
+ *     COST   : O(n) with respect to the number of nodes,
+ *              O(our nodes) to share
  *********************************************/
-template <typename T>
-list <T> & list <T> :: operator = (list <T> & rhs)
+template <typename T, typename A>
+list <T, A> & list <T, A> :: operator = (list <T, A> & rhs)
 {
+   if (this == &rhs || (pShare && pShare == rhs.pShare))
+      return *this;
+   forgetFinger();
 
-   if (!rhs.pHead && !pHead)
+   if (canShare(rhs))
    {
+      clear();
+      shareWith(rhs);
       return *this;
    }
-   if (!rhs.pHead)
+
+   // nodes someone else still has are not ours to reuse
+   dropShare();
+
+   Node * pDes = pHead;
+   Node * pDesPrev = nullptr;
+   const Node * pSrc = rhs.pHead;
+
+   // copy the data into the nodes we already have
+   for (; pDes && pSrc; pSrc = pSrc->pNext)
    {
-      pHead = pTail = nullptr;
-      numElements = 0;
-      return *this;
+      pDes->data = pSrc->data;
+      pDesPrev = pDes;
+      pDes = pDes->pNext;
    }
 
-   pHead = new list::Node(rhs.pHead->data);
-   pTail = pHead;
-       
-   Node *currentHeadRhs = rhs.pHead->pNext;
-   Node *currentHead = pHead;
-       
-   for (;currentHeadRhs != 0; currentHeadRhs = currentHeadRhs->pNext)
+   // the source is bigger: add the nodes we are missing
+   for (; pSrc; pSrc = pSrc->pNext)
    {
-      Node* newNode = new list::Node(currentHeadRhs->data);
-
-      currentHead->pNext = newNode;
-      newNode->pPrev = currentHead;
-
-      pTail = newNode;
-      currentHead = currentHead->pNext;          
+      Node * pNew = createNode(pSrc->data);
+      pNew->pPrev = pDesPrev;
+      if (pDesPrev)
+         pDesPrev->pNext = pNew;
+      else
+         pHead = pNew;
+      pDesPrev = pNew;
    }
 
+   // the destination is bigger: free the extra nodes
+   while (pDes)
+   {
+      Node * pDelete = pDes;
+      pDes = pDes->pNext;
+      retireNode(pDelete);
+   }
 
-       
-   pHead->pPrev = pTail->pNext = nullptr;
+   // hook up the ends
+   pTail = pDesPrev;
+   if (pTail)
+      pTail->pNext = nullptr;
+   else
+      pHead = nullptr;
    numElements = rhs.numElements;
     
    return *this;
@@ -539,9 +855,11 @@ list <T> & list <T> :: operator = (list <T> & rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (const std::initializer_list<T>& rhs)
 {
+   unshare();
+   forgetFinger();
    if(rhs.begin())
    {
       if(numElements == rhs.size())
@@ -562,7 +880,7 @@ list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
 
       for(auto it = rhs.begin(); it != rhs.end(); ++it)
       {
-         Node* newNode = new list::Node(*it);
+         Node* newNode = createNode(*it);
                 
          if(!pHead)
          {
@@ -584,7 +902,7 @@ list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
    }
    else
    {
-      pHead = pTail = nullptr;
+      clear();
    }
  
    return *this;
@@ -595,13 +913,25 @@ list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
  * Remove all the items currently in the linked list
  *     INPUT  :
  *     OUTPUT :
- *     COST   : O(n) with respect to the number of nodes
+ *     COST   : O(n) with respect to the number of nodes,
+ *              O(1) if the nodes are shared
  *********************************************/
-template <typename T>
-void list <T> :: clear()
+template <typename T, typename A>
+void list <T, A> :: clear()
 {
+   // nodes someone else still has are left to them
+   dropShare();
+   while (pHead)
+   {
+      Node * pDelete = pHead;
+      pHead = pHead->pNext;
+      retireNode(pDelete);
+   }
+
    pHead = pTail = nullptr;
    numElements = 0;
+   forgetFinger();
+   leaked = false;
 }
 
 /*********************************************
@@ -611,10 +941,11 @@ void list <T> :: clear()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> :: push_back(const T & data)
+template <typename T, typename A>
+void list <T, A> :: push_back(const T & data)
 {
-   Node *newNode= new list:: Node(data);
+   unshare();
+   Node *newNode= createNode(data);
 
    if(!pHead)
    {
@@ -632,10 +963,11 @@ void list <T> :: push_back(const T & data)
    numElements++;
 }
 
-template <typename T>
-void list <T> ::push_back(T && data)
+template <typename T, typename A>
+void list <T, A> ::push_back(T && data)
 {
-   Node *newNode= new list:: Node(data);
+   unshare();
+   Node *newNode= createNode(std::move(data));
 
    if(!pHead)
    {
@@ -653,6 +985,33 @@ void list <T> ::push_back(T && data)
    numElements++;
 }
 
+/*********************************************
+ * LIST :: EMPLACE BACK
+ * build an item in place at the end of the list
+ *    INPUT  : the arguments to T's constructor
+ *    OUTPUT : the new item
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class ... Args>
+T & list <T, A> :: emplace_back(Args && ... args)
+{
+   leak();
+   Node * pNew = emplaceNode(std::forward<Args>(args)...);
+
+   if (!pHead)
+      pHead = pTail = pNew;
+   else
+   {
+      pTail->pNext = pNew;
+      pNew->pPrev = pTail;
+      pTail = pNew;
+   }
+
+   numElements++;
+   return pNew->data;
+}
+
 /*********************************************
  * LIST :: PUSH FRONT
  * add an item to the head of the list
@@ -660,10 +1019,11 @@ void list <T> ::push_back(T && data)
  *     OUTPUT :
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> :: push_front(const T & data)
+template <typename T, typename A>
+void list <T, A> :: push_front(const T & data)
 {
-   Node * newNode = new list:: Node(data);
+   unshare();
+   Node * newNode = createNode(data);
     
    if(!pHead)
    {
@@ -679,12 +1039,14 @@ void list <T> :: push_front(const T & data)
    }
     
    numElements++;
+   iFinger++;
 }
 
-template <typename T>
-void list <T> ::push_front(T && data)
+template <typename T, typename A>
+void list <T, A> ::push_front(T && data)
 {
-   Node * newNode = new list:: Node(data);
+   unshare();
+   Node * newNode = createNode(std::move(data));
     
    if(!pHead)
    {
@@ -700,9 +1062,38 @@ void list <T> ::push_front(T && data)
    }
     
    numElements++;
+   iFinger++;
 }
 
 
+/*********************************************
+ * LIST :: EMPLACE FRONT
+ * build an item in place at the head of the list
+ *    INPUT  : the arguments to T's constructor
+ *    OUTPUT : the new item
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class ... Args>
+T & list <T, A> :: emplace_front(Args && ... args)
+{
+   leak();
+   Node * pNew = emplaceNode(std::forward<Args>(args)...);
+
+   if (!pHead)
+      pHead = pTail = pNew;
+   else
+   {
+      pNew->pNext = pHead;
+      pHead->pPrev = pNew;
+      pHead = pNew;
+   }
+
+   numElements++;
+   iFinger++;
+   return pNew->data;
+}
+
 /*********************************************
  * LIST :: POP BACK
  * remove an item from the end of the list
@@ -710,17 +1101,23 @@ void list <T> ::push_front(T && data)
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_back()
+template <typename T, typename A>
+void list <T, A> ::pop_back()
 {
+   unshare();
    if(pTail)
    {
       Node *nodeToDelte = pTail;
+      if (pFinger == nodeToDelte)
+         forgetFinger();
       pTail = pTail->pPrev;
            
-      pTail->pNext = nullptr;
+      if (pTail)
+         pTail->pNext = nullptr;
+      else
+         pHead = nullptr;
     
-      delete nodeToDelte;
+      retireNode(nodeToDelte);
       numElements--;
    }
 }
@@ -732,17 +1129,25 @@ void list <T> ::pop_back()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_front()
+template <typename T, typename A>
+void list <T, A> ::pop_front()
 {
+   unshare();
    if(pHead)
    {
       Node *nodeToDelete = pHead;
+      if (pFinger == nodeToDelete)
+         forgetFinger();
+      else
+         iFinger--;
         
       pHead = pHead->pNext;
-      pHead->pPrev = nullptr;
+      if (pHead)
+         pHead->pPrev = nullptr;
+      else
+         pTail = nullptr;
         
-      delete nodeToDelete;
+      retireNode(nodeToDelete);
       numElements--;
    }
    else
@@ -753,68 +1158,461 @@ void list <T> ::pop_front()
 }
 
 /*********************************************
- * LIST :: FRONT
- * retrieves the first element in the list
- *     INPUT  : 
- *     OUTPUT : data to be displayed
- *     COST   : O(1)
+ * LIST :: FOR EACH
+ * call f on every element, front to back, while a
+ * runner walks distance nodes ahead prefetching the
+ * nodes we are about to visit.  Each hop the runner
+ * takes was itself prefetched a step earlier, so its
+ * misses overlap the work done in f.  A distance of
+ * zero is a plain traversal.
+ *     INPUT  : the function to call on each element
+ *              how many nodes ahead to prefetch
+ *     OUTPUT : the function, like std::for_each
+ *     COST   : O(n)
  *********************************************/
-template <typename T>
-T & list <T> :: front()
+template <typename T, typename A>
+template <class F>
+F list <T, A> :: for_each(F f, size_t distance)
 {
-   if (pHead)
-      return pHead->data;
-   else
-      throw("ERROR: unable to access data from an empty list");
+   unshare();
+   // send the runner out ahead
+   Node * pAhead = distance ? pHead : nullptr;
+   for (size_t i = 0; i < distance && pAhead; i++)
+   {
+      LIST_PREFETCH(pAhead);
+      pAhead = pAhead->pNext;
+   }
+   if (pAhead)
+      LIST_PREFETCH(pAhead);
+
+   // then keep it that far ahead
+   for (Node * p = pHead; p; p = p->pNext)
+   {
+      if (pAhead)
+      {
+         pAhead = pAhead->pNext;
+         if (pAhead)
+            LIST_PREFETCH(pAhead);
+      }
+      f(p->data);
+   }
+   return f;
 }
 
 /*********************************************
- * LIST :: BACK
- * retrieves the last element in the list
- *     INPUT  : 
- *     OUTPUT : data to be displayed
- *     COST   : O(1)
+ * LIST :: SORT
+ * a stable, bottom-up merge sort.  Runs of width
+ * 1, 2, 4, ... are merged by relinking pNext; no
+ * element is copied, moved or assigned and nothing
+ * is allocated.  The pPrev links and the tail are
+ * fixed up in one pass at the end.
+ *     INPUT  : the comparison, comp(a, b) is true if a goes before b
+ *     OUTPUT :
+ *     COST   : O(n log n) comparisons, O(1) extra space
  *********************************************/
-template <typename T>
-T & list <T> :: back()
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: sort(Compare comp)
 {
-   if (pTail)
-      return pTail->data;
-   else
-      throw("ERROR: unable to access data from an empty list");
-}
+   unshare();
+   if (numElements < 2)
+      return;
+   forgetFinger();
 
-/******************************************
- * LIST :: REMOVE
- * remove an item from the middle of the list
- *     INPUT  : an iterator to the item being removed
- *     OUTPUT : iterator to the new location 
- *     COST   : O(1)
- ******************************************/
-template <typename T>
-typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it)
-{
-   if (empty())
-   {
-      return nullptr;
-   }
-   else
+   for (size_t width = 1; ; width *= 2)
    {
-      Node* tempNode = it.p->pNext;
+      Node * pLeft = pHead;
+      Node * pMerged = nullptr;   // last node of the merged output
+      size_t numMerges = 0;
+      pHead = nullptr;
 
-      if (it.p->pNext)
-      {
-         it.p->pNext->pPrev = it.p->pPrev;
-         tempNode = it.p->pNext;
-      }
-      else
+      while (pLeft)
       {
-         pTail = pTail->pPrev;
-      }
+         numMerges++;
 
+         // the right run starts width nodes after the left run
+         Node * pRight = pLeft;
+         size_t numLeft = 0;
+         while (numLeft < width && pRight)
+         {
+            numLeft++;
+            pRight = pRight->pNext;
+         }
+         size_t numRight = width;
 
-      if (it.p->pPrev)
-      {
+         // merge the two runs, preferring the left on ties for stability
+         while (numLeft > 0 || (numRight > 0 && pRight))
+         {
+            Node * pTake;
+            if (numLeft == 0)
+            {
+               pTake = pRight;
+               pRight = pRight->pNext;
+               numRight--;
+            }
+            else if (numRight == 0 || !pRight || !comp(pRight->data, pLeft->data))
+            {
+               pTake = pLeft;
+               pLeft = pLeft->pNext;
+               numLeft--;
+            }
+            else
+            {
+               pTake = pRight;
+               pRight = pRight->pNext;
+               numRight--;
+            }
+
+            if (pMerged)
+               pMerged->pNext = pTake;
+            else
+               pHead = pTake;
+            pMerged = pTake;
+         }
+
+         pLeft = pRight;
+      }
+
+      pMerged->pNext = nullptr;
+      if (numMerges <= 1)
+         break;
+   }
+
+   // put the back links together
+   Node * pPrev = nullptr;
+   for (Node * p = pHead; p; p = p->pNext)
+   {
+      p->pPrev = pPrev;
+      pPrev = p;
+   }
+   pTail = pPrev;
+}
+
+/*********************************************
+ * LIST :: SPLICE
+ * move every node of the RHS in front of pos.  No
+ * element is copied or allocated; the nodes are
+ * simply relinked.  The RHS is left empty.  From
+ * now on the two lists share a pool, which is safe
+ * even if they are later used on different threads.
+ *     INPUT  : where the nodes go, the list they come from
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs)
+{
+   unshare();
+   rhs.unshare();
+   if (&rhs == this || rhs.empty())
+      return;
+
+   sharePool(rhs);
+   linkBefore(pos.p, rhs.pHead, rhs.pTail);
+   numElements += rhs.numElements;
+   forgetFinger();
+   leaked = leaked || rhs.leaked;
+
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+   rhs.pCompact = nullptr;
+   rhs.forgetFinger();
+}
+
+/*********************************************
+ * LIST :: SPLICE
+ * move the nodes [first, last) of the RHS in front
+ * of pos.  The RHS may be this list, in which case
+ * pos must not be inside the range.
+ *     INPUT  : where the nodes go, the list they come from,
+ *              and the range to move
+ *     OUTPUT :
+ *     COST   : O(1) within a list, O(last - first) between
+ *              lists to keep the sizes right
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs, iterator first, iterator last)
+{
+   unshare();
+   rhs.unshare();
+   if (first == last)
+      return;
+
+   Node * pFirst = first.p;
+   Node * pLast = last.p ? last.p->pPrev : rhs.pTail;
+   forgetFinger();
+   rhs.forgetFinger();
+
+   if (&rhs == this)
+   {
+      // already where it belongs
+      if (pos == last)
+         return;
+      unlink(pFirst, pLast);
+      linkBefore(pos.p, pFirst, pLast);
+      return;
+   }
+
+   size_t num = 1;
+   for (Node * p = pFirst; p != pLast; p = p->pNext)
+      num++;
+
+   sharePool(rhs);
+   rhs.unlink(pFirst, pLast);
+   rhs.numElements -= num;
+   rhs.pCompact = nullptr;
+   linkBefore(pos.p, pFirst, pLast);
+   numElements += num;
+   leaked = true;
+}
+
+/*********************************************
+ * LIST :: MERGE
+ * fold a sorted RHS into this sorted list by relinking.
+ * On ties our element comes first.  The RHS is left
+ * empty.
+ *     INPUT  : the list to merge, the comparison
+ *     OUTPUT :
+ *     COST   : O(n + m) comparisons
+ *********************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: merge(list <T, A> & rhs, Compare comp)
+{
+   unshare();
+   rhs.unshare();
+   if (&rhs == this || rhs.empty())
+      return;
+   if (empty())
+   {
+      splice(end(), rhs);
+      return;
+   }
+
+   sharePool(rhs);
+   forgetFinger();
+   rhs.forgetFinger();
+   leaked = leaked || rhs.leaked;
+   Node * pLeft = pHead;
+   Node * pRight = rhs.pHead;
+   Node * pMerged = nullptr;
+   while (pLeft && pRight)
+   {
+      Node * pTake;
+      if (comp(pRight->data, pLeft->data))
+      {
+         pTake = pRight;
+         pRight = pRight->pNext;
+      }
+      else
+      {
+         pTake = pLeft;
+         pLeft = pLeft->pNext;
+      }
+
+      pTake->pPrev = pMerged;
+      if (pMerged)
+         pMerged->pNext = pTake;
+      else
+         pHead = pTake;
+      pMerged = pTake;
+   }
+
+   // whatever is left of one side goes on the end
+   if (pLeft)
+   {
+      pMerged->pNext = pLeft;
+      pLeft->pPrev = pMerged;
+   }
+   else
+   {
+      pMerged->pNext = pRight;
+      pRight->pPrev = pMerged;
+      pTail = rhs.pTail;
+   }
+
+   numElements += rhs.numElements;
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+   rhs.pCompact = nullptr;
+}
+
+/*********************************************
+ * LIST :: SPLIT AT
+ * cut the list in two: we keep [begin, it) and the
+ * rest is returned as a new list.  The halves share
+ * a pool, but each may go to a thread of its own.
+ *     INPUT  : the first node of the new list
+ *     OUTPUT : the list holding [it, end)
+ *     COST   : O(min(k, n - k)) to count the halves
+ *********************************************/
+template <typename T, typename A>
+list <T, A> list <T, A> :: split_at(iterator it)
+{
+   unshare();
+   list <T, A> rhs(get_allocator());
+   if (it == end())
+      return rhs;
+
+   // count the shorter half by walking out from it in both directions
+   size_t numSteps = 0;
+   Node * pBack = it.p->pPrev;
+   Node * pFwd = it.p;
+   while (pBack && pFwd)
+   {
+      numSteps++;
+      pBack = pBack->pPrev;
+      pFwd = pFwd->pNext;
+   }
+   size_t num = pFwd ? numElements - numSteps : numSteps;
+
+   rhs.sharePool(*this);
+   rhs.leaked = true;
+   rhs.pHead = it.p;
+   rhs.pTail = pTail;
+   rhs.numElements = num;
+   pTail = it.p->pPrev;
+   if (pTail)
+      pTail->pNext = nullptr;
+   else
+      pHead = nullptr;
+   it.p->pPrev = nullptr;
+   numElements -= num;
+   pCompact = nullptr;
+   forgetFinger();
+
+   return rhs;
+}
+
+/*********************************************
+ * LIST :: FRONT
+ * retrieves the first element in the list
+ *     INPUT  : 
+ *     OUTPUT : data to be displayed
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+T & list <T, A> :: front()
+{
+   leak();
+   if (pHead)
+      return pHead->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * LIST :: BACK
+ * retrieves the last element in the list
+ *     INPUT  : 
+ *     OUTPUT : data to be displayed
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+T & list <T, A> :: back()
+{
+   leak();
+   if (pTail)
+      return pTail->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * LIST :: FRONT and BACK, constant version
+ * the same, but reading a shared list this way
+ * leaves it shared
+ *     INPUT  :
+ *     OUTPUT : data to be displayed
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+const T & list <T, A> :: front() const
+{
+   if (pHead)
+      return pHead->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+template <typename T, typename A>
+const T & list <T, A> :: back() const
+{
+   if (pTail)
+      return pTail->data;
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * LIST :: AT
+ * the element i places from the front
+ *     INPUT  : the index
+ *     OUTPUT : the element
+ *     COST   : O(1) near the ends or the last index
+ *              reached, O(n) at worst
+ *********************************************/
+template <typename T, typename A>
+T & list <T, A> :: at(size_t i)
+{
+   leak();
+   if (i >= numElements)
+      throw("ERROR: index out of range");
+   return locate(i)->data;
+}
+
+/*********************************************
+ * LIST :: ADVANCE
+ * the iterator i places from begin(), without
+ * walking from begin() every time
+ *     INPUT  : the index, up to size()
+ *     OUTPUT : an iterator on that element, or end()
+ *     COST   : as at()
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: advance(size_t i)
+{
+   leak();
+   if (i > numElements)
+      throw("ERROR: index out of range");
+   if (i == numElements)
+      return end();
+   return iterator(locate(i));
+}
+
+/******************************************
+ * LIST :: REMOVE
+ * remove an item from the middle of the list
+ *     INPUT  : an iterator to the item being removed
+ *     OUTPUT : iterator to the new location 
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+typename list <T, A> :: iterator  list <T, A> :: erase(const list <T, A> :: iterator & it)
+{
+   leak();
+   if (empty())
+   {
+      return nullptr;
+   }
+   else
+   {
+      Node* tempNode = it.p->pNext;
+      forgetFinger();
+
+      if (it.p->pNext)
+      {
+         it.p->pNext->pPrev = it.p->pPrev;
+         tempNode = it.p->pNext;
+      }
+      else
+      {
+         pTail = pTail->pPrev;
+      }
+
+
+      if (it.p->pPrev)
+      {
          it.p->pPrev->pNext = it.p->pNext;
       }
       else
@@ -823,7 +1621,7 @@ typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it
       }
 
 
-      delete it.p;
+      retireNode(it.p);
       numElements--;
       return tempNode;
    }
@@ -837,12 +1635,13 @@ typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it
  *     OUTPUT : iterator to the new item
  *     COST   : O(1)
  ******************************************/
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it, const T & data) 
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it, const T & data) 
 {
+   leak();
    if (empty())
    {
-      Node* pNew = new Node(data); // create new node.
+      Node* pNew = createNode(data); // create new node.
       pHead = pTail = pNew; // because the lsit is empty, this node is both the head andd tail.
       
       numElements++; // it is the only element in the node list.
@@ -850,7 +1649,7 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it, const
    }
    else if (it == end())
    {
-      Node* pNew = new Node(data);
+      Node* pNew = createNode(data);
        
       pTail->pNext = pNew; 
       pNew->pPrev = pTail; 
@@ -862,7 +1661,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it, const
    }
    else if (it == begin())
    {
-      Node* pNew = new Node(data);
+      iFinger++;
+      Node* pNew = createNode(data);
       pNew->pNext = pHead;
 
       pHead = pNew;
@@ -874,7 +1674,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it, const
    }
    else
    {
-      Node* pNew = new Node(data);
+      forgetFinger();
+      Node* pNew = createNode(data);
 
       pNew->pPrev = it.p->pPrev;
       pNew->pNext = it.p;
@@ -896,14 +1697,15 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it, const
    }
 }
 
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it,
    T && data)
 {
+   leak();
    // This is called If the list is empty
    if (empty())
    {
-      Node* pNew = new Node(data); // create new node.
+      Node* pNew = createNode(std::move(data)); // create new node.
       pHead = pTail = pNew; // because the lsit is empty, this node is both the head andd tail.
 
       numElements++; // it is the only element in the node list.
@@ -911,7 +1713,7 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
    }
    else if (it == end())
    {
-      Node* pNew = new Node(data);
+      Node* pNew = createNode(std::move(data));
 
       pTail->pNext = pNew; 
       pNew->pPrev = pTail; 
@@ -923,7 +1725,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
    }
    else if (it == begin())
    {
-      Node* pNew = new Node(data);  // Create  The New Node
+      iFinger++;
+      Node* pNew = createNode(std::move(data));  // Create  The New Node
       pNew->pNext = pHead; // Set the Next node for the New node to be the OLD head.
 
       pHead = pNew;  // Set the OLD Head to be the new node
@@ -934,7 +1737,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
    }
    else
    {
-      Node* pNew = new Node(data);
+      forgetFinger();
+      Node* pNew = createNode(std::move(data));
 
       pNew->pPrev = it.p->pPrev;
       pNew->pNext = it.p;
@@ -956,6 +1760,40 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
    }
 }
 
+/******************************************
+ * LIST :: EMPLACE
+ * build an item in place in the middle of the list
+ *     INPUT  : an iterator to the location where it is to be inserted
+ *              the arguments to T's constructor
+ *     OUTPUT : iterator to the new item
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+template <class ... Args>
+typename list <T, A> :: iterator list <T, A> :: emplace(iterator it, Args && ... args)
+{
+   leak();
+   if (it == end())
+   {
+      emplace_back(std::forward<Args>(args)...);
+      return iterator(pTail);
+   }
+
+   Node * pNew = emplaceNode(std::forward<Args>(args)...);
+   forgetFinger();
+
+   pNew->pNext = it.p;
+   pNew->pPrev = it.p->pPrev;
+   it.p->pPrev = pNew;
+   if (pNew->pPrev)
+      pNew->pPrev->pNext = pNew;
+   else
+      pHead = pNew;
+
+   numElements++;
+   return iterator(pNew);
+}
+
 /**********************************************
  * LIST :: assignment operator - MOVE
  * Copy one list onto another
@@ -963,8 +1801,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS
  *********************************************/
-template <typename T>
-void swap(list <T> & lhs, list <T> & rhs)
+template <typename T, typename A>
+void swap(list <T, A> & lhs, list <T, A> & rhs)
 {
    // Swap Head
    std::swap(lhs.pHead, rhs.pHead);
@@ -974,6 +1812,1194 @@ void swap(list <T> & lhs, list <T> & rhs)
    
    // Swap numElements
    std:: swap(lhs.numElements, rhs.numElements);
+
+   // Swap the allocators so each node goes back where it came from
+   std:: swap(lhs.alloc, rhs.alloc);
+
+   // Swap the pools along with the nodes carved from them.  A list
+   // using its own pool has to keep pointing at its own member.
+   bool lhsLocal = lhs.pPool == &lhs.local;
+   bool rhsLocal = rhs.pPool == &rhs.local;
+   std:: swap(lhs.local, rhs.local);
+   std:: swap(lhs.pPool, rhs.pPool);
+   if (lhsLocal)
+      rhs.pPool = &rhs.local;
+   if (rhsLocal)
+      lhs.pPool = &lhs.local;
+   std:: swap(lhs.pCompact, rhs.pCompact);
+   std:: swap(lhs.pCompactNext, rhs.pCompactNext);
+   std:: swap(lhs.pCompactEnd, rhs.pCompactEnd);
+   std:: swap(lhs.pDomain, rhs.pDomain);
+   std:: swap(lhs.pRetirement, rhs.pRetirement);
+   std:: swap(lhs.pFinger, rhs.pFinger);
+   std:: swap(lhs.iFinger, rhs.iFinger);
+   std:: swap(lhs.copyOnWrite, rhs.copyOnWrite);
+   std:: swap(lhs.pShare, rhs.pShare);
+   std:: swap(lhs.leaked, rhs.leaked);
+}
+
+/*********************************************
+ * LIST :: CREATE NODE
+ * take a node from the pool and construct it
+ *    INPUT  : data to be placed in the node, if any
+ *    OUTPUT : the new node, unattached
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: createNode()
+{
+   Node * p = allocateNode();
+   try
+   {
+      NodeTraits::construct(alloc, p);
+   }
+   catch (...)
+   {
+      releaseNode(p);
+      throw;
+   }
+   return p;
+}
+
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: createNode(const T & data)
+{
+   Node * p = allocateNode();
+   try
+   {
+      NodeTraits::construct(alloc, p, data);
+   }
+   catch (...)
+   {
+      releaseNode(p);
+      throw;
+   }
+   return p;
+}
+
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: createNode(T && data)
+{
+   Node * p = allocateNode();
+   try
+   {
+      NodeTraits::construct(alloc, p, std::move(data));
+   }
+   catch (...)
+   {
+      releaseNode(p);
+      throw;
+   }
+   return p;
+}
+
+template <typename T, typename A>
+template <class ... Args>
+typename list <T, A> :: Node * list <T, A> :: emplaceNode(Args && ... args)
+{
+   Node * p = allocateNode();
+   try
+   {
+      NodeTraits::construct(alloc, p, std::piecewise_construct,
+                            std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      releaseNode(p);
+      throw;
+   }
+   return p;
+}
+
+/*********************************************
+ * LIST :: DESTROY NODE
+ * destruct a node and put it on the free list
+ *    INPUT  : an unattached node
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: destroyNode(Node * p)
+{
+   // keep incremental compaction from resuming at a dead node
+   if (p == pCompact)
+      pCompact = p->pNext;
+
+   NodeTraits::destroy(alloc, p);
+   releaseNode(p);
+}
+
+/*********************************************
+ * LIST :: RETIRE NODE
+ * a node just taken out of the list.  Without a
+ * domain it is destroyed at once.  With one, a
+ * reader may still be on it, so it is handed to
+ * the domain and comes back to the pool once no
+ * hazard pointer guards it.
+ *    INPUT  : an unattached node
+ *    OUTPUT :
+ *    COST   : O(1) amortized
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: retireNode(Node * p)
+{
+   if (!pDomain)
+   {
+      destroyNode(p);
+      return;
+   }
+
+   if (p == pCompact)
+      pCompact = p->pNext;
+
+   if (!pRetirement)
+   {
+      heapPool();
+      Pool & pool = this->pool();
+      RetirementAlloc retirementAlloc(alloc);
+      pRetirement = RetirementTraits::allocate(retirementAlloc, 1);
+      ::new (static_cast<void *>(pRetirement)) Retirement{ alloc, &pool, 0, false, Spinlock() };
+      pool.numRefs++;
+   }
+
+   // the domain may reclaim nodes at once, so let go of the lock first
+   pRetirement->lock.lock();
+   pRetirement->numPending++;
+   pRetirement->lock.unlock();
+   pDomain->retire(p, reclaimNode, pRetirement);
+}
+
+/*********************************************
+ * LIST :: RECLAIM NODE
+ * the domain says nothing guards the node any more:
+ * destroy it and put it back on the free list.  The
+ * last node back after the list let go frees the
+ * retirement and its hold on the pool.
+ *    INPUT  : the node, its retirement
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: reclaimNode(void * p, void * context)
+{
+   Node * pNode = static_cast<Node *>(p);
+   Retirement * pRetirement = static_cast<Retirement *>(context);
+
+   NodeTraits::destroy(pRetirement->alloc, pNode);
+   pRetirement->lock.lock();
+   Pool & pool = lockShared(pRetirement->pPool, pRetirement->alloc);
+   pushFree(pool, pNode);
+   pool.lock.unlock();
+   bool last = --pRetirement->numPending == 0 && pRetirement->orphaned;
+   pRetirement->lock.unlock();
+
+   if (last)
+      freeRetirement(pRetirement);
+}
+
+/*********************************************
+ * LIST :: FREE RETIREMENT
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: freeRetirement(Retirement * pRetirement)
+{
+   NodeAlloc alloc(pRetirement->alloc);
+   unrefPool(pRetirement->pPool, alloc);
+   RetirementAlloc retirementAlloc(alloc);
+   pRetirement->~Retirement();
+   RetirementTraits::deallocate(retirementAlloc, pRetirement, 1);
+}
+
+/*********************************************
+ * LIST :: ORPHAN RETIREMENT
+ * the list is done retiring into this one.  If no
+ * nodes are still out, free it now; otherwise the
+ * last one back will.
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: orphanRetirement()
+{
+   if (!pRetirement)
+      return;
+   pRetirement->lock.lock();
+   bool idle = pRetirement->numPending == 0;
+   pRetirement->orphaned = true;
+   pRetirement->lock.unlock();
+   if (idle)
+      freeRetirement(pRetirement);
+   pRetirement = nullptr;
+}
+
+/*********************************************
+ * LIST :: RETIRE INTO
+ * from now on, hand the nodes that erase, pop_front,
+ * pop_back and clear take out of the list to a
+ * hazard domain rather than freeing them at once.
+ * A reader holding a hazard pointer to a node can
+ * then keep reading it after the list lets go.
+ *
+ * There is still just one thread changing the list.
+ * A node is reclaimed by whichever thread scans the
+ * retire list it is on: the one that erased it, or
+ * whoever destroys the domain.  NULL goes back to
+ * freeing nodes at once.
+ *    INPUT  : the domain, or NULL
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: retire_into(hazard_domain * pDomain)
+{
+   unshare();
+   orphanRetirement();
+   this->pDomain = pDomain;
+}
+
+/*********************************************
+ * LIST :: CAN SHARE
+ * whether a copy of the RHS can share its nodes.
+ * Not if something could still write to them through
+ * an iterator or reference the RHS handed out, not
+ * if hazard-guarded readers might still be on them
+ * after the RHS lets go, and not if we cannot give
+ * them back to the RHS's pool.
+ *    INPUT  : the list being copied
+ *    OUTPUT : true to share
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+bool list <T, A> :: canShare(const list <T, A> & rhs) const
+{
+   return rhs.copyOnWrite && !rhs.leaked && rhs.pHead && !rhs.pDomain &&
+          alloc == rhs.alloc;
+}
+
+/*********************************************
+ * LIST :: SHARE WITH
+ * take the RHS's nodes without copying them.  We
+ * share its pool as well, so whichever list is the
+ * last to hold a node can give it back.
+ *    INPUT  : the list being copied; we are empty
+ *    OUTPUT :
+ *    COST   : O(1), plus O(free nodes) the first time
+ *             the two pools meet
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: shareWith(list <T, A> & rhs)
+{
+   if (!rhs.pShare)
+   {
+      ShareAlloc shareAlloc(alloc);
+      rhs.pShare = ShareTraits::allocate(shareAlloc, 1);
+      ::new (static_cast<void *>(rhs.pShare)) Share{ 1 };
+   }
+   rhs.sharePool(*this);
+
+   pShare = rhs.pShare;
+   pShare->numRefs++;
+   pHead = rhs.pHead;
+   pTail = rhs.pTail;
+   numElements = rhs.numElements;
+}
+
+/*********************************************
+ * LIST :: DETACH
+ * we are about to change: if another list still
+ * shares our nodes, leave them to it and copy them
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(n) if still shared, else O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: detach()
+{
+   if (pShare->numRefs > 1)
+   {
+      Node * pNewHead = cloneChain();
+      Node * pNewTail = pNewHead;
+      while (pNewTail && pNewTail->pNext)
+         pNewTail = pNewTail->pNext;
+      pShare->numRefs--;
+      pShare = nullptr;
+      pHead = pNewHead;
+      pTail = pNewTail;
+      pCompact = nullptr;
+      forgetFinger();
+   }
+   else
+      freeShare();
+}
+
+/*********************************************
+ * LIST :: CLONE CHAIN
+ * a copy of our nodes, leaving ours alone.  Only
+ * a list of elements that can be copied ever shares
+ * them, so only such a list calls this.
+ *    INPUT  :
+ *    OUTPUT : the first of the new nodes
+ *    COST   : O(n)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: cloneChain()
+{
+   Node * pNewHead = nullptr;
+   Node * pNewTail = nullptr;
+   try
+   {
+      for (const Node * p = pHead; p; p = p->pNext)
+      {
+         Node * pNew = createNode(p->data);
+         pNew->pPrev = pNewTail;
+         if (pNewTail)
+            pNewTail->pNext = pNew;
+         else
+            pNewHead = pNew;
+         pNewTail = pNew;
+      }
+   }
+   catch (...)
+   {
+      while (pNewHead)
+      {
+         Node * pDelete = pNewHead;
+         pNewHead = pNewHead->pNext;
+         destroyNode(pDelete);
+      }
+      throw;
+   }
+   return pNewHead;
+}
+
+/*********************************************
+ * LIST :: DROP SHARE
+ * let go of our nodes if another list still shares
+ * them; if not, they are ours alone again
+ *    INPUT  :
+ *    OUTPUT : true if we let go and are now empty
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+bool list <T, A> :: dropShare()
+{
+   if (!pShare)
+      return false;
+   if (pShare->numRefs == 1)
+   {
+      freeShare();
+      return false;
+   }
+
+   pShare->numRefs--;
+   pShare = nullptr;
+   pHead = pTail = nullptr;
+   numElements = 0;
+   pCompact = nullptr;
+   forgetFinger();
+   return true;
+}
+
+/*********************************************
+ * LIST :: FREE SHARE
+ * the nodes are ours alone: we no longer need a count
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: freeShare()
+{
+   ShareAlloc shareAlloc(alloc);
+   ShareTraits::deallocate(shareAlloc, pShare, 1);
+   pShare = nullptr;
+}
+
+/*********************************************
+ * LIST :: UNLINK
+ * take a run of nodes out of the list.  The run
+ * keeps its inner links; the count is left alone.
+ *    INPUT  : the first and last nodes of the run
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: unlink(Node * pFirst, Node * pLast)
+{
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = pLast->pNext;
+   else
+      pHead = pLast->pNext;
+
+   if (pLast->pNext)
+      pLast->pNext->pPrev = pFirst->pPrev;
+   else
+      pTail = pFirst->pPrev;
+}
+
+/*********************************************
+ * LIST :: LOCATE
+ * the node at index i, walking from whichever of
+ * the head, the tail, or the finger is closest, in
+ * whichever direction that takes.  The finger then
+ * stays on it, so a run of nearby lookups each take
+ * a step or two.
+ *    INPUT  : the index, less than size()
+ *    OUTPUT : the node
+ *    COST   : O(distance to the closest starting point)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: locate(size_t i)
+{
+   Node * p = pHead;
+   size_t at = 0;
+   size_t distance = i;
+   if (numElements - 1 - i < distance)
+   {
+      p = pTail;
+      at = numElements - 1;
+      distance = numElements - 1 - i;
+   }
+   if (pFinger && (i > iFinger ? i - iFinger : iFinger - i) < distance)
+   {
+      p = pFinger;
+      at = iFinger;
+   }
+
+   for (; at < i; at++)
+      p = p->pNext;
+   for (; at > i; at--)
+      p = p->pPrev;
+
+   pFinger = p;
+   iFinger = i;
+   return p;
+}
+
+/*********************************************
+ * LIST :: LINK BEFORE
+ * put a run of nodes in front of pPos, or at the
+ * end if pPos is NULL.  The count is left alone.
+ *    INPUT  : where the run goes, its first and last nodes
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: linkBefore(Node * pPos, Node * pFirst, Node * pLast)
+{
+   Node * pPrev = pPos ? pPos->pPrev : pTail;
+   pFirst->pPrev = pPrev;
+   pLast->pNext = pPos;
+
+   if (pPrev)
+      pPrev->pNext = pFirst;
+   else
+      pHead = pFirst;
+
+   if (pPos)
+      pPos->pPrev = pLast;
+   else
+      pTail = pLast;
+}
+
+// the bounds on how many nodes a slab carved on demand holds
+template <typename T, typename A>
+const size_t list <T, A> :: SLAB_MIN;
+template <typename T, typename A>
+const size_t list <T, A> :: SLAB_MAX;
+
+/*************************************************
+ * POOL LOCK
+ * holds the lock of the pool a list draws from, for
+ * as long as it is in scope.  Each pool on the heap has
+ * a lock of its own, so only lists sharing that pool
+ * ever wait on one another.  A holder keeps it for a
+ * few instructions, so a waiter spins, yielding now
+ * and then.  A list on its own local pool never takes
+ * it.  Nothing is locked twice: the helpers below work
+ * on a pool the caller has already locked.
+ *************************************************/
+template <typename T, typename A>
+class list <T, A> :: PoolLock
+{
+public:
+   explicit PoolLock(list <T, A> & l) :
+      p(l.pPool == &l.local ? &l.local : &lockShared(l.pPool, l.alloc)),
+      shared(p != &l.local)
+   {
+   }
+  ~PoolLock()
+   {
+      if (shared)
+         p->lock.unlock();
+   }
+   PoolLock(const PoolLock &) = delete;
+   PoolLock & operator = (const PoolLock &) = delete;
+
+   Pool & pool() const { return *p; }
+
+private:
+   Pool * p;     // the pool we hold
+   bool shared;  // whether we locked it, and so unlock it
+};
+
+/*********************************************
+ * LIST :: LOCK SHARED
+ * lock the pool a reference leads to.  If it is merged
+ * into another while we wait, let go and follow it.
+ *    INPUT  : the reference, the allocator the pools came from
+ *    OUTPUT : the pool, locked
+ *    COST   : O(1) amortized
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Pool & list <T, A> :: lockShared(Pool * & pPool, NodeAlloc & alloc)
+{
+   for (;;)
+   {
+      Pool & pool = follow(pPool, alloc);
+      pool.lock.lock();
+      if (!pool.pForward.load(std::memory_order_relaxed))
+         return pool;
+      pool.lock.unlock();
+   }
+}
+
+/*********************************************
+ * LIST :: ALLOCATE NODE
+ * raw storage for one node, off the free list if
+ * possible.  Otherwise carve a new slab, each one
+ * about as big as everything we have so far.
+ *    INPUT  :
+ *    OUTPUT : an unconstructed node
+ *    COST   : O(1) amortized
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: allocateNode()
+{
+   PoolLock lock(*this);
+   Pool & pool = lock.pool();
+   if (!pool.pFree)
+   {
+      size_t num = numElements + pool.numFree;
+      num = num < SLAB_MIN ? SLAB_MIN : (num > SLAB_MAX ? SLAB_MAX : num);
+      threadSlab(pool, carveSlab(pool, alloc, num));
+   }
+
+   Node * p = pool.pFree;
+   pool.pFree = nextFree(p);
+   pool.numFree--;
+   return p;
+}
+
+/*********************************************
+ * LIST :: RELEASE NODE
+ * give the raw storage of a node back to the free list
+ *    INPUT  : an unconstructed node
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: releaseNode(Node * p)
+{
+   PoolLock lock(*this);
+   pushFree(lock.pool(), p);
+}
+
+/*********************************************
+ * LIST :: ALLOCATE SLAB
+ * allocate one block of nodes and add it to the pool.
+ * The nodes are left for the caller to hand out.
+ *    INPUT  : the number of nodes in the block
+ *    OUTPUT : the new block
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Slab * list <T, A> :: allocateSlab(size_t num)
+{
+   PoolLock lock(*this);
+   return carveSlab(lock.pool(), alloc, num);
+}
+
+/*********************************************
+ * LIST :: ADD SLAB
+ * allocate one block of nodes and thread them onto
+ * the free list, lowest address first
+ *    INPUT  : the number of nodes in the block
+ *    OUTPUT :
+ *    COST   : O(num)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: addSlab(size_t num)
+{
+   PoolLock lock(*this);
+   threadSlab(lock.pool(), carveSlab(lock.pool(), alloc, num));
+}
+
+/*********************************************
+ * LIST :: CARVE SLAB
+ * allocateSlab() on a pool the caller holds
+ *    INPUT  : the pool, its allocator, the number of nodes
+ *    OUTPUT : the new block
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Slab * list <T, A> :: carveSlab(Pool & pool, NodeAlloc & alloc, size_t num)
+{
+   static_assert(sizeof(Slab) <= sizeof(Node), "the slab header must fit in a node");
+
+   Node * pBlock = NodeTraits::allocate(alloc, num + 1);
+   Slab * pSlab = ::new (static_cast<void *>(pBlock)) Slab{ pool.pSlabs, num, 0 };
+   pool.pSlabs = pSlab;
+   return pSlab;
+}
+
+/*********************************************
+ * LIST :: THREAD SLAB
+ * put every node of a new slab on the free list of a
+ * pool the caller holds, lowest address first
+ *    INPUT  : the pool, the slab
+ *    OUTPUT :
+ *    COST   : O(nodes in the slab)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: threadSlab(Pool & pool, Slab * pSlab)
+{
+   for (Node * p = pSlab->end(); p != pSlab->begin(); )
+      pushFree(pool, --p);
+}
+
+/*********************************************
+ * LIST :: PUSH FREE
+ * releaseNode() on a pool the caller holds
+ *    INPUT  : the pool, an unconstructed node
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: pushFree(Pool & pool, Node * p)
+{
+   nextFree(p) = pool.pFree;
+   pool.pFree = p;
+   pool.numFree++;
+}
+
+/*********************************************
+ * LIST :: FREE SLABS
+ * return every block of a pool to the allocator.
+ * Only call this once all the nodes are back on
+ * the free list
+ *    INPUT  : the pool to empty
+ *    OUTPUT :
+ *    COST   : O(number of slabs)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: freeSlabs(Pool & pool, NodeAlloc & alloc)
+{
+   while (pool.pSlabs)
+   {
+      Slab * pDelete = pool.pSlabs;
+      pool.pSlabs = pool.pSlabs->pNext;
+      NodeTraits::deallocate(alloc, reinterpret_cast<Node *>(pDelete),
+                             pDelete->numNodes + 1);
+   }
+
+   pool.pFree = nullptr;
+   pool.numFree = 0;
+}
+
+/*********************************************
+ * LIST :: POOL
+ * the pool our nodes come from and go back to.  If
+ * it has been merged into another since we last
+ * looked, move our reference over to that one.
+ *    INPUT  :
+ *    OUTPUT : the pool
+ *    COST   : O(1) amortized
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Pool & list <T, A> :: pool()
+{
+   return follow(pPool, alloc);
+}
+
+template <typename T, typename A>
+const typename list <T, A> :: Pool & list <T, A> :: pool() const
+{
+   const Pool * p = pPool;
+   while (const Pool * pNext = p->pForward.load(std::memory_order_acquire))
+      p = pNext;
+   return *p;
+}
+
+/*********************************************
+ * LIST :: CAPACITY
+ * how many elements we could hold without going
+ * back to the allocator
+ *    INPUT  :
+ *    OUTPUT : our size plus the free nodes in our pool
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+size_t list <T, A> :: capacity() const
+{
+   if (pPool == &local)
+      return numElements + local.numFree;
+
+   // we cannot move our reference along, so look again if we lose a race
+   for (;;)
+   {
+      const Pool & pool = this->pool();
+      pool.lock.lock();
+      if (!pool.pForward.load(std::memory_order_relaxed))
+      {
+         size_t numFree = pool.numFree;
+         pool.lock.unlock();
+         return numElements + numFree;
+      }
+      pool.lock.unlock();
+   }
+}
+
+/*********************************************
+ * LIST :: FOLLOW
+ * move a reference to a pool along its forwarding
+ * pointers to the pool it ended up merged into
+ *    INPUT  : the reference, the allocator the pools came from
+ *    OUTPUT : the pool
+ *    COST   : O(1) amortized
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Pool & list <T, A> :: follow(Pool * & pPool, NodeAlloc & alloc)
+{
+   while (Pool * pNext = pPool->pForward.load(std::memory_order_acquire))
+   {
+      pNext->numRefs.fetch_add(1, std::memory_order_relaxed);
+      unrefPool(pPool, alloc);
+      pPool = pNext;
+   }
+   return *pPool;
+}
+
+/*********************************************
+ * LIST :: HEAP POOL
+ * a pool that something else holds on to must be
+ * able to outlive this list, so move it off our
+ * local one and onto the heap
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: heapPool()
+{
+   if (pPool != &local)
+      return;
+
+   PoolAlloc poolAlloc(alloc);
+   Pool * pShared = PoolTraits::allocate(poolAlloc, 1);
+   ::new (static_cast<void *>(pShared)) Pool(local);
+   pShared->numRefs = 1;
+   local = Pool();
+   pPool = pShared;
+}
+
+/*********************************************
+ * LIST :: SHARE POOL
+ * make this list and the RHS draw from the same pool
+ * so nodes can move between them.  The first time
+ * two lists meet, the smaller free list is walked
+ * to join the two; after that this is O(1).
+ *    INPUT  : the list we are about to trade nodes with
+ *    OUTPUT :
+ *    COST   : O(free nodes) the first time, O(1) after
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: sharePool(list <T, A> & rhs)
+{
+   assert(alloc == rhs.alloc);
+
+   // lock both pools, lower address first so two lists sharing
+   // with each other at once cannot deadlock.  If either was
+   // merged away while we waited, start over.
+   Pool * pDst;
+   Pool * pSrc;
+   for (;;)
+   {
+      pDst = &pool();
+      pSrc = &rhs.pool();
+      if (pDst == pSrc)
+         return;
+
+      // a shared pool must outlive both lists
+      if (pDst == &local)
+      {
+         heapPool();
+         continue;
+      }
+
+      bool srcFirst = std::less<Pool *>()(pSrc, pDst);
+      (srcFirst ? pSrc : pDst)->lock.lock();
+      (srcFirst ? pDst : pSrc)->lock.lock();
+      if (!pDst->pForward.load(std::memory_order_relaxed) &&
+          !pSrc->pForward.load(std::memory_order_relaxed))
+         break;
+      pSrc->lock.unlock();
+      pDst->lock.unlock();
+   }
+   Pool & dst = *pDst;
+   Pool & src = *pSrc;
+
+   // hand the RHS's slabs over
+   if (src.pSlabs)
+   {
+      Slab * pLast = src.pSlabs;
+      while (pLast->pNext)
+         pLast = pLast->pNext;
+      pLast->pNext = dst.pSlabs;
+      dst.pSlabs = src.pSlabs;
+   }
+
+   // and its free nodes, walking whichever free list is shorter
+   if (src.pFree && dst.pFree)
+   {
+      Pool & shorter = src.numFree < dst.numFree ? src : dst;
+      Pool & longer  = src.numFree < dst.numFree ? dst : src;
+      Node * pLast = shorter.pFree;
+      while (nextFree(pLast))
+         pLast = nextFree(pLast);
+      nextFree(pLast) = longer.pFree;
+      dst.pFree = shorter.pFree;
+   }
+   else if (src.pFree)
+      dst.pFree = src.pFree;
+   dst.numFree += src.numFree;
+   src.pFree  = nullptr;
+   src.pSlabs = nullptr;
+   src.numFree = 0;
+
+   // the RHS now uses ours.  If its pool was shared, any other
+   // list still holding it will follow pForward here.
+   dst.numRefs++;
+   bool forwarded = rhs.pPool != &rhs.local;
+   if (forwarded)
+      src.pForward.store(pDst, std::memory_order_release);
+   else
+      rhs.pPool = pDst;
+   src.lock.unlock();
+   dst.lock.unlock();
+   if (forwarded)
+      rhs.pool();
+}
+
+/*********************************************
+ * LIST :: STEAL POOL
+ * take the RHS's pool, leaving it with an empty one
+ *    INPUT  : the list being moved from
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: stealPool(list <T, A> & rhs)
+{
+   local = rhs.local;
+   pPool = rhs.pPool == &rhs.local ? &local : rhs.pPool;
+   rhs.local = Pool();
+   rhs.pPool = &rhs.local;
+}
+
+/*********************************************
+ * LIST :: RELEASE POOL
+ * let go of our pool, giving the slabs back if no
+ * one else uses it.  All our nodes must be freed.
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(number of slabs)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: releasePool()
+{
+   if (pPool == &local)
+      freeSlabs(local, alloc);
+   else
+   {
+      unrefPool(pPool, alloc);
+      pPool = &local;
+   }
+}
+
+/*********************************************
+ * LIST :: UNREF POOL
+ * drop one reference to a shared pool.  The last
+ * one out frees it, and with it the reference it
+ * held on the pool it was merged into.
+ *    INPUT  : a pool on the heap
+ *    OUTPUT :
+ *    COST   : O(number of slabs)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: unrefPool(Pool * p, NodeAlloc & alloc)
+{
+   PoolAlloc poolAlloc(alloc);
+   while (p && p->numRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+   {
+      Pool * pNext = p->pForward.load(std::memory_order_relaxed);
+      freeSlabs(*p, alloc);
+      p->~Pool();
+      PoolTraits::deallocate(poolAlloc, p, 1);
+      p = pNext;
+   }
+}
+
+/*********************************************
+ * LIST :: RESERVE
+ * make sure there is room for num elements without
+ * going back to the allocator.  The shortfall is
+ * carved out of a single block.
+ *    INPUT  : the number of elements to make room for
+ *    OUTPUT :
+ *    COST   : O(num)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: reserve(size_t num)
+{
+   PoolLock lock(*this);
+   Pool & pool = lock.pool();
+   size_t capacity = numElements + pool.numFree;
+   if (num > capacity)
+      threadSlab(pool, carveSlab(pool, alloc, num - capacity));
+}
+
+/*********************************************
+ * LIST :: SHRINK TO FIT
+ * give back to the allocator every slab whose nodes
+ * are all sitting on the free list
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(free nodes * log(number of slabs))
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: shrink_to_fit()
+{
+   // sort the slabs by address so a node's slab can be found quickly
+   std::less<const void *> lessThan;
+   std::vector<Slab *> slabs;
+   PoolLock lock(*this);
+   Pool & pool = lock.pool();
+   for (Slab * pSlab = pool.pSlabs; pSlab; pSlab = pSlab->pNext)
+   {
+      pSlab->numFree = 0;
+      slabs.push_back(pSlab);
+   }
+   std::sort(slabs.begin(), slabs.end(), lessThan);
+   auto slabOf = [&](Node * p) -> Slab *
+   {
+      auto it = std::upper_bound(slabs.begin(), slabs.end(), (const void *)p, lessThan);
+      if (it == slabs.begin())
+         return nullptr;
+      Slab * pSlab = *(it - 1);
+      return lessThan(p, pSlab->end()) ? pSlab : nullptr;
+   };
+
+   // count the free nodes in each slab
+   for (Node * p = pool.pFree; p; p = nextFree(p))
+      if (Slab * pSlab = slabOf(p))
+         pSlab->numFree++;
+
+   // pull the nodes of the completely free slabs off the free list
+   for (Node ** pp = &pool.pFree; *pp; )
+   {
+      Slab * pSlab = slabOf(*pp);
+      if (pSlab && pSlab->numFree == pSlab->numNodes)
+      {
+         *pp = nextFree(*pp);
+         pool.numFree--;
+      }
+      else
+         pp = &nextFree(*pp);
+   }
+
+   // and hand those slabs back
+   for (Slab ** pp = &pool.pSlabs; *pp; )
+   {
+      Slab * pSlab = *pp;
+      if (pSlab->numFree == pSlab->numNodes)
+      {
+         *pp = pSlab->pNext;
+         NodeTraits::deallocate(alloc, reinterpret_cast<Node *>(pSlab),
+                                pSlab->numNodes + 1);
+      }
+      else
+         pp = &pSlab->pNext;
+   }
+}
+
+/*********************************************
+ * LIST :: FRAGMENTATION
+ * how scattered the nodes are: the fraction of links
+ * that do not lead to the very next node in memory.
+ * 0.0 is a freshly built or compacted list; near 1.0
+ * every hop is likely a cache miss.
+ *    INPUT  :
+ *    OUTPUT : a value between 0.0 and 1.0
+ *    COST   : O(n)
+ *********************************************/
+template <typename T, typename A>
+double list <T, A> :: fragmentation() const
+{
+   if (numElements < 2)
+      return 0.0;
+
+   size_t numJumps = 0;
+   for (const Node * p = pHead; p->pNext; p = p->pNext)
+      if (p->pNext != p + 1)
+         numJumps++;
+   return (double)numJumps / (double)(numElements - 1);
+}
+
+/*********************************************
+ * LIST :: COMPACT
+ * move every node into one fresh block, in list order,
+ * then give the old blocks back to the allocator.  A
+ * block holding a node still out in a hazard domain
+ * is kept until a later shrink_to_fit().  Every
+ * element moves, so every iterator and reference
+ * into the list is invalidated.
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(n)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: compact()
+{
+   unshare();
+   pCompact = nullptr;
+   endCompaction();
+   if (pHead)
+      relocate(pHead, numElements, allocateSlab(numElements)->begin());
+   shrink_to_fit();
+}
+
+/*********************************************
+ * LIST :: COMPACT STEP
+ * incremental compaction: move at most budget nodes,
+ * starting where the last step left off.  A pass
+ * carves one block for the whole list when it starts
+ * and each step fills the next slots, so a finished
+ * pass leaves the list as contiguous as compact()
+ * would.  Once the pass reaches the end of the list
+ * the emptied blocks are given back.  Iterators and
+ * references to the elements a step moves are
+ * invalidated, so hold none across a step.
+ *    INPUT  : the most nodes to move in this step
+ *    OUTPUT : true if this step finished the pass
+ *    COST   : O(budget), O(n) at the start and end of a pass
+ *********************************************/
+template <typename T, typename A>
+bool list <T, A> :: compact_step(size_t budget)
+{
+   unshare();
+
+   // a new pass: one block for everything
+   if (!pCompactEnd && pHead)
+   {
+      Slab * pSlab = allocateSlab(numElements);
+      pCompactNext = pSlab->begin();
+      pCompactEnd = pSlab->end();
+      pCompact = pHead;
+   }
+
+   // count how much of the list this step will cover
+   size_t num = 0;
+   for (Node * p = pCompact; p && num < budget; p = p->pNext)
+      num++;
+
+   // the list grew since the pass began: a block for the rest
+   if (num > (size_t)(pCompactEnd - pCompactNext))
+   {
+      size_t numRest = 0;
+      for (Node * p = pCompact; p; p = p->pNext)
+         numRest++;
+      endCompaction();
+      Slab * pSlab = allocateSlab(numRest);
+      pCompactNext = pSlab->begin();
+      pCompactEnd = pSlab->end();
+   }
+
+   if (num)
+   {
+      pCompact = relocate(pCompact, num, pCompactNext);
+      pCompactNext += num;
+   }
+
+   if (pCompact)
+      return false;
+
+   endCompaction();
+   shrink_to_fit();
+   return true;
+}
+
+/*********************************************
+ * LIST :: END COMPACTION
+ * finish or abandon a pass of compact_step(): the
+ * slots it did not fill go on the free list
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(unfilled slots)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: endCompaction()
+{
+   for (Node * p = pCompactNext; p != pCompactEnd; p++)
+      releaseNode(p);
+   pCompactNext = pCompactEnd = nullptr;
+}
+
+/*********************************************
+ * LIST :: RELOCATE
+ * move a run of nodes into consecutive slots of a
+ * block, relinking the list around them.  The old
+ * nodes are retired like erased ones.  With a domain
+ * a reader may still be on one, so its data is
+ * copied rather than moved out from under it, if T
+ * can be copied at all.
+ *    INPUT  : the first node of the run
+ *             the number of nodes in the run
+ *             the first of num unused slots in a block
+ *    OUTPUT : the node following the run
+ *    COST   : O(num)
+ *********************************************/
+template <typename T, typename A>
+typename list <T, A> :: Node * list <T, A> :: relocate(Node * pFirst, size_t num, Node * pDest)
+{
+   forgetFinger();
+
+   Node * pPrev = pFirst->pPrev;
+   Node * pOld = pFirst;
+   Node * pNew = pDest;
+   for (size_t i = 0; i < num; i++, pNew++)
+   {
+      if (pDomain)
+         relocateData(pNew, pOld->data, std::is_copy_constructible<T>());
+      else
+         NodeTraits::construct(alloc, pNew, std::move(pOld->data));
+      pNew->pPrev = pPrev;
+      if (pPrev)
+         pPrev->pNext = pNew;
+      else
+         pHead = pNew;
+      pPrev = pNew;
+
+      Node * pNext = pOld->pNext;
+      retireNode(pOld);
+      pOld = pNext;
+   }
+
+   pPrev->pNext = pOld;
+   if (pOld)
+      pOld->pPrev = pPrev;
+   else
+      pTail = pPrev;
+   return pOld;
 }
 
 
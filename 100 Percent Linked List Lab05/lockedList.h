@@ -0,0 +1,394 @@
+/***********************************************************************
+ * Header:
+ *    LOCKED LIST
+ * Summary:
+ *    A singly linked list that any number of threads can use at once,
+ *    built from ordinary locks rather than lock-free tricks.  Every
+ *    node has its own spinlock and a traversal couples them hand over
+ *    hand: it locks the next node before letting go of the one it is
+ *    on.  Threads working on different stretches of a long list then
+ *    never wait for each other.
+ *
+ *    Because every thread takes the locks from the front to the back,
+ *    no two can deadlock.  Because no thread can reach a node without
+ *    holding the lock of the one before it, a node is never freed
+ *    while someone is waiting on it.
+ *
+ *    This will contain the class definition of:
+ *        locked_list           : A class that represents a locked list
+ *        locked_list::iterator : A cursor that holds the locks it is on
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <thread>      // for std::this_thread::yield
+#include <utility>     // for std::move
+
+class TestLockedList;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * LOCKED LIST
+ * Every member but the destructor is safe to call
+ * from any number of threads at once.  An iterator
+ * holds the locks of the element it is on and the
+ * one before it, so a thread must let go of its
+ * iterators before it calls anything else on the
+ * same list, or it will wait on itself.
+ **************************************************/
+template <typename T>
+class locked_list
+{
+   friend class ::TestLockedList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   locked_list() : numElements(0) { head.pNext = nullptr; }
+   locked_list(const locked_list &) = delete;
+   locked_list & operator = (const locked_list &) = delete;
+  ~locked_list();
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin();
+   iterator end() { return iterator(); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & data);
+
+   //
+   // Insert
+   //
+
+   void push_front(const T & data);
+   void push_back(const T & data);
+   iterator insert(iterator it, const T & data);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it);
+
+   //
+   // Status
+   //
+
+   size_t size() const { return numElements.load(std::memory_order_relaxed); }
+   bool empty()  const { return size() == 0; }
+
+private:
+   class Spinlock;
+   class Link;
+   class Node;
+
+   // member variables
+   Link head;                        // the sentinel before the first node
+   std::atomic<size_t> numElements;  // nodes linked after the sentinel
+};
+
+/*************************************************
+ * SPINLOCK
+ * a flag to test and set.  A holder only ever
+ * keeps it for a few instructions, so spinning is
+ * cheaper than sleeping; a waiter yields now and
+ * then in case the holder was preempted.
+ *************************************************/
+template <typename T>
+class locked_list <T> :: Spinlock
+{
+public:
+   Spinlock() : locked(false) {}
+
+   void lock()
+   {
+      for (int spins = 1; locked.exchange(true, std::memory_order_acquire); spins++)
+         while (locked.load(std::memory_order_relaxed))
+            if (spins++ % 64 == 0)
+               std::this_thread::yield();
+   }
+
+   void unlock()
+   {
+      locked.store(false, std::memory_order_release);
+   }
+
+   bool isLocked() const { return locked.load(std::memory_order_relaxed); }
+
+private:
+   std::atomic<bool> locked;
+};
+
+/*************************************************
+ * LINK
+ * what the sentinel and every node have: a lock
+ * and the pointer to the next node it guards
+ *************************************************/
+template <typename T>
+class locked_list <T> :: Link
+{
+public:
+   Link() : pNext(nullptr) {}
+
+   Spinlock lock;
+   Node * pNext;
+};
+
+/*************************************************
+ * NODE
+ * a link with an element in it
+ *************************************************/
+template <typename T>
+class locked_list <T> :: Node : public Link
+{
+public:
+   Node(const T & data) : data(data) {}
+
+   T data;
+};
+
+/**************************************************
+ * LOCKED LIST ITERATOR
+ * A window of two locked links: the element it is
+ * on and the link before it, which is what insert
+ * and erase need to relink around it.  It can be
+ * moved but not copied, and lets go of its locks
+ * when it is destroyed.  At the end, pCurr is NULL
+ * and pPrev is the last node, if there was a walk.
+ **************************************************/
+template <typename T>
+class locked_list <T> :: iterator
+{
+   friend class locked_list <T>;
+   friend class ::TestLockedList;
+public:
+   // constructors, destructors, and assignment operator
+   iterator() : pPrev(nullptr), pCurr(nullptr) {}
+   iterator(iterator && rhs) : pPrev(rhs.pPrev), pCurr(rhs.pCurr)
+   {
+      rhs.pPrev = nullptr;
+      rhs.pCurr = nullptr;
+   }
+   iterator(const iterator &) = delete;
+   iterator & operator = (iterator && rhs)
+   {
+      if (this != &rhs)
+      {
+         release();
+         pPrev = rhs.pPrev;
+         pCurr = rhs.pCurr;
+         rhs.pPrev = nullptr;
+         rhs.pCurr = nullptr;
+      }
+      return *this;
+   }
+   iterator & operator = (const iterator &) = delete;
+  ~iterator() { release(); }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return pCurr == rhs.pCurr; }
+   bool operator != (const iterator & rhs) const { return pCurr != rhs.pCurr; }
+
+   // dereference operator
+   T & operator * () { return pCurr->data; }
+
+   // prefix increment: lock the next node, then let go of the
+   // one behind us.  Walking off the end keeps the last node.
+   iterator & operator ++ ()
+   {
+      if (pCurr)
+      {
+         Node * pNext = pCurr->pNext;
+         if (pNext)
+            pNext->lock.lock();
+         pPrev->lock.unlock();
+         pPrev = pCurr;
+         pCurr = pNext;
+      }
+      return *this;
+   }
+
+   // let go of both locks early
+   void release()
+   {
+      if (pCurr)
+         pCurr->lock.unlock();
+      if (pPrev)
+         pPrev->lock.unlock();
+      pPrev = nullptr;
+      pCurr = nullptr;
+   }
+
+private:
+   // take over a window whose links are already locked
+   iterator(Link * pPrev, Node * pCurr) : pPrev(pPrev), pCurr(pCurr) {}
+
+   Link * pPrev;
+   Node * pCurr;
+};
+
+/*****************************************
+ * LOCKED LIST :: DESTRUCTOR
+ * no thread may be using the list, so there
+ * is nothing to lock
+ ****************************************/
+template <typename T>
+locked_list <T> :: ~locked_list()
+{
+   Node * p = head.pNext;
+   while (p)
+   {
+      Node * pDelete = p;
+      p = p->pNext;
+      delete pDelete;
+   }
+}
+
+/*********************************************
+ * LOCKED LIST :: BEGIN
+ * lock the sentinel, then the first node
+ *    INPUT  :
+ *    OUTPUT : an iterator on the first element
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+typename locked_list <T> :: iterator locked_list <T> :: begin()
+{
+   head.lock.lock();
+   Node * pFirst = head.pNext;
+   if (pFirst)
+      pFirst->lock.lock();
+   return iterator(&head, pFirst);
+}
+
+/*********************************************
+ * LOCKED LIST :: FIND
+ * walk hand over hand until we reach the element
+ *    INPUT  : the element to look for
+ *    OUTPUT : an iterator on the first match, or end()
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+typename locked_list <T> :: iterator locked_list <T> :: find(const T & data)
+{
+   iterator it = begin();
+   while (it.pCurr && !(it.pCurr->data == data))
+      ++it;
+   if (!it.pCurr)
+      it.release();
+   return it;
+}
+
+/*********************************************
+ * LOCKED LIST :: PUSH FRONT
+ * only the sentinel needs to be locked: the first
+ * node cannot be erased without it
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+void locked_list <T> :: push_front(const T & data)
+{
+   Node * pNew = new Node(data);
+   head.lock.lock();
+   pNew->pNext = head.pNext;
+   head.pNext = pNew;
+   numElements.fetch_add(1, std::memory_order_relaxed);
+   head.lock.unlock();
+}
+
+/*********************************************
+ * LOCKED LIST :: PUSH BACK
+ * walk to the end and link on after the last node,
+ * which the walk leaves locked
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+void locked_list <T> :: push_back(const T & data)
+{
+   Node * pNew = new Node(data);
+   iterator it = begin();
+   while (it.pCurr)
+      ++it;
+   it.pPrev->pNext = pNew;
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************
+ * LOCKED LIST :: INSERT
+ * add an element before the one the iterator is
+ * on, or at the back if it is at the end
+ *    INPUT  : where to insert, data to be added
+ *    OUTPUT : an iterator on the new element
+ *    COST   : O(1) given the iterator
+ *********************************************/
+template <typename T>
+typename locked_list <T> :: iterator locked_list <T> :: insert(iterator it, const T & data)
+{
+   // an end() that never walked holds nothing: walk there now
+   if (!it.pPrev)
+   {
+      it = begin();
+      while (it.pCurr)
+         ++it;
+   }
+
+   Node * pNew = new Node(data);
+   pNew->lock.lock();   // nobody else can see it yet
+   pNew->pNext = it.pCurr;
+   it.pPrev->pNext = pNew;
+   numElements.fetch_add(1, std::memory_order_relaxed);
+
+   // the window slides back onto the new node
+   if (it.pCurr)
+      it.pCurr->lock.unlock();
+   it.pCurr = pNew;
+   return it;
+}
+
+/*********************************************
+ * LOCKED LIST :: ERASE
+ * unlink the element the iterator is on.  Anyone
+ * who wanted it would first need the lock on the
+ * node before it, which we hold, so it is safe to
+ * free the moment it is unlinked.
+ *    INPUT  : an iterator on the element to remove
+ *    OUTPUT : an iterator on the element after it
+ *    COST   : O(1) given the iterator
+ *********************************************/
+template <typename T>
+typename locked_list <T> :: iterator locked_list <T> :: erase(iterator it)
+{
+   if (!it.pCurr)
+      return it;
+
+   Node * pDelete = it.pCurr;
+   Node * pNext = pDelete->pNext;
+   if (pNext)
+      pNext->lock.lock();
+   it.pPrev->pNext = pNext;
+   it.pCurr = pNext;
+   numElements.fetch_sub(1, std::memory_order_relaxed);
+
+   pDelete->lock.unlock();
+   delete pDelete;
+   return it;
+}
+
+}; // namespace custom
@@ -0,0 +1,202 @@
+/***********************************************************************
+ * Header:
+ *    LRU CACHE
+ * Summary:
+ *    A fixed-capacity cache that forgets the least recently used entry
+ *    first.  The entries sit on a custom::list from most to least
+ *    recently used, and a custom::unordered_map finds an entry's node
+ *    by key.  A hit relinks that node to the front; it is not erased
+ *    and put back.  A miss on a full cache overwrites the node at the
+ *    back and relinks it to the front, so once the cache has filled
+ *    up the list never allocates or frees a node again.
+ *
+ *    A cache is for one thread at a time.  The index's buckets share a
+ *    pool, so a miss, which erases one key from the index and inserts
+ *    another, takes that pool's lock.
+ *
+ *    This will contain the class definition of:
+ *        lru_cache : A class that represents an LRU cache
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cstddef>     // for size_t
+#include <utility>     // for std::pair
+#include "list.h"      // for the recency order
+#include "hash.h"      // for the index
+
+class TestLruCache;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * LRU CACHE
+ * Holds at most capacity() key-value pairs.  Both
+ * get() and put() make the key the most recently
+ * used; contains() does not.
+ **************************************************/
+template <typename K, typename V, typename Hash = std::hash<K>>
+class lru_cache
+{
+   friend class ::TestLruCache; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   explicit lru_cache(size_t capacity);
+   lru_cache(const lru_cache &) = delete;
+   lru_cache & operator = (const lru_cache &) = delete;
+
+   //
+   // Access
+   //
+
+   V * get(const K & key);
+   bool contains(const K & key) { return index.count(key) != 0; }
+
+   //
+   // Insert and remove
+   //
+
+   void put(const K & key, const V & value);
+   bool erase(const K & key);
+   void clear();
+
+   //
+   // Status
+   //
+
+   size_t size() const     { return entries.size(); }
+   size_t capacity() const { return maxEntries;     }
+   bool empty() const      { return entries.empty(); }
+
+private:
+   typedef std::pair<K, V> Entry;
+   typedef typename list<Entry>::iterator Position;
+
+   void touch(Position it);
+
+   // member variables
+   list<Entry> entries;                         // most recently used first
+   unordered_map<K, Position, Hash> index;      // where each key's entry is
+   size_t maxEntries;
+};
+
+/*****************************************
+ * LRU CACHE :: CONSTRUCTOR
+ * every node and bucket the cache will ever
+ * need is made up front
+ ****************************************/
+template <typename K, typename V, typename Hash>
+lru_cache <K, V, Hash> :: lru_cache(size_t capacity) : maxEntries(capacity)
+{
+   entries.reserve(capacity);
+   index.reserve(capacity);
+}
+
+/*********************************************
+ * LRU CACHE :: GET
+ * look up a key, making it the most recently used
+ *    INPUT  : the key
+ *    OUTPUT : its value, or NULL on a miss.  Good until
+ *             the entry is evicted or erased.
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+V * lru_cache <K, V, Hash> :: get(const K & key)
+{
+   auto it = index.find(key);
+   if (it == index.end())
+      return nullptr;
+   touch(it->second);
+   return &(*it->second).second;
+}
+
+/*********************************************
+ * LRU CACHE :: PUT
+ * set a key's value, making it the most recently
+ * used.  A new key on a full cache takes over the
+ * least recently used entry's node.
+ *    INPUT  : the key and its value
+ *    OUTPUT :
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lru_cache <K, V, Hash> :: put(const K & key, const V & value)
+{
+   if (maxEntries == 0)
+      return;
+
+   auto it = index.find(key);
+   if (it != index.end())
+   {
+      (*it->second).second = value;
+      touch(it->second);
+      return;
+   }
+
+   if (entries.size() < maxEntries)
+   {
+      entries.push_front(Entry(key, value));
+      index.insert(std::make_pair(key, entries.begin()));
+      return;
+   }
+
+   // recycle the back node for the new entry
+   Position itBack = entries.rbegin();
+   index.erase((*itBack).first);
+   (*itBack).first = key;
+   (*itBack).second = value;
+   touch(itBack);
+   index.insert(std::make_pair(key, itBack));
+}
+
+/*********************************************
+ * LRU CACHE :: ERASE
+ *    INPUT  : the key to forget
+ *    OUTPUT : whether it was there
+ *    COST   : O(1) expected
+ *********************************************/
+template <typename K, typename V, typename Hash>
+bool lru_cache <K, V, Hash> :: erase(const K & key)
+{
+   auto it = index.find(key);
+   if (it == index.end())
+      return false;
+   entries.erase(it->second);
+   index.erase(it);
+   return true;
+}
+
+/*********************************************
+ * LRU CACHE :: CLEAR
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lru_cache <K, V, Hash> :: clear()
+{
+   entries.clear();
+   index.clear();
+}
+
+/*********************************************
+ * LRU CACHE :: TOUCH
+ * relink a node to the front of the list.  Its
+ * iterator, and so the index, stays good.
+ *    INPUT  : the node
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename K, typename V, typename Hash>
+void lru_cache <K, V, Hash> :: touch(Position it)
+{
+   if (it == entries.begin())
+      return;
+   Position itNext = it;
+   ++itNext;
+   entries.splice(entries.begin(), entries, it, itNext);
+}
+
+}; // namespace custom
@@ -0,0 +1,363 @@
+/***********************************************************************
+ * Header:
+ *    MAGAZINE
+ * Summary:
+ *    A thread-local cache of small blocks in front of operator new.
+ *    Each thread keeps, for every size class, two "magazines": small
+ *    stacks of free blocks it can pop and push without any locking.
+ *    Only when both are empty (or both full) does it go to the
+ *    depot, a shared pool of whole magazines behind a mutex, and then
+ *    it trades a full magazine at a time.  A block freed by a thread
+ *    other than the one that allocated it simply goes into the
+ *    freeing thread's magazine and finds its way back via the depot.
+ *
+ *    This will contain the class definition of:
+ *        magazine_cache     : The per-thread magazines and the depots
+ *        magazine_allocator : An allocator that draws on the cache
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cstddef>     // for size_t and std::max_align_t
+#include <mutex>       // for std::mutex
+#include <new>         // for operator new
+#include <utility>     // for std::swap
+
+class TestMagazine;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * MAGAZINE CACHE
+ * Blocks are rounded up to a multiple of GRAIN
+ * bytes; every size up to GRAIN * CLASSES has its
+ * own magazines and depot.  Anything bigger, or
+ * more strictly aligned than operator new already
+ * guarantees, goes straight to operator new.
+ **************************************************/
+class magazine_cache
+{
+   friend class ::TestMagazine;
+public:
+   enum { GRAIN   = 16 };   // bytes between size classes
+   enum { CLASSES = 64 };   // so blocks up to 1K are cached
+   enum { ROUNDS  = 32 };   // blocks per magazine
+   enum { DEPTH   = 64 };   // full magazines a depot keeps before freeing
+
+   static void * allocate(size_t size);
+   static void deallocate(void * p, size_t size);
+
+   // is a block of this size and alignment served from the cache?
+   static bool cached(size_t size, size_t align)
+   {
+      return size <= GRAIN * CLASSES && align <= alignof(std::max_align_t);
+   }
+
+private:
+   // a stack of up to ROUNDS free blocks
+   struct Magazine
+   {
+      size_t num;
+      void * rounds[ROUNDS];
+      Magazine * pNext;   // in the depot only
+   };
+
+   // the magazines of one size class that no thread holds
+   struct Depot
+   {
+      std::mutex lock;
+      Magazine * pFull = nullptr;
+      Magazine * pEmpty = nullptr;
+      size_t numFull = 0;
+     ~Depot();
+   };
+   static Depot & depot(size_t c)
+   {
+      static Depot depots[CLASSES];
+      return depots[c];
+   }
+
+   // one thread's two magazines of one size class.  Allocation and
+   // free work on pLoaded; pPrevious is the spare that lets a thread
+   // flip back and forth at a magazine boundary without the depot.
+   struct Cache
+   {
+      Magazine * pLoaded = nullptr;
+      Magazine * pPrevious = nullptr;
+   };
+
+   // this thread's caches, handed back to the depots when it exits
+   struct Owner
+   {
+      Cache caches[CLASSES];
+     ~Owner();
+   };
+   static Owner & owner()
+   {
+      static thread_local Owner o;
+      return o;
+   }
+
+   static size_t sizeClass(size_t size) { return size ? (size - 1) / GRAIN : 0; }
+   static void * refill(size_t c, Cache & cache);
+   static void spill(size_t c, Cache & cache);
+   static Magazine * newMagazine();
+   static void freeRounds(Magazine * p);
+};
+
+/**************************************************
+ * MAGAZINE ALLOCATOR
+ * Use it as the allocator of any container: single
+ * small objects and small arrays come from the
+ * calling thread's magazines; anything else from
+ * operator new.
+ **************************************************/
+template <typename T>
+struct magazine_allocator
+{
+   typedef T value_type;
+
+   magazine_allocator() {}
+   template <typename U>
+   magazine_allocator(const magazine_allocator<U> &) {}
+
+   T * allocate(size_t n)
+   {
+      if (magazine_cache::cached(n * sizeof(T), alignof(T)))
+         return static_cast<T *>(magazine_cache::allocate(n * sizeof(T)));
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+   }
+
+   void deallocate(T * p, size_t n)
+   {
+      if (magazine_cache::cached(n * sizeof(T), alignof(T)))
+         magazine_cache::deallocate(p, n * sizeof(T));
+      else
+         ::operator delete(p);
+   }
+
+   // every instance draws on the same cache
+   template <typename U>
+   bool operator == (const magazine_allocator<U> &) const { return true; }
+   template <typename U>
+   bool operator != (const magazine_allocator<U> &) const { return false; }
+};
+
+/*********************************************
+ * MAGAZINE CACHE :: ALLOCATE
+ * pop a block off the loaded magazine
+ *    INPUT  : the size of the block, at most GRAIN * CLASSES
+ *    OUTPUT : the block
+ *    COST   : O(1), no lock unless both magazines are empty
+ *********************************************/
+inline void * magazine_cache :: allocate(size_t size)
+{
+   size_t c = sizeClass(size);
+   Cache & cache = owner().caches[c];
+   if (cache.pLoaded && cache.pLoaded->num)
+      return cache.pLoaded->rounds[--cache.pLoaded->num];
+   return refill(c, cache);
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: DEALLOCATE
+ * push a block onto the loaded magazine, whichever
+ * thread allocated it
+ *    INPUT  : the block, the size it was allocated with
+ *    OUTPUT :
+ *    COST   : O(1), no lock unless both magazines are full
+ *********************************************/
+inline void magazine_cache :: deallocate(void * p, size_t size)
+{
+   size_t c = sizeClass(size);
+   Cache & cache = owner().caches[c];
+   if (!cache.pLoaded || cache.pLoaded->num == ROUNDS)
+      spill(c, cache);
+   cache.pLoaded->rounds[cache.pLoaded->num++] = p;
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: REFILL
+ * the loaded magazine is empty.  Flip to the spare
+ * if it has anything; otherwise trade the empty
+ * spare for a full magazine from the depot; failing
+ * that, go to operator new.
+ *    INPUT  : the size class, this thread's cache of it
+ *    OUTPUT : a block
+ *    COST   : O(1)
+ *********************************************/
+inline void * magazine_cache :: refill(size_t c, Cache & cache)
+{
+   if (cache.pPrevious && cache.pPrevious->num)
+   {
+      std::swap(cache.pLoaded, cache.pPrevious);
+      return cache.pLoaded->rounds[--cache.pLoaded->num];
+   }
+
+   Depot & d = depot(c);
+   {
+      std::lock_guard<std::mutex> guard(d.lock);
+      if (d.pFull)
+      {
+         Magazine * pFull = d.pFull;
+         d.pFull = pFull->pNext;
+         d.numFull--;
+         if (cache.pPrevious)
+         {
+            cache.pPrevious->pNext = d.pEmpty;
+            d.pEmpty = cache.pPrevious;
+         }
+         cache.pPrevious = cache.pLoaded;
+         cache.pLoaded = pFull;
+         return cache.pLoaded->rounds[--cache.pLoaded->num];
+      }
+   }
+
+   return ::operator new((c + 1) * GRAIN);
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: SPILL
+ * the loaded magazine is full, or missing.  Flip
+ * to the spare if it has room; otherwise hand the
+ * full spare to the depot and load an empty one.
+ *    INPUT  : the size class, this thread's cache of it
+ *    OUTPUT :
+ *    COST   : O(1), or O(ROUNDS) when the depot is deep
+ *********************************************/
+inline void magazine_cache :: spill(size_t c, Cache & cache)
+{
+   if (cache.pPrevious && cache.pPrevious->num < ROUNDS)
+   {
+      std::swap(cache.pLoaded, cache.pPrevious);
+      return;
+   }
+
+   Magazine * pEmpty = nullptr;
+   Magazine * pFree = nullptr;
+   Depot & d = depot(c);
+   {
+      std::lock_guard<std::mutex> guard(d.lock);
+      if (cache.pPrevious)
+      {
+         if (d.numFull < DEPTH)
+         {
+            cache.pPrevious->pNext = d.pFull;
+            d.pFull = cache.pPrevious;
+            d.numFull++;
+         }
+         else
+            pFree = cache.pPrevious;   // freed outside the lock
+      }
+      if (d.pEmpty)
+      {
+         pEmpty = d.pEmpty;
+         d.pEmpty = pEmpty->pNext;
+      }
+   }
+
+   if (pFree)
+   {
+      freeRounds(pFree);
+      if (!pEmpty)
+         pEmpty = pFree;
+      else
+         delete pFree;
+   }
+   if (!pEmpty)
+      pEmpty = newMagazine();
+
+   cache.pPrevious = cache.pLoaded;
+   cache.pLoaded = pEmpty;
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: NEW MAGAZINE
+ *********************************************/
+inline magazine_cache::Magazine * magazine_cache :: newMagazine()
+{
+   Magazine * p = new Magazine;
+   p->num = 0;
+   p->pNext = nullptr;
+   return p;
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: FREE ROUNDS
+ * give every block in a magazine back to
+ * operator delete, leaving it empty
+ *********************************************/
+inline void magazine_cache :: freeRounds(Magazine * p)
+{
+   while (p->num)
+      ::operator delete(p->rounds[--p->num]);
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: OWNER :: DESTRUCTOR
+ * a thread is exiting: its magazines go to the
+ * depots for other threads.  The depot only takes
+ * full ones, so the two are first poured into one
+ * another, and whatever is left in a partly filled
+ * magazine goes back to operator delete.
+ *********************************************/
+inline magazine_cache::Owner :: ~Owner()
+{
+   for (size_t c = 0; c < CLASSES; c++)
+   {
+      Magazine * pFuller = caches[c].pLoaded;
+      Magazine * pEmptier = caches[c].pPrevious;
+      if (pFuller && pEmptier && pFuller->num < pEmptier->num)
+         std::swap(pFuller, pEmptier);
+      if (pFuller && pEmptier)
+         while (pFuller->num < ROUNDS && pEmptier->num)
+            pFuller->rounds[pFuller->num++] = pEmptier->rounds[--pEmptier->num];
+
+      Depot & d = depot(c);
+      for (Magazine * p : { pFuller, pEmptier })
+      {
+         if (!p)
+            continue;
+         if (p->num == ROUNDS)
+         {
+            std::lock_guard<std::mutex> guard(d.lock);
+            if (d.numFull < DEPTH)
+            {
+               p->pNext = d.pFull;
+               d.pFull = p;
+               d.numFull++;
+               continue;
+            }
+         }
+         freeRounds(p);
+         std::lock_guard<std::mutex> guard(d.lock);
+         p->pNext = d.pEmpty;
+         d.pEmpty = p;
+      }
+   }
+}
+
+/*********************************************
+ * MAGAZINE CACHE :: DEPOT :: DESTRUCTOR
+ * at program exit, free every block still cached
+ *********************************************/
+inline magazine_cache::Depot :: ~Depot()
+{
+   while (pFull)
+   {
+      Magazine * p = pFull;
+      pFull = p->pNext;
+      freeRounds(p);
+      delete p;
+   }
+   while (pEmpty)
+   {
+      Magazine * p = pEmpty;
+      pEmpty = p->pNext;
+      delete p;
+   }
+}
+
+}; // namespace custom
@@ -0,0 +1,433 @@
+/***********************************************************************
+ * Header:
+ *    MPMC LIST QUEUE
+ * Summary:
+ *    A lock-free first-in, first-out queue that any number of threads
+ *    can push onto and pop from at the same time.  It follows Michael
+ *    and Scott: a singly linked list with a dummy node at the head,
+ *    where pushing links onto pTail->pNext and popping swings pHead.
+ *    Popped nodes are recycled through a free stack rather than being
+ *    deleted, so a queue that has warmed up no longer allocates.
+ *
+ *    This will contain the class definition of:
+ *        mpmc_list_queue : A class that represents a lock-free queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <limits>      // for std::numeric_limits
+#include <new>         // for placement new
+#include <type_traits> // for std::aligned_storage
+#include <utility>     // for std::move
+#include "hazard.h"    // for hazard_domain and hazard_pointer
+
+class TestMpmcListQueue;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * MPMC LIST QUEUE
+ * Every member but the constructor and destructor
+ * is safe to call from any number of threads.  A
+ * queue may be given a capacity, past which
+ * try_push() turns new elements away.
+ **************************************************/
+template <typename T>
+class mpmc_list_queue
+{
+   friend class ::TestMpmcListQueue; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   explicit mpmc_list_queue(size_t capacity = std::numeric_limits<size_t>::max());
+   mpmc_list_queue(const mpmc_list_queue &) = delete;
+   mpmc_list_queue & operator = (const mpmc_list_queue &) = delete;
+  ~mpmc_list_queue();
+
+   //
+   // Insert
+   //
+
+   bool try_push(const T &  data) { return push_n(&data, 1) == 1; }
+   bool try_push(      T && data);
+   template <class Iterator>
+   size_t push_n(Iterator first, size_t num);
+
+   //
+   // Remove
+   //
+
+   bool try_pop(T & data) { return pop_n(&data, 1) == 1; }
+   template <class OutputIterator>
+   size_t pop_n(OutputIterator out, size_t num);
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements.load(std::memory_order_relaxed); }
+   bool   empty()    const { return size() == 0; }
+   size_t capacity() const { return maxElements; }
+
+   //
+   // Node pool
+   //
+
+   void reserve(size_t num);
+
+private:
+   class Node;
+
+   Node * allocateNode();
+   void link(Node * pFirst, Node * pLast);
+   size_t claim(size_t num);
+   static void recycle(void * p, void * context);
+
+   // member variables
+   std::atomic<Node *> pHead;        // the dummy; the front is pHead->pNext
+   std::atomic<Node *> pTail;        // the last node, or close behind it
+   std::atomic<Node *> pFree;        // top of the stack of spare nodes
+   std::atomic<size_t> numElements;  // elements pushed and not yet popped
+   std::atomic<size_t> numNodes;     // nodes ever allocated
+   size_t maxElements;               // try_push() refuses past this
+   bool closing;                     // set once the destructor starts
+   hazard_domain domain;             // popped nodes wait here to be recycled
+};
+
+/*************************************************
+ * NODE
+ * room for one element and a link.  The dummy and
+ * spare nodes have no element in them.  On the
+ * free stack, pNext links the spares together.
+ *************************************************/
+template <typename T>
+class mpmc_list_queue <T> :: Node
+{
+public:
+   Node() : pNext(nullptr) {}
+
+   T * data() { return reinterpret_cast<T *>(&storage); }
+
+   typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+   std::atomic<Node *> pNext;
+};
+
+/*****************************************
+ * MPMC LIST QUEUE :: CONSTRUCTOR
+ * an empty queue is just the dummy node
+ ****************************************/
+template <typename T>
+mpmc_list_queue <T> :: mpmc_list_queue(size_t capacity) :
+   pFree(nullptr), numElements(0), numNodes(1), maxElements(capacity), closing(false)
+{
+   Node * pDummy = new Node;
+   pHead.store(pDummy, std::memory_order_relaxed);
+   pTail.store(pDummy, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * MPMC LIST QUEUE :: DESTRUCTOR
+ * destroy what is left in the queue and free
+ * every node, spare or not.  The domain frees the
+ * nodes still waiting in it as it goes.
+ ****************************************/
+template <typename T>
+mpmc_list_queue <T> :: ~mpmc_list_queue()
+{
+   closing = true;
+
+   Node * p = pHead.load(std::memory_order_acquire);
+   Node * pNext = p->pNext.load(std::memory_order_acquire);
+   delete p;
+   for (p = pNext; p; p = pNext)
+   {
+      pNext = p->pNext.load(std::memory_order_acquire);
+      p->data()->~T();
+      delete p;
+   }
+
+   for (p = pFree.load(std::memory_order_acquire); p; p = pNext)
+   {
+      pNext = p->pNext.load(std::memory_order_relaxed);
+      delete p;
+   }
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: TRY PUSH
+ * add one element to the back, moving it in
+ *    INPUT  : the element
+ *    OUTPUT : false if the queue is at capacity
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+bool mpmc_list_queue <T> :: try_push(T && data)
+{
+   if (!claim(1))
+      return false;
+
+   Node * pNew = allocateNode();
+   ::new (static_cast<void *>(pNew->data())) T(std::move(data));
+   link(pNew, pNew);
+   return true;
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: PUSH N
+ * add num elements to the back in one go.  They
+ * are chained together privately and then linked
+ * on with a single CAS, so they stay together.
+ *    INPUT  : the first of the elements to copy, how many
+ *    OUTPUT : how many were pushed; fewer at capacity
+ *    COST   : O(num), one CAS to publish them
+ *********************************************/
+template <typename T>
+template <class Iterator>
+size_t mpmc_list_queue <T> :: push_n(Iterator first, size_t num)
+{
+   num = claim(num);
+   if (num == 0)
+      return 0;
+
+   Node * pFirst = nullptr;
+   Node * pLast = nullptr;
+   for (size_t i = 0; i < num; i++, ++first)
+   {
+      Node * pNew = allocateNode();
+      ::new (static_cast<void *>(pNew->data())) T(*first);
+      if (pLast)
+         pLast->pNext.store(pNew, std::memory_order_relaxed);
+      else
+         pFirst = pNew;
+      pLast = pNew;
+   }
+
+   link(pFirst, pLast);
+   return num;
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: POP N
+ * take up to num elements off the front with one
+ * CAS on pHead.  The last node taken becomes the
+ * new dummy; the old dummy and the rest are retired.
+ *    INPUT  : where to move the elements, the most to take
+ *    OUTPUT : how many were taken; 0 if the queue was empty
+ *    COST   : O(num), lock-free
+ *********************************************/
+template <typename T>
+template <class OutputIterator>
+size_t mpmc_list_queue <T> :: pop_n(OutputIterator out, size_t num)
+{
+   if (num == 0)
+      return 0;
+
+   hazard_pointer hpHead(domain);
+   hazard_pointer hpLast(domain);
+   while (true)
+   {
+      // while we guard the dummy it cannot be recycled, so if pHead
+      // still points to it at the CAS, pHead has not moved at all
+      Node * pDummy = hpHead.protect(pHead);
+      Node * pTailNow = pTail.load(std::memory_order_acquire);
+
+      // walk out to the last node we will take.  Nodes are never freed
+      // while the queue lives, so a stale walk is harmless; the CAS
+      // below throws its result away.
+      size_t count = 0;
+      bool passedTail = false;
+      Node * pLast = pDummy;
+      while (count < num)
+      {
+         Node * pNext = pLast->pNext.load(std::memory_order_acquire);
+         if (!pNext)
+            break;
+         if (pLast == pTailNow)
+            passedTail = true;
+         pLast = pNext;
+         count++;
+      }
+
+      if (count == 0)
+      {
+         if (pHead.load(std::memory_order_acquire) == pDummy)
+            return 0;
+         continue;
+      }
+
+      // pTail must never be left behind pHead: help it along first
+      if (passedTail)
+      {
+         Node * pNext = pTailNow->pNext.load(std::memory_order_acquire);
+         if (pNext)
+            pTail.compare_exchange_strong(pTailNow, pNext, std::memory_order_release,
+                                          std::memory_order_relaxed);
+         continue;
+      }
+
+      // the new dummy must stay put while we move its element out
+      hpLast.set(pLast);
+      Node * pExpected = pDummy;
+      if (!pHead.compare_exchange_strong(pExpected, pLast, std::memory_order_acq_rel,
+                                         std::memory_order_relaxed))
+         continue;
+
+      // the elements are ours now
+      Node * p = pDummy;
+      for (size_t i = 0; i < count; i++)
+      {
+         Node * pNext = p->pNext.load(std::memory_order_acquire);
+         *out = std::move(*pNext->data());
+         ++out;
+         pNext->data()->~T();
+         domain.retire(p, recycle, this);
+         p = pNext;
+      }
+      numElements.fetch_sub(count, std::memory_order_relaxed);
+      return count;
+   }
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: RESERVE
+ * put spare nodes on the free stack so the next
+ * num pushes do not allocate
+ *    INPUT  : how many spares to add
+ *    OUTPUT :
+ *    COST   : O(num)
+ *********************************************/
+template <typename T>
+void mpmc_list_queue <T> :: reserve(size_t num)
+{
+   for (size_t i = 0; i < num; i++)
+   {
+      numNodes.fetch_add(1, std::memory_order_relaxed);
+      recycle(new Node, this);
+   }
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: ALLOCATE NODE
+ * pop a spare off the free stack, or make a new
+ * node if there are none.  Guarding the top keeps
+ * it from being popped, used, recycled and pushed
+ * back (ABA) before our CAS.
+ *    INPUT  :
+ *    OUTPUT : a node with no element and no successor
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+typename mpmc_list_queue <T> :: Node * mpmc_list_queue <T> :: allocateNode()
+{
+   hazard_pointer hp(domain);
+   while (true)
+   {
+      Node * p = hp.protect(pFree);
+      if (!p)
+         break;
+      Node * pNext = p->pNext.load(std::memory_order_acquire);
+      if (pFree.compare_exchange_weak(p, pNext, std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+      {
+         p->pNext.store(nullptr, std::memory_order_relaxed);
+         return p;
+      }
+   }
+
+   numNodes.fetch_add(1, std::memory_order_relaxed);
+   return new Node;
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: RECYCLE
+ * a retired node is no longer guarded by anyone:
+ * push it onto the free stack
+ *    INPUT  : the node, the queue it belongs to
+ *    OUTPUT :
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+void mpmc_list_queue <T> :: recycle(void * p, void * context)
+{
+   Node * pNode = static_cast<Node *>(p);
+   mpmc_list_queue <T> * pQueue = static_cast<mpmc_list_queue <T> *>(context);
+   if (pQueue->closing)
+   {
+      delete pNode;
+      return;
+   }
+
+   Node * pTop = pQueue->pFree.load(std::memory_order_relaxed);
+   do
+      pNode->pNext.store(pTop, std::memory_order_relaxed);
+   while (!pQueue->pFree.compare_exchange_weak(pTop, pNode, std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: LINK
+ * hang a chain of nodes off the last node, then
+ * swing pTail to the end of the chain.  Anyone who
+ * finds pTail lagging helps it forward.
+ *    INPUT  : the first and last nodes of the chain
+ *    OUTPUT :
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+void mpmc_list_queue <T> :: link(Node * pFirst, Node * pLast)
+{
+   // the tail must be guarded: a recycled node on the free stack
+   // could otherwise take our chain
+   hazard_pointer hp(domain);
+   while (true)
+   {
+      Node * pLastNow = hp.protect(pTail);
+      Node * pNext = pLastNow->pNext.load(std::memory_order_acquire);
+      if (pNext)
+      {
+         pTail.compare_exchange_strong(pLastNow, pNext, std::memory_order_release,
+                                       std::memory_order_relaxed);
+         continue;
+      }
+
+      Node * pExpected = nullptr;
+      if (pLastNow->pNext.compare_exchange_strong(pExpected, pFirst, std::memory_order_release,
+                                                  std::memory_order_relaxed))
+      {
+         pTail.compare_exchange_strong(pLastNow, pLast, std::memory_order_release,
+                                       std::memory_order_relaxed);
+         return;
+      }
+   }
+}
+
+/*********************************************
+ * MPMC LIST QUEUE :: CLAIM
+ * count up to num elements against the capacity
+ *    INPUT  : how many we would like to push
+ *    OUTPUT : how many we may push
+ *    COST   : O(1), lock-free
+ *********************************************/
+template <typename T>
+size_t mpmc_list_queue <T> :: claim(size_t num)
+{
+   size_t numNow = numElements.load(std::memory_order_relaxed);
+   size_t numGranted;
+   do
+   {
+      numGranted = maxElements - numNow < num ? maxElements - numNow : num;
+      if (numGranted == 0)
+         return 0;
+   }
+   while (!numElements.compare_exchange_weak(numNow, numNow + numGranted,
+                                             std::memory_order_relaxed));
+   return numGranted;
+}
+
+}; // namespace custom
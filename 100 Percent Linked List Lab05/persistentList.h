@@ -0,0 +1,611 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT LIST
+ * Summary:
+ *    An immutable list whose copies share nodes.  Copying one is a
+ *    snapshot: O(1) time and no new nodes, however long the list.
+ *    Changing a copy builds new nodes for whatever it has to and
+ *    links them to the untouched nodes it shares with the others, so
+ *    no other copy ever sees the change.
+ *
+ *    A node is never changed once it is built.  Each one counts the
+ *    lists and nodes that point to it, and the last of them to let
+ *    go destroys it.  The count is atomic so that snapshots can be
+ *    handed to other threads; a single list object is no more
+ *    thread safe than custom::list.
+ *
+ *    The elements are held on two singly linked chains: the front
+ *    chain from the front in, and the back chain from the back in.
+ *    Both ends are then the head of a chain, and pushing or popping
+ *    either end is O(1).  When one chain runs out while the other
+ *    still has two or more elements, the other is split between them,
+ *    which is O(n) but leaves n / 2 pops before the next split.
+ *
+ *    This will contain the class definition of:
+ *        persistent_list           : A class that represents a persistent list
+ *        persistent_list::iterator : An iterator through a persistent list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <algorithm>   // for std::reverse
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <initializer_list> // for std::initializer_list
+#include <memory>      // for std::allocator
+#include <type_traits> // for std::enable_if
+#include <utility>     // for std::swap
+#include <vector>      // for std::vector
+
+class TestPersistentList; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * PERSISTENT LIST
+ * The elements cannot be changed in place, only
+ * added and removed.  Every copy is independent.
+ **************************************************/
+template <typename T, typename A = std::allocator<T>>
+class persistent_list
+{
+   friend class ::TestPersistentList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   persistent_list() {}
+   persistent_list(const persistent_list & rhs);
+   persistent_list(persistent_list && rhs);
+   persistent_list(const std::initializer_list<T> & il);
+   template <class Iterator, class = typename
+             std::enable_if<!std::is_integral<Iterator>::value>::type>
+   persistent_list(Iterator first, Iterator last);
+  ~persistent_list() { clear(); }
+
+   //
+   // Assign
+   //
+
+   persistent_list & operator = (const persistent_list & rhs);
+   persistent_list & operator = (persistent_list && rhs);
+   void swap(persistent_list & rhs);
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin();
+   iterator end() { return iterator(); }
+
+   //
+   // Access
+   //
+
+   const T & front() const;
+   const T & back() const;
+
+   //
+   // Insert
+   //
+
+   void push_front(const T & data);
+   void push_back (const T & data);
+   void insert(iterator it, const T & data);
+
+   //
+   // Remove
+   //
+
+   void pop_front();
+   void pop_back();
+   void clear();
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return size() == 0;          }
+   size_t size() const { return numFront + numBack;   }
+
+private:
+   // a node is shared by every list and node that points to it
+   struct Node
+   {
+      Node(const T & data, Node * pNext) : data(data), pNext(pNext), numRefs(1) {}
+      const T data;
+      Node * const pNext;
+      std::atomic<size_t> numRefs;
+   };
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+   typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+   Node * createNode(const T & data, Node * pNext);
+   static Node * retain(Node * p);
+   void release(Node * p);
+   void balance();
+   void split();
+
+   // member variables
+   Node * pFront = nullptr;  // first element, then on toward the back
+   Node * pBack = nullptr;   // last element, then on toward the front
+   size_t numFront = 0;
+   size_t numBack = 0;
+   NodeAlloc alloc;
+
+   // the back chain from the front in, for iterating.  Built
+   // by begin() when the back chain has changed since.
+   std::vector<Node *> backOrder;
+   bool backOrderStale = false;
+};
+
+/*************************************************
+ * PERSISTENT LIST ITERATOR
+ * Walks the front chain, then the back chain in the
+ * order begin() laid it out.  Good until the list it
+ * came from is changed; the elements themselves stay
+ * good as long as any copy holds them.
+ ************************************************/
+template <typename T, typename A>
+class persistent_list <T, A> :: iterator
+{
+   friend class ::TestPersistentList; // give unit tests access to the privates
+   friend class persistent_list;
+public:
+   // constructors, destructors, and assignment operator
+   iterator() : p(nullptr), pp(nullptr), ppEnd(nullptr), inFront(false) {}
+   iterator(Node * p, Node * const * pp, Node * const * ppEnd, bool inFront) :
+      p(p), pp(pp), ppEnd(ppEnd), inFront(inFront) {}
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+
+   // dereference operator, fetch an element
+   const T & operator * () const { return p->data; }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      if (inFront && p->pNext)
+         p = p->pNext;
+      else
+      {
+         inFront = false;
+         p = pp != ppEnd ? *pp++ : nullptr;
+      }
+      return *this;
+   }
+
+   // postfix increment
+   iterator operator ++ (int)
+   {
+      iterator itOld = *this;
+      ++(*this);
+      return itOld;
+   }
+
+private:
+   Node * p;             // the element we are on
+   Node * const * pp;    // the next element of the back chain
+   Node * const * ppEnd;
+   bool inFront;         // whether p is on the front chain
+};
+
+/*****************************************
+ * PERSISTENT LIST :: COPY CONSTRUCTOR
+ * take a snapshot, sharing every node
+ *    COST   : O(1)
+ ****************************************/
+template <typename T, typename A>
+persistent_list <T, A> :: persistent_list(const persistent_list & rhs) :
+   pFront(retain(rhs.pFront)), pBack(retain(rhs.pBack)),
+   numFront(rhs.numFront), numBack(rhs.numBack),
+   alloc(rhs.alloc), backOrderStale(rhs.pBack != nullptr)
+{
+}
+
+/*****************************************
+ * PERSISTENT LIST :: MOVE CONSTRUCTOR
+ ****************************************/
+template <typename T, typename A>
+persistent_list <T, A> :: persistent_list(persistent_list && rhs) :
+   pFront(rhs.pFront), pBack(rhs.pBack),
+   numFront(rhs.numFront), numBack(rhs.numBack),
+   alloc(rhs.alloc), backOrderStale(rhs.pBack != nullptr)
+{
+   rhs.pFront = rhs.pBack = nullptr;
+   rhs.numFront = rhs.numBack = 0;
+   rhs.backOrder.clear();
+   rhs.backOrderStale = false;
+}
+
+/*****************************************
+ * PERSISTENT LIST :: INITIALIZER LIST and RANGE CONSTRUCTORS
+ * half the elements go on each chain, so that either
+ * end is as cheap to insert near
+ *    COST   : O(n)
+ ****************************************/
+template <typename T, typename A>
+persistent_list <T, A> :: persistent_list(const std::initializer_list<T> & il)
+{
+   for (const T & data : il)
+      push_back(data);
+   if (size() >= 2)
+      split();
+}
+
+template <typename T, typename A>
+template <class Iterator, class>
+persistent_list <T, A> :: persistent_list(Iterator first, Iterator last)
+{
+   for (; first != last; ++first)
+      push_back(*first);
+   if (size() >= 2)
+      split();
+}
+
+/*****************************************
+ * PERSISTENT LIST :: ASSIGNMENT
+ * share the RHS's nodes, letting go of ours
+ *    COST   : O(1), plus O(n) for the nodes only we held
+ ****************************************/
+template <typename T, typename A>
+persistent_list <T, A> & persistent_list <T, A> :: operator = (const persistent_list & rhs)
+{
+   persistent_list copy(rhs);
+   swap(copy);
+   return *this;
+}
+
+template <typename T, typename A>
+persistent_list <T, A> & persistent_list <T, A> :: operator = (persistent_list && rhs)
+{
+   persistent_list moved(std::move(rhs));
+   swap(moved);
+   return *this;
+}
+
+/*****************************************
+ * PERSISTENT LIST :: SWAP
+ *    COST   : O(1)
+ ****************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: swap(persistent_list & rhs)
+{
+   std::swap(pFront, rhs.pFront);
+   std::swap(pBack, rhs.pBack);
+   std::swap(numFront, rhs.numFront);
+   std::swap(numBack, rhs.numBack);
+   std::swap(alloc, rhs.alloc);
+   backOrder.swap(rhs.backOrder);
+   std::swap(backOrderStale, rhs.backOrderStale);
+}
+
+/*********************************************
+ * PERSISTENT LIST :: BEGIN
+ * lay the back chain out from the front in, if it
+ * has changed since the last time
+ *    INPUT  :
+ *    OUTPUT : an iterator to the first element
+ *    COST   : O(1), or O(back chain) after it changed
+ *********************************************/
+template <typename T, typename A>
+typename persistent_list <T, A> :: iterator persistent_list <T, A> :: begin()
+{
+   if (backOrderStale)
+   {
+      backOrder.resize(numBack);
+      Node * p = pBack;
+      for (size_t i = numBack; i-- > 0; p = p->pNext)
+         backOrder[i] = p;
+      backOrderStale = false;
+   }
+
+   Node * const * pp = backOrder.data();
+   Node * const * ppEnd = pp + numBack;
+   if (pFront)
+      return iterator(pFront, pp, ppEnd, true);
+   return iterator(pp != ppEnd ? *pp : nullptr, pp + 1, ppEnd, false);
+}
+
+/*********************************************
+ * PERSISTENT LIST :: FRONT and BACK
+ * With two or more elements both chains have some,
+ * so each end is the head of a chain.
+ *    INPUT  :
+ *    OUTPUT : the element
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+const T & persistent_list <T, A> :: front() const
+{
+   if (pFront)
+      return pFront->data;
+   if (pBack)
+      return pBack->data;
+   throw("ERROR: unable to access data from an empty list");
+}
+
+template <typename T, typename A>
+const T & persistent_list <T, A> :: back() const
+{
+   if (pBack)
+      return pBack->data;
+   if (pFront)
+      return pFront->data;
+   throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * PERSISTENT LIST :: PUSH FRONT and PUSH BACK
+ * the new node points at the old head of its chain,
+ * which every other copy goes on sharing
+ *    INPUT  : the element
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: push_front(const T & data)
+{
+   pFront = createNode(data, pFront);
+   numFront++;
+   balance();
+}
+
+template <typename T, typename A>
+void persistent_list <T, A> :: push_back(const T & data)
+{
+   pBack = createNode(data, pBack);
+   numBack++;
+   backOrderStale = true;
+   balance();
+}
+
+/*********************************************
+ * PERSISTENT LIST :: INSERT
+ * put an element before an iterator.  The nodes from
+ * the iterator out to the end on its side are built
+ * again; everything past it is shared.
+ *    INPUT  : where it goes, from this list's begin(),
+ *             and the element
+ *    OUTPUT :
+ *    COST   : O(distance to the end of its chain)
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: insert(iterator it, const T & data)
+{
+   if (it.p == nullptr)
+   {
+      push_back(data);
+      return;
+   }
+
+   if (it.inFront)
+   {
+      // build the nodes ahead of it again, back to front
+      std::vector<Node *> ahead;
+      for (Node * p = pFront; p != it.p; p = p->pNext)
+         ahead.push_back(p);
+      Node * pNew = retain(it.p);
+      try
+      {
+         pNew = createNode(data, pNew);
+         for (size_t i = ahead.size(); i-- > 0; )
+            pNew = createNode(ahead[i]->data, pNew);
+      }
+      catch (...)
+      {
+         release(pNew);
+         throw;
+      }
+      release(pFront);
+      pFront = pNew;
+      numFront++;
+      balance();
+      return;
+   }
+
+   // it.p is backOrder[j]: it and the nodes behind it are built again
+   size_t j = it.pp - 1 - backOrder.data();
+   Node * pNew = j > 0 ? retain(backOrder[j - 1]) : nullptr;
+   try
+   {
+      pNew = createNode(data, pNew);
+      for (size_t i = j; i < numBack; i++)
+         pNew = createNode(backOrder[i]->data, pNew);
+   }
+   catch (...)
+   {
+      release(pNew);
+      throw;
+   }
+   release(pBack);
+   pBack = pNew;
+   numBack++;
+   backOrderStale = true;
+   balance();
+}
+
+/*********************************************
+ * PERSISTENT LIST :: POP FRONT and POP BACK
+ * the head of the chain is let go, and destroyed
+ * if no other copy holds it
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(1), or O(n) when a chain runs out
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: pop_front()
+{
+   if (pFront == nullptr)
+   {
+      // at most one element, and it is on the back chain
+      clear();
+      return;
+   }
+
+   Node * pOld = pFront;
+   pFront = retain(pOld->pNext);
+   numFront--;
+   release(pOld);
+   balance();
+}
+
+template <typename T, typename A>
+void persistent_list <T, A> :: pop_back()
+{
+   if (pBack == nullptr)
+   {
+      clear();
+      return;
+   }
+
+   Node * pOld = pBack;
+   pBack = retain(pOld->pNext);
+   numBack--;
+   backOrderStale = true;
+   release(pOld);
+   balance();
+}
+
+/*********************************************
+ * PERSISTENT LIST :: CLEAR
+ *    COST   : O(the nodes no other copy holds)
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: clear()
+{
+   release(pFront);
+   release(pBack);
+   pFront = pBack = nullptr;
+   numFront = numBack = 0;
+   backOrder.clear();
+   backOrderStale = false;
+}
+
+/*********************************************
+ * PERSISTENT LIST :: CREATE NODE
+ *    INPUT  : the element and the node after it,
+ *             whose reference the new node takes.
+ *             If this throws, the caller still has it.
+ *    OUTPUT : the new node, held once
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+typename persistent_list <T, A> :: Node *
+persistent_list <T, A> :: createNode(const T & data, Node * pNext)
+{
+   Node * p = NodeTraits::allocate(alloc, 1);
+   try
+   {
+      NodeTraits::construct(alloc, p, data, pNext);
+   }
+   catch (...)
+   {
+      NodeTraits::deallocate(alloc, p, 1);
+      throw;
+   }
+   return p;
+}
+
+/*********************************************
+ * PERSISTENT LIST :: RETAIN
+ *    INPUT  : a node, or NULL
+ *    OUTPUT : the same node, held once more
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+typename persistent_list <T, A> :: Node * persistent_list <T, A> :: retain(Node * p)
+{
+   if (p)
+      p->numRefs.fetch_add(1, std::memory_order_relaxed);
+   return p;
+}
+
+/*********************************************
+ * PERSISTENT LIST :: RELEASE
+ * let go of a node.  If that was the last hold on
+ * it, it is destroyed and lets go of the next one.
+ * This is a loop rather than recursion so a long
+ * chain cannot run out of stack.
+ *    INPUT  : a node, or NULL
+ *    OUTPUT :
+ *    COST   : O(the nodes destroyed)
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: release(Node * p)
+{
+   while (p && p->numRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+   {
+      Node * pNext = p->pNext;
+      NodeTraits::destroy(alloc, p);
+      NodeTraits::deallocate(alloc, p, 1);
+      p = pNext;
+   }
+}
+
+/*********************************************
+ * PERSISTENT LIST :: BALANCE
+ * keep some of the elements on each chain once
+ * there are two or more
+ *    COST   : O(1), or O(n) to split
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: balance()
+{
+   if ((numFront == 0 && numBack >= 2) || (numBack == 0 && numFront >= 2))
+      split();
+}
+
+/*********************************************
+ * PERSISTENT LIST :: SPLIT
+ * rebuild the chains with the front half of the
+ * elements on the front chain and the back half on
+ * the back chain.  The old chains are still shared
+ * by any other copy.
+ *    COST   : O(n)
+ *********************************************/
+template <typename T, typename A>
+void persistent_list <T, A> :: split()
+{
+   // every element from the front in
+   std::vector<Node *> order;
+   order.reserve(size());
+   for (Node * p = pFront; p; p = p->pNext)
+      order.push_back(p);
+   for (Node * p = pBack; p; p = p->pNext)
+      order.push_back(p);
+   std::reverse(order.begin() + numFront, order.end());
+
+   size_t half = order.size() / 2;
+   Node * pNewFront = nullptr;
+   Node * pNewBack = nullptr;
+   try
+   {
+      for (size_t i = half; i-- > 0; )
+         pNewFront = createNode(order[i]->data, pNewFront);
+      for (size_t i = half; i < order.size(); i++)
+         pNewBack = createNode(order[i]->data, pNewBack);
+   }
+   catch (...)
+   {
+      release(pNewFront);
+      release(pNewBack);
+      throw;
+   }
+
+   release(pFront);
+   release(pBack);
+   pFront = pNewFront;
+   pBack = pNewBack;
+   numFront = half;
+   numBack = order.size() - half;
+   backOrderStale = true;
+}
+
+}; // namespace custom
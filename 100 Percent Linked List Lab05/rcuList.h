@@ -0,0 +1,346 @@
+/***********************************************************************
+ * Header:
+ *    RCU LIST
+ * Summary:
+ *    A read-copy-update singly linked list for data that is read far
+ *    more often than it is changed.  Readers take no lock and make no
+ *    read-modify-write: they enter an epoch and follow pNext with
+ *    acquire loads.  Writers take turns on a mutex, build each change
+ *    off to the side, and publish it with a single release store, so
+ *    a reader sees the list either before or after the change, never
+ *    half way.  A node a writer unlinks is retired into an epoch
+ *    domain and only freed once every reader that might be on it has
+ *    moved on.
+ *
+ *    This will contain the class definition of:
+ *        rcu_list : A class that represents a read-mostly list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <mutex>       // for std::mutex
+#include "epoch.h"     // for epoch_domain and epoch_guard
+
+class TestRcuList;     // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * RCU LIST
+ * The readers, find(), find_if() and for_each(),
+ * may run on any number of threads alongside each
+ * other and alongside one writer.  Writers wait on
+ * each other.  There is no iterator: a reader may
+ * only hold on to a node inside its epoch.
+ **************************************************/
+template <typename T>
+class rcu_list
+{
+   friend class ::TestRcuList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   explicit rcu_list(epoch_domain & domain = epoch_domain::global()) :
+      pHead(nullptr), pTail(nullptr), numElements(0), domain(domain) {}
+   rcu_list(const rcu_list &) = delete;
+   rcu_list & operator = (const rcu_list &) = delete;
+  ~rcu_list();
+
+   //
+   // Read
+   //
+
+   bool find(const T & data) const;
+   template <class Pred>
+   bool find_if(Pred pred, T & result) const;
+   template <class F>
+   void for_each(F f) const;
+
+   //
+   // Write
+   //
+
+   void push_front(const T & data);
+   void push_back(const T & data);
+   bool replace(const T & oldData, const T & newData);
+   bool erase(const T & data);
+   void clear();
+
+   //
+   // Status
+   //
+
+   size_t size() const { return numElements.load(std::memory_order_relaxed); }
+   bool empty()  const { return size() == 0; }
+
+private:
+   class Node;
+
+   std::atomic<Node *> * findLink(const T & data, Node * & pPrev);
+   void unlink(std::atomic<Node *> * pLink, Node * pPrev);
+   static void deleteNode(void * p) { delete static_cast<Node *>(p); }
+
+   // member variables
+   std::atomic<Node *> pHead;        // what readers start from
+   Node * pTail;                     // only writers use it
+   std::atomic<size_t> numElements;
+   std::mutex writeLock;             // one writer at a time
+   epoch_domain & domain;            // where unlinked nodes wait to be freed
+};
+
+/*************************************************
+ * NODE
+ * the data, never changed once published, and
+ * the link readers follow
+ *************************************************/
+template <typename T>
+class rcu_list <T> :: Node
+{
+public:
+   Node(const T & data) : data(data), pNext(nullptr) {}
+
+   const T data;
+   std::atomic<Node *> pNext;
+};
+
+/*****************************************
+ * RCU LIST :: DESTRUCTOR
+ * free the nodes still linked.  Those already
+ * unlinked belong to the domain.
+ ****************************************/
+template <typename T>
+rcu_list <T> :: ~rcu_list()
+{
+   Node * p = pHead.load(std::memory_order_acquire);
+   while (p)
+   {
+      Node * pDelete = p;
+      p = p->pNext.load(std::memory_order_relaxed);
+      delete pDelete;
+   }
+}
+
+/*********************************************
+ * RCU LIST :: FIND
+ * is the element in the list?
+ *    INPUT  : the element to look for
+ *    OUTPUT : whether it was there when we passed
+ *    COST   : O(n), no locks
+ *********************************************/
+template <typename T>
+bool rcu_list <T> :: find(const T & data) const
+{
+   epoch_guard guard(domain);
+   for (Node * p = pHead.load(std::memory_order_acquire); p;
+        p = p->pNext.load(std::memory_order_acquire))
+      if (p->data == data)
+         return true;
+   return false;
+}
+
+/*********************************************
+ * RCU LIST :: FIND IF
+ * copy out the first element pred accepts.  The
+ * copy is the caller's to keep after the epoch.
+ *    INPUT  : the predicate, where to copy the match
+ *    OUTPUT : whether there was a match
+ *    COST   : O(n), no locks
+ *********************************************/
+template <typename T>
+template <class Pred>
+bool rcu_list <T> :: find_if(Pred pred, T & result) const
+{
+   epoch_guard guard(domain);
+   for (Node * p = pHead.load(std::memory_order_acquire); p;
+        p = p->pNext.load(std::memory_order_acquire))
+      if (pred(p->data))
+      {
+         result = p->data;
+         return true;
+      }
+   return false;
+}
+
+/*********************************************
+ * RCU LIST :: FOR EACH
+ * visit every element reachable as we pass.  The
+ * reference is only good inside f.
+ *    INPUT  : the function to call on each element
+ *    OUTPUT :
+ *    COST   : O(n), no locks
+ *********************************************/
+template <typename T>
+template <class F>
+void rcu_list <T> :: for_each(F f) const
+{
+   epoch_guard guard(domain);
+   for (Node * p = pHead.load(std::memory_order_acquire); p;
+        p = p->pNext.load(std::memory_order_acquire))
+      f(p->data);
+}
+
+/*********************************************
+ * RCU LIST :: PUSH FRONT
+ * the new node points at the old first one before
+ * it is published
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+void rcu_list <T> :: push_front(const T & data)
+{
+   Node * pNew = new Node(data);
+   std::lock_guard<std::mutex> guard(writeLock);
+   pNew->pNext.store(pHead.load(std::memory_order_relaxed), std::memory_order_relaxed);
+   pHead.store(pNew, std::memory_order_release);
+   if (!pTail)
+      pTail = pNew;
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************
+ * RCU LIST :: PUSH BACK
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+void rcu_list <T> :: push_back(const T & data)
+{
+   Node * pNew = new Node(data);
+   std::lock_guard<std::mutex> guard(writeLock);
+   if (pTail)
+      pTail->pNext.store(pNew, std::memory_order_release);
+   else
+      pHead.store(pNew, std::memory_order_release);
+   pTail = pNew;
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*********************************************
+ * RCU LIST :: REPLACE
+ * read, copy, update: a copy holding the new data
+ * takes over the old node's link and is swapped in
+ * with one store.  Readers already on the old node
+ * carry on from it undisturbed.
+ *    INPUT  : the element to replace, what to put instead
+ *    OUTPUT : whether the element was there
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+bool rcu_list <T> :: replace(const T & oldData, const T & newData)
+{
+   Node * pNew = new Node(newData);
+   std::lock_guard<std::mutex> guard(writeLock);
+   Node * pPrev;
+   std::atomic<Node *> * pLink = findLink(oldData, pPrev);
+   if (!pLink)
+   {
+      delete pNew;
+      return false;
+   }
+
+   Node * pOld = pLink->load(std::memory_order_relaxed);
+   pNew->pNext.store(pOld->pNext.load(std::memory_order_relaxed), std::memory_order_relaxed);
+   pLink->store(pNew, std::memory_order_release);
+   if (pTail == pOld)
+      pTail = pNew;
+   domain.retire(pOld, deleteNode);
+   return true;
+}
+
+/*********************************************
+ * RCU LIST :: ERASE
+ * unlink the first node holding the element
+ *    INPUT  : the element to remove
+ *    OUTPUT : whether it was there
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+bool rcu_list <T> :: erase(const T & data)
+{
+   std::lock_guard<std::mutex> guard(writeLock);
+   Node * pPrev;
+   std::atomic<Node *> * pLink = findLink(data, pPrev);
+   if (!pLink)
+      return false;
+   unlink(pLink, pPrev);
+   return true;
+}
+
+/*********************************************
+ * RCU LIST :: CLEAR
+ * one store empties the list for new readers; the
+ * old chain is retired node by node
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+void rcu_list <T> :: clear()
+{
+   std::lock_guard<std::mutex> guard(writeLock);
+   Node * p = pHead.load(std::memory_order_relaxed);
+   pHead.store(nullptr, std::memory_order_release);
+   pTail = nullptr;
+   numElements.store(0, std::memory_order_relaxed);
+   while (p)
+   {
+      Node * pRetire = p;
+      p = p->pNext.load(std::memory_order_relaxed);
+      domain.retire(pRetire, deleteNode);
+   }
+}
+
+/*********************************************
+ * RCU LIST :: FIND LINK
+ * the link pointing at the first node holding the
+ * element.  Called with the write lock held.
+ *    INPUT  : the element to look for
+ *    OUTPUT : the link, or NULL if it is not there,
+ *             and the node it belongs to, or NULL for pHead
+ *    COST   : O(n)
+ *********************************************/
+template <typename T>
+std::atomic<typename rcu_list <T> :: Node *> * rcu_list <T> :: findLink(const T & data, Node * & pPrev)
+{
+   pPrev = nullptr;
+   std::atomic<Node *> * pLink = &pHead;
+   for (Node * p = pLink->load(std::memory_order_relaxed); p;
+        p = pLink->load(std::memory_order_relaxed))
+   {
+      if (p->data == data)
+         return pLink;
+      pPrev = p;
+      pLink = &p->pNext;
+   }
+   return nullptr;
+}
+
+/*********************************************
+ * RCU LIST :: UNLINK
+ * point the link past the node and retire it.
+ * The node's own pNext is left alone, so a reader
+ * standing on it still finds its way back.
+ * Called with the write lock held.
+ *********************************************/
+template <typename T>
+void rcu_list <T> :: unlink(std::atomic<Node *> * pLink, Node * pPrev)
+{
+   Node * pNode = pLink->load(std::memory_order_relaxed);
+   pLink->store(pNode->pNext.load(std::memory_order_relaxed), std::memory_order_release);
+   if (pTail == pNode)
+      pTail = pPrev;
+
+   numElements.fetch_sub(1, std::memory_order_relaxed);
+   domain.retire(pNode, deleteNode);
+}
+
+}; // namespace custom
@@ -0,0 +1,279 @@
+/***********************************************************************
+ * Header:
+ *    SPSC LIST
+ * Summary:
+ *    A first-in, first-out list shared by exactly two threads: one that
+ *    only pushes onto the back and one that only pops off the front.
+ *    With one writer per end there is nothing to arbitrate, so every
+ *    operation is a handful of plain acquire loads and release stores:
+ *    no compare-and-swap, no lock, and no waiting on the other thread.
+ *
+ *    Consumed nodes stay linked behind the head.  The producer reuses
+ *    them from there before it asks for new ones, so a list that has
+ *    warmed up no longer allocates.
+ *
+ *    This will contain the class definition of:
+ *        spsc_list : A class that represents a single-producer,
+ *                    single-consumer list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <new>         // for placement new
+#include <type_traits> // for std::aligned_storage
+#include <utility>     // for std::move
+
+class TestSpscList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * SPSC LIST
+ * The push_back, pop_front and front subset of
+ * list.  push_back() may only be called from the
+ * producer thread, front() and pop_front() only
+ * from the consumer.  size() and empty() are safe
+ * from either, though the answer may be stale.
+ **************************************************/
+template <typename T>
+class spsc_list
+{
+   friend class ::TestSpscList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   spsc_list();
+   spsc_list(const spsc_list &) = delete;
+   spsc_list & operator = (const spsc_list &) = delete;
+  ~spsc_list();
+
+   //
+   // Producer
+   //
+
+   void push_back(const T &  data);
+   void push_back(      T && data);
+
+   //
+   // Consumer
+   //
+
+   T & front();
+   void pop_front();
+
+   //
+   // Status
+   //
+
+   size_t size() const
+   {
+      // popped first.  A push is counted before its node is linked,
+      // so popped should never pass pushed; never wrap if it does.
+      size_t popped = numPopped.load(std::memory_order_acquire);
+      size_t pushed = numPushed.load(std::memory_order_acquire);
+      return pushed > popped ? pushed - popped : 0;
+   }
+   bool empty() const;
+
+private:
+   enum { CACHE_LINE = 64 };  // keep each thread's members to itself
+   class Node;
+
+   Node * allocateNode();
+   void link(Node * pNew);
+
+   // the consumer's members
+   alignas(CACHE_LINE) std::atomic<Node *> pHead;  // the dummy; the front is pHead->pNext
+   std::atomic<size_t> numPopped;
+
+   // the producer's members
+   alignas(CACHE_LINE) Node * pTail;   // the last node
+   Node * pFirst;                      // oldest consumed node, next to reuse
+   Node * pHeadCopy;                   // pHead the last time we looked
+   std::atomic<size_t> numPushed;
+   size_t numNodes;                    // nodes ever allocated
+};
+
+/*************************************************
+ * NODE
+ * room for one element and a link.  Only the nodes
+ * after pHead hold an element.
+ *************************************************/
+template <typename T>
+class spsc_list <T> :: Node
+{
+public:
+   Node() : pNext(nullptr) {}
+
+   T * data() { return reinterpret_cast<T *>(&storage); }
+
+   typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+   std::atomic<Node *> pNext;
+};
+
+/*****************************************
+ * SPSC LIST :: CONSTRUCTOR
+ * an empty list is just the dummy node
+ ****************************************/
+template <typename T>
+spsc_list <T> :: spsc_list() : numPopped(0), numPushed(0), numNodes(1)
+{
+   Node * pDummy = new Node;
+   pHead.store(pDummy, std::memory_order_relaxed);
+   pTail = pFirst = pHeadCopy = pDummy;
+}
+
+/*****************************************
+ * SPSC LIST :: DESTRUCTOR
+ * every node, consumed or not, is still linked
+ * from pFirst.  Only those after pHead hold an
+ * element that needs destroying.
+ ****************************************/
+template <typename T>
+spsc_list <T> :: ~spsc_list()
+{
+   Node * pDummy = pHead.load(std::memory_order_acquire);
+   bool full = false;
+   for (Node * p = pFirst; p; )
+   {
+      Node * pNext = p->pNext.load(std::memory_order_relaxed);
+      if (full)
+         p->data()->~T();
+      if (p == pDummy)
+         full = true;
+      delete p;
+      p = pNext;
+   }
+}
+
+/*********************************************
+ * SPSC LIST :: PUSH BACK
+ * add an item to the end of the list
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(1), wait-free
+ *********************************************/
+template <typename T>
+void spsc_list <T> :: push_back(const T & data)
+{
+   Node * pNew = allocateNode();
+   ::new (static_cast<void *>(pNew->data())) T(data);
+   link(pNew);
+}
+
+template <typename T>
+void spsc_list <T> :: push_back(T && data)
+{
+   Node * pNew = allocateNode();
+   ::new (static_cast<void *>(pNew->data())) T(std::move(data));
+   link(pNew);
+}
+
+/*********************************************
+ * SPSC LIST :: EMPTY
+ * whether there is nothing to pop.  We look at the
+ * link rather than the counts: a push is counted
+ * before its node is linked, so the counts can say
+ * there is an element before front() can reach it.
+ *     INPUT  :
+ *     OUTPUT : true if front() would throw
+ *     COST   : O(1), wait-free
+ *********************************************/
+template <typename T>
+bool spsc_list <T> :: empty() const
+{
+   return !pHead.load(std::memory_order_acquire)->pNext.load(std::memory_order_acquire);
+}
+
+/*********************************************
+ * SPSC LIST :: FRONT
+ * retrieves the first element in the list
+ *     INPUT  :
+ *     OUTPUT : the element the next pop_front() removes
+ *     COST   : O(1), wait-free
+ *********************************************/
+template <typename T>
+T & spsc_list <T> :: front()
+{
+   Node * pNext = pHead.load(std::memory_order_relaxed)->pNext.load(std::memory_order_acquire);
+   if (pNext)
+      return *pNext->data();
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * SPSC LIST :: POP FRONT
+ * remove an item from the front of the list.  The
+ * node that held it becomes the new dummy and the
+ * old dummy is left for the producer to reuse.
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(1), wait-free
+ *********************************************/
+template <typename T>
+void spsc_list <T> :: pop_front()
+{
+   Node * pDummy = pHead.load(std::memory_order_relaxed);
+   Node * pNext = pDummy->pNext.load(std::memory_order_acquire);
+   if (!pNext)
+      return;
+
+   pNext->data()->~T();
+
+   // from here on the producer may reuse pDummy
+   pHead.store(pNext, std::memory_order_release);
+   numPopped.store(numPopped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/*********************************************
+ * SPSC LIST :: ALLOCATE NODE
+ * the producer reuses the oldest consumed node.
+ * Only when it has caught up with the copy of
+ * pHead it took last time does it look at the
+ * consumer's cache line again, and only when that
+ * has not moved either does it allocate.
+ *    INPUT  :
+ *    OUTPUT : a node with no element and no link
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+typename spsc_list <T> :: Node * spsc_list <T> :: allocateNode()
+{
+   if (pFirst == pHeadCopy)
+      pHeadCopy = pHead.load(std::memory_order_acquire);
+
+   if (pFirst != pHeadCopy)
+   {
+      Node * pNode = pFirst;
+      pFirst = pFirst->pNext.load(std::memory_order_relaxed);
+      pNode->pNext.store(nullptr, std::memory_order_relaxed);
+      return pNode;
+   }
+
+   numNodes++;
+   return new Node;
+}
+
+/*********************************************
+ * SPSC LIST :: LINK
+ * publish a filled node.  The release store is
+ * what lets the consumer see the element.  The push
+ * is counted first, so by the time the consumer can
+ * pop the node and count that, the push is counted.
+ *********************************************/
+template <typename T>
+void spsc_list <T> :: link(Node * pNew)
+{
+   numPushed.store(numPushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+   pTail->pNext.store(pNew, std::memory_order_release);
+   pTail = pNew;
+}
+
+}; // namespace custom
@@ -0,0 +1,325 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT LIST
+ * Summary:
+ *    Unit tests for concurrent_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrentList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+class TestConcurrentList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_spy();
+
+      // Insert
+      test_pushfront_order();
+      test_pushback_order();
+      test_pushback_afterErased();
+
+      // Find
+      test_find_present();
+      test_find_missing();
+      test_find_unlinksMarked();
+
+      // Erase
+      test_erase_middle();
+      test_erase_firstOfDuplicates();
+      test_erase_missing();
+      test_erase_retires();
+
+      // Threads
+      test_threads_pushBack();
+      test_threads_eraseWhileFinding();
+
+      report("ConcurrentList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list has no nodes
+   void test_construct_default()
+   {  // exercise
+      custom::concurrent_list<int> l;
+      // verify
+      assertUnit(l.pHead.load() == nullptr);
+      assertUnit(l.numElements.load() == 0);
+      assertUnit(l.empty());
+      assertUnit(&l.domain == &custom::hazard_domain::global());
+   }  // teardown
+
+   // the destructor frees everything still linked
+   void test_destructor_spy()
+   {  // setup
+      custom::hazard_domain domain;
+      {
+         custom::concurrent_list<Spy> l(domain);
+         for (int i = 0; i < 5; i++)
+            l.push_back(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 5);
+      assertUnit(Spy::numDelete() == 5);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_front puts each new element first
+   void test_pushfront_order()
+   {  // setup
+      custom::concurrent_list<int> l;
+      // exercise
+      l.push_front(31);
+      l.push_front(26);
+      l.push_front(11);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // push_back puts each new element last
+   void test_pushback_order()
+   {  // setup
+      custom::concurrent_list<int> l;
+      // exercise
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.pHead.load()->data == 11);
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // an erased last node is unlinked, not appended to
+   void test_pushback_afterErased()
+   {  // setup
+      custom::concurrent_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      Node<int> * p26 = l.pHead.load()->pNext.load();
+      p26->pNext.store(custom::concurrent_list<int>::marked(nullptr));   // erased but still linked
+      // exercise
+      l.push_back(31);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 31 }));
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // an element that is there is found
+   void test_find_present()
+   {  // setup
+      custom::concurrent_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // exercise and verify
+      assertUnit(l.find(11));
+      assertUnit(l.find(26));
+      assertUnit(l.find(31));
+   }  // teardown
+
+   // an element that is not there is not
+   void test_find_missing()
+   {  // setup
+      custom::concurrent_list<int> l;
+      assertUnit(!l.find(11));
+      l.push_back(26);
+      // exercise and verify
+      assertUnit(!l.find(11));
+   }  // teardown
+
+   // a search passing a marked node unlinks it
+   void test_find_unlinksMarked()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::concurrent_list<Spy> l(domain);
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      l.push_back(Spy(31));
+      Node<Spy> * p11 = l.pHead.load();
+      Node<Spy> * p26 = p11->pNext.load();
+      Node<Spy> * p31 = p26->pNext.load();
+      p26->pNext.store(custom::concurrent_list<Spy>::marked(p31));
+      Spy::reset();
+      // exercise
+      bool found = l.find(Spy(31));
+      domain.scan();
+      // verify
+      assertUnit(found);
+      assertUnit(p11->pNext.load() == p31);
+      assertUnit(Spy::numDestructor() == 2);   // 26 and the temporary
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase takes out one node and relinks around it
+   void test_erase_middle()
+   {  // setup
+      custom::concurrent_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // exercise
+      bool erased = l.erase(26);
+      // verify
+      assertUnit(erased);
+      assertUnit(toVector(l) == std::vector<int>({ 11, 31 }));
+      assertUnit(l.size() == 2);
+      assertUnit(l.pHead.load()->pNext.load()->data == 31);
+   }  // teardown
+
+   // only the first of equal elements goes
+   void test_erase_firstOfDuplicates()
+   {  // setup
+      custom::concurrent_list<int> l;
+      l.push_back(1);
+      l.push_back(2);
+      l.push_back(1);
+      // exercise
+      l.erase(1);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 2, 1 }));
+   }  // teardown
+
+   // erasing what is not there changes nothing
+   void test_erase_missing()
+   {  // setup
+      custom::concurrent_list<int> l;
+      l.push_back(11);
+      // exercise
+      bool erased = l.erase(99);
+      // verify
+      assertUnit(!erased);
+      assertUnit(l.size() == 1);
+      assertUnit(toVector(l) == std::vector<int>({ 11 }));
+   }  // teardown
+
+   // the erased node goes to the domain, not straight to delete
+   void test_erase_retires()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::concurrent_list<Spy> l(domain);
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      Spy::reset();
+      {
+         custom::hazard_pointer hp(domain);
+         hp.set(l.pHead.load());
+         // exercise
+         l.erase(Spy(11));
+         domain.scan();
+         // verify
+         assertUnit(Spy::numDestructor() == 1);   // just the temporary
+      }
+      domain.scan();
+      assertUnit(Spy::numDestructor() == 2);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // nothing is lost when threads append at once
+   void test_threads_pushBack()
+   {  // setup
+      const int numThreads = 4;
+      const int num = 500;
+      custom::concurrent_list<int> l;
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&l, t]()
+         {
+            for (int i = 0; i < num; i++)
+               l.push_back(t * num + i);
+         }));
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(l.size() == numThreads * num);
+      std::vector<int> v = toVector(l);
+      std::sort(v.begin(), v.end());
+      bool inOrder = v.size() == numThreads * num;
+      for (size_t i = 0; inOrder && i < v.size(); i++)
+         inOrder = v[i] == (int)i;
+      assertUnit(inOrder);
+   }  // teardown
+
+   // erasers and readers share the list safely
+   void test_threads_eraseWhileFinding()
+   {  // setup
+      const int numThreads = 4;
+      const int num = 300;
+      custom::concurrent_list<int> l;
+      for (int i = 0; i < numThreads * num; i++)
+         l.push_front(i);
+      std::atomic<int> numErased(0);
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+      {
+         threads.push_back(std::thread([&l, &numErased, t]()
+         {
+            for (int i = 0; i < num; i++)
+               if (l.erase(t * num + i))
+                  numErased++;
+         }));
+         threads.push_back(std::thread([&l, t]()
+         {
+            for (int i = 0; i < num; i++)
+               l.find(t * num + i);
+         }));
+      }
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(numErased.load() == numThreads * num);
+      assertUnit(l.empty());
+      assertUnit(l.pHead.load() == nullptr);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+   template <class T>
+   using Node = typename custom::concurrent_list<T>::Node;
+
+   std::vector<int> toVector(const custom::concurrent_list<int> & l)
+   {
+      std::vector<int> v;
+      l.for_each([&](const int & value) { v.push_back(value); });
+      return v;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,235 @@
+/***********************************************************************
+ * Header:
+ *    TEST EPOCH
+ * Summary:
+ *    Unit tests for epoch_domain and epoch_guard
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "epoch.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+class TestEpoch : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Guard
+      test_guard_publishesEpoch();
+      test_guard_nests();
+
+      // Advance
+      test_advance_noReaders();
+      test_advance_blockedByReader();
+
+      // Retire
+      test_retire_waitsTwoEpochs();
+      test_retire_amortized();
+      test_synchronize_freesAll();
+      test_destructor_freesRetired();
+
+      // Records
+      test_record_reusedAfterExit();
+      test_record_domainRebuiltAtSameAddress();
+
+      report("Epoch");
+   }
+
+   /***************************************
+    * GUARD
+    ***************************************/
+
+   // a reader inside shows the epoch it entered
+   void test_guard_publishesEpoch()
+   {  // setup
+      custom::epoch_domain domain;
+      domain.epoch.store(5);
+      {
+         // exercise
+         custom::epoch_guard guard(domain);
+         // verify
+         assertUnit(domain.record()->local.load() == ((5ul << 1) | 1));
+      }
+      assertUnit(domain.record()->local.load() == 0);
+   }  // teardown
+
+   // only the outermost guard leaves
+   void test_guard_nests()
+   {  // setup
+      custom::epoch_domain domain;
+      {
+         custom::epoch_guard outer(domain);
+         {
+            // exercise
+            custom::epoch_guard inner(domain);
+         }
+         // verify
+         assertUnit(domain.record()->local.load() == 1);
+         assertUnit(domain.record()->nesting == 1);
+      }
+      assertUnit(domain.record()->local.load() == 0);
+   }  // teardown
+
+   /***************************************
+    * ADVANCE
+    ***************************************/
+
+   // with nobody reading, the epoch moves freely
+   void test_advance_noReaders()
+   {  // setup
+      custom::epoch_domain domain;
+      // exercise
+      bool moved1 = domain.tryAdvance();
+      bool moved2 = domain.tryAdvance();
+      // verify
+      assertUnit(moved1 && moved2);
+      assertUnit(domain.epoch.load() == 2);
+   }  // teardown
+
+   // a reader in an old epoch holds it back
+   void test_advance_blockedByReader()
+   {  // setup
+      custom::epoch_domain domain;
+      custom::epoch_guard guard(domain);
+      // exercise
+      bool moved1 = domain.tryAdvance();   // the reader is in 0: 0 -> 1 is fine
+      bool moved2 = domain.tryAdvance();   // but not 1 -> 2
+      // verify
+      assertUnit(moved1);
+      assertUnit(!moved2);
+      assertUnit(domain.epoch.load() == 1);
+   }  // teardown
+
+   /***************************************
+    * RETIRE
+    ***************************************/
+
+   // a node is only freed once the epoch comes back to its list
+   void test_retire_waitsTwoEpochs()
+   {  // setup
+      int numDeleted = 0;
+      custom::epoch_domain domain;
+      domain.retire(&numDeleted, countDelete);
+      // exercise and verify
+      domain.tryAdvance();
+      assertUnit(numDeleted == 0);
+      domain.tryAdvance();
+      assertUnit(numDeleted == 0);
+      domain.tryAdvance();
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   // retire moves the epoch on by itself once the list is long
+   void test_retire_amortized()
+   {  // setup
+      std::vector<int> counters(1000, 0);
+      custom::epoch_domain domain;
+      // exercise
+      for (int & counter : counters)
+         domain.retire(&counter, countDelete);
+      // verify
+      int numDeleted = 0;
+      for (int counter : counters)
+         numDeleted += counter;
+      assertUnit(numDeleted > 800);
+      assertUnit(domain.epoch.load() > 10);
+   }  // teardown
+
+   // synchronize waits out a reader on another thread
+   void test_synchronize_freesAll()
+   {  // setup
+      int numDeleted = 0;
+      custom::epoch_domain domain;
+      std::atomic<bool> entered(false);
+      std::thread reader([&]()
+      {
+         custom::epoch_guard guard(domain);
+         entered = true;
+         std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      });
+      while (!entered)
+         std::this_thread::yield();
+      domain.retire(&numDeleted, countDelete);
+      // exercise
+      domain.synchronize();
+      // verify
+      assertUnit(numDeleted == 1);
+      reader.join();
+   }  // teardown
+
+   // whatever is left is freed with the domain
+   void test_destructor_freesRetired()
+   {  // setup
+      int numDeleted = 0;
+      {
+         custom::epoch_domain domain;
+         custom::epoch_guard guard(domain);
+         domain.retire(&numDeleted, countDelete);
+         assertUnit(numDeleted == 0);
+      }  // exercise
+      // verify
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   /***************************************
+    * RECORD
+    ***************************************/
+
+   // a thread that exits hands its record to the next one
+   void test_record_reusedAfterExit()
+   {  // setup
+      custom::epoch_domain domain;
+      std::thread([&]() { custom::epoch_guard guard(domain); }).join();
+      // exercise
+      std::thread([&]() { custom::epoch_guard guard(domain); }).join();
+      // verify
+      int numRecords = 0;
+      for (auto p = domain.pRecords.load(); p; p = p->pNext)
+         numRecords++;
+      assertUnit(numRecords == 1);
+   }  // teardown
+
+   // a domain destroyed on another thread and built again at the
+   // same address gives this thread a new record, not the freed one
+   void test_record_domainRebuiltAtSameAddress()
+   {  // setup
+      alignas(custom::epoch_domain) unsigned char buffer[sizeof(custom::epoch_domain)];
+      auto & records = custom::epoch_domain::owner().records;
+      size_t numRecords = records.size();
+      // exercise
+      for (int i = 0; i < 20; i++)
+      {
+         custom::epoch_domain * pDomain = new (buffer) custom::epoch_domain;
+         {
+            custom::epoch_guard guard(*pDomain);
+         }
+         std::thread([&]() { pDomain->~epoch_domain(); }).join();
+      }
+      // verify
+      assertUnit(records.size() <= numRecords + 1);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   // each "node" is a counter of how many times it was freed
+   static void countDelete(void * p)
+   {
+      (*static_cast<int *>(p))++;
+   }
+};
+
+#endif // DEBUG
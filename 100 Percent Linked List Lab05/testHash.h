@@ -0,0 +1,333 @@
+/***********************************************************************
+ * Header:
+ *    TEST HASH
+ * Summary:
+ *    Unit tests for hash_table, unordered_set and unordered_map
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "hash.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class TestHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_init();
+      test_construct_copy();
+      test_destructor_spy();
+
+      // Insert and find
+      test_insert_new();
+      test_insert_duplicate();
+      test_find_missing();
+      test_iterator_visitsAll();
+
+      // Erase
+      test_erase_key();
+      test_erase_iterator();
+
+      // Buckets
+      test_bucket_sharesPool();
+      test_rehash_relinks();
+      test_maxLoadFactor_grows();
+      test_reserve_noAllocation();
+
+      // Map
+      test_map_squareBracket();
+      test_map_at();
+
+      report("Hash");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty table has its minimum buckets, all empty
+   void test_construct_default()
+   {  // exercise
+      custom::unordered_set<int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == custom::unordered_set<int>::MIN_BUCKETS);
+      assertUnit(s.max_load_factor() == 1.0f);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // an initializer list fills the set, skipping repeats
+   void test_construct_init()
+   {  // exercise
+      custom::unordered_set<int> s{ 11, 26, 31, 26 };
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(toSortedVector(s) == std::vector<int>({ 11, 26, 31 }));
+   }  // teardown
+
+   // a copy has the same elements in nodes of its own
+   void test_construct_copy()
+   {  // setup
+      custom::unordered_set<int> lhs{ 11, 26, 31 };
+      // exercise
+      custom::unordered_set<int> rhs(lhs);
+      // verify
+      assertUnit(toSortedVector(rhs) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(&*rhs.find(26) != &*lhs.find(26));
+      assertUnit(rhs.bucket_count() == lhs.bucket_count());
+   }  // teardown
+
+   // the destructor frees every element
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::unordered_set<Spy, SpyHash> s;
+         for (int i = 0; i < 20; i++)
+            s.insert(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 20);
+   }  // teardown
+
+   /***************************************
+    * INSERT and FIND
+    ***************************************/
+
+   // a new key goes in the bucket it hashes to
+   void test_insert_new()
+   {  // setup
+      custom::unordered_set<int> s;
+      // exercise
+      auto result = s.insert(26);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 26);
+      assertUnit(s.size() == 1);
+      assertUnit(s.bucket_size(s.bucket(26)) == 1);
+      assertUnit(*s.begin(s.bucket(26)) == 26);
+   }  // teardown
+
+   // a key already there is left alone
+   void test_insert_duplicate()
+   {  // setup
+      custom::unordered_set<int> s{ 26 };
+      int * p26 = &*s.find(26);
+      // exercise
+      auto result = s.insert(26);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(&*result.first == p26);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // a key not there is not found
+   void test_find_missing()
+   {  // setup
+      custom::unordered_set<int> s{ 11, 26, 31 };
+      // exercise and verify
+      assertUnit(s.find(99) == s.end());
+      assertUnit(s.count(99) == 0);
+      assertUnit(s.count(11) == 1);
+   }  // teardown
+
+   // iterating visits every element once, skipping empty buckets
+   void test_iterator_visitsAll()
+   {  // setup
+      custom::unordered_set<int> s;
+      for (int i = 0; i < 100; i += 3)
+         s.insert(i);
+      // exercise
+      std::vector<int> v = toSortedVector(s);
+      // verify
+      bool all = v.size() == 34;
+      for (size_t i = 0; all && i < v.size(); i++)
+         all = v[i] == (int)i * 3;
+      assertUnit(all);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase by key says whether it was there
+   void test_erase_key()
+   {  // setup
+      custom::unordered_set<int> s{ 11, 26, 31 };
+      // exercise
+      size_t numFirst = s.erase(26);
+      size_t numSecond = s.erase(26);
+      // verify
+      assertUnit(numFirst == 1);
+      assertUnit(numSecond == 0);
+      assertUnit(toSortedVector(s) == std::vector<int>({ 11, 31 }));
+   }  // teardown
+
+   // erasing while iterating moves on to the next element
+   void test_erase_iterator()
+   {  // setup
+      custom::unordered_set<int> s;
+      for (int i = 0; i < 50; i++)
+         s.insert(i);
+      // exercise
+      for (auto it = s.begin(); it != s.end(); )
+         if (*it % 2)
+            it = s.erase(it);
+         else
+            ++it;
+      // verify
+      std::vector<int> v = toSortedVector(s);
+      bool evens = v.size() == 25;
+      for (size_t i = 0; evens && i < v.size(); i++)
+         evens = v[i] == (int)i * 2;
+      assertUnit(evens);
+      assertUnit(s.size() == 25);
+   }  // teardown
+
+   /***************************************
+    * BUCKETS
+    ***************************************/
+
+   // every bucket draws from the one pool
+   void test_bucket_sharesPool()
+   {  // setup
+      custom::unordered_set<int> s;
+      // exercise
+      for (int i = 0; i < 5; i++)
+         s.insert(i);
+      // verify
+      bool shared = true;
+      for (auto & b : s.buckets)
+         shared = shared && &b.pool() == &s.spare.pool();
+      assertUnit(shared);
+      assertUnit(s.spare.pool().pSlabs != nullptr);
+   }  // teardown
+
+   // growing moves nodes, not elements
+   void test_rehash_relinks()
+   {  // setup
+      custom::unordered_set<int> s;
+      std::vector<int *> before;
+      for (int i = 0; i < 8; i++)
+         before.push_back(&*s.insert(i).first);
+      // exercise
+      s.rehash(64);
+      // verify
+      assertUnit(s.bucket_count() == 64);
+      bool same = true;
+      for (int i = 0; i < 8; i++)
+         same = same && &*s.find(i) == before[i];
+      assertUnit(same);
+      bool placed = true;
+      for (size_t b = 0; b < s.bucket_count(); b++)
+         for (auto it = s.begin(b); it != s.end(b); ++it)
+            placed = placed && s.bucket(*it) == b;
+      assertUnit(placed);
+   }  // teardown
+
+   // the table grows to stay under the max load factor
+   void test_maxLoadFactor_grows()
+   {  // setup
+      custom::unordered_set<int> s;
+      s.max_load_factor(0.5f);
+      // exercise
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.load_factor() <= 0.5f);
+      assertUnit(s.size() == 100);
+      s.max_load_factor(4.0f);
+      assertUnit(s.load_factor() <= 4.0f);
+   }  // teardown
+
+   // after reserve, inserting needs no new buckets or slabs
+   void test_reserve_noAllocation()
+   {  // setup
+      custom::unordered_set<int> s;
+      s.reserve(100);
+      size_t numBuckets = s.bucket_count();
+      auto * pSlabs = s.spare.pool().pSlabs;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.bucket_count() == numBuckets);
+      assertUnit(numBuckets >= 100);
+      assertUnit(s.spare.pool().pSlabs == pSlabs);
+      assertUnit(s.spare.pool().numFree == 0);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // [] adds a default value the first time
+   void test_map_squareBracket()
+   {  // setup
+      custom::unordered_map<std::string, int> m;
+      // exercise
+      m["eleven"] = 11;
+      m["twenty-six"] += 26;
+      m["eleven"]++;
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m["eleven"] == 12);
+      assertUnit(m.find("twenty-six")->second == 26);
+   }  // teardown
+
+   // at only finds keys that are there
+   void test_map_at()
+   {  // setup
+      custom::unordered_map<int, std::string> m{ { 11, "eleven" }, { 26, "twenty-six" } };
+      // exercise
+      bool thrown = false;
+      try
+      {
+         m.at(31);
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(m.at(26) == "twenty-six");
+      assertUnit(m.count(31) == 0);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   struct SpyHash
+   {
+      size_t operator () (const Spy & s) const { return std::hash<int>()(s.get()); }
+   };
+
+   template <class Set>
+   std::vector<int> toSortedVector(Set & s)
+   {
+      std::vector<int> v;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         v.push_back(*it);
+      std::sort(v.begin(), v.end());
+      return v;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,225 @@
+/***********************************************************************
+ * Header:
+ *    TEST HAZARD
+ * Summary:
+ *    Unit tests for hazard_domain and hazard_pointer
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "hazard.h"
+#include "unitTest.h"
+
+#include <new>
+#include <thread>
+
+class TestHazard : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Retire
+      test_retire_unguarded();
+      test_retire_guarded();
+      test_retire_amortized();
+      test_destructor_freesRetired();
+
+      // Slots
+      test_hazardPointer_slotsReused();
+      test_hazardPointer_tooMany();
+      test_hazardPointer_protect();
+
+      // Records
+      test_record_reusedAfterExit();
+      test_record_domainRebuiltAtSameAddress();
+
+      report("Hazard");
+   }
+
+   /***************************************
+    * RETIRE
+    ***************************************/
+
+   // nothing guards it, so a scan frees it
+   void test_retire_unguarded()
+   {  // setup
+      int numDeleted = 0;
+      custom::hazard_domain domain;
+      // exercise
+      domain.retire(&numDeleted, countDelete);
+      domain.scan();
+      // verify
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   // a guarded node waits until the guard lets go
+   void test_retire_guarded()
+   {  // setup
+      int numDeleted = 0;
+      custom::hazard_domain domain;
+      {
+         custom::hazard_pointer hp(domain);
+         hp.set(&numDeleted);
+         // exercise
+         domain.retire(&numDeleted, countDelete);
+         domain.scan();
+         // verify
+         assertUnit(numDeleted == 0);
+      }
+      domain.scan();
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   // retire only scans once the list has grown
+   void test_retire_amortized()
+   {  // setup
+      std::vector<int> counters(1000, 0);
+      custom::hazard_domain domain;
+      // exercise
+      for (int & counter : counters)
+         domain.retire(&counter, countDelete);
+      // verify
+      int numDeleted = 0;
+      for (int counter : counters)
+         numDeleted += counter;
+      assertUnit(numDeleted > 900);
+      assertUnit(domain.record()->retired.size() < 100);
+   }  // teardown
+
+   // whatever is left is freed with the domain
+   void test_destructor_freesRetired()
+   {  // setup
+      int numDeleted = 0;
+      {
+         custom::hazard_domain domain;
+         custom::hazard_pointer hp(domain);
+         hp.set(&numDeleted);
+         domain.retire(&numDeleted, countDelete);
+         domain.scan();
+         assertUnit(numDeleted == 0);
+      }  // exercise
+      // verify
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   /***************************************
+    * HAZARD POINTER
+    ***************************************/
+
+   // a slot goes back when its hazard pointer does
+   void test_hazardPointer_slotsReused()
+   {  // setup
+      custom::hazard_domain domain;
+      unsigned int slot;
+      {
+         custom::hazard_pointer hp(domain);
+         slot = hp.slot;
+      }
+      // exercise
+      custom::hazard_pointer hp(domain);
+      // verify
+      assertUnit(hp.slot == slot);
+      assertUnit(hp.pRecord->used == (1u << slot));
+   }  // teardown
+
+   // a thread can only hold SLOTS at once
+   void test_hazardPointer_tooMany()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::hazard_pointer hp0(domain);
+      custom::hazard_pointer hp1(domain);
+      custom::hazard_pointer hp2(domain);
+      custom::hazard_pointer hp3(domain);
+      // exercise
+      bool thrown = false;
+      try
+      {
+         custom::hazard_pointer hp4(domain);
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // protect publishes what the source points to
+   void test_hazardPointer_protect()
+   {  // setup
+      custom::hazard_domain domain;
+      int value = 99;
+      std::atomic<int *> src(&value);
+      custom::hazard_pointer hp(domain);
+      // exercise
+      int * p = hp.protect(src);
+      // verify
+      assertUnit(p == &value);
+      assertUnit(hp.pRecord->slots[hp.slot].load() == &value);
+      hp.clear();
+      assertUnit(hp.pRecord->slots[hp.slot].load() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * RECORD
+    ***************************************/
+
+   // a thread that exits hands its record to the next one
+   void test_record_reusedAfterExit()
+   {  // setup
+      int numDeleted = 0;
+      custom::hazard_domain domain;
+      std::thread([&]() { custom::hazard_pointer hp(domain); }).join();
+      // exercise
+      std::thread([&]()
+      {
+         custom::hazard_pointer hp(domain);
+         domain.retire(&numDeleted, countDelete);
+      }).join();
+      // verify
+      assertUnit(domain.numRecords.load() == 1);
+      assertUnit(numDeleted == 1);
+   }  // teardown
+
+   // a domain destroyed on another thread and built again at the
+   // same address gives this thread a new record, not the freed one
+   void test_record_domainRebuiltAtSameAddress()
+   {  // setup
+      alignas(custom::hazard_domain) unsigned char buffer[sizeof(custom::hazard_domain)];
+      int numDeleted = 0;
+      auto & records = custom::hazard_domain::owner().records;
+      size_t numRecords = records.size();
+      // exercise
+      for (int i = 0; i < 20; i++)
+      {
+         custom::hazard_domain * pDomain = new (buffer) custom::hazard_domain;
+         {
+            custom::hazard_pointer hp(*pDomain);
+            hp.set(&numDeleted);
+         }
+         pDomain->retire(&numDeleted, countDelete);
+         std::thread([&]() { pDomain->~hazard_domain(); }).join();
+      }
+      // verify
+      assertUnit(numDeleted == 20);
+      assertUnit(records.size() <= numRecords + 1);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   // each "node" is a counter of how many times it was freed
+   static void countDelete(void * p)
+   {
+      (*static_cast<int *>(p))++;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,360 @@
+/***********************************************************************
+ * Header:
+ *    TEST INDEXED LIST
+ * Summary:
+ *    Unit tests for indexed_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "indexedList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <vector>
+
+class TestIndexedList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_copy();
+      test_destructor_spy();
+
+      // Insert
+      test_insert_sorted();
+      test_insert_duplicatesStable();
+      test_insert_hint();
+      test_insert_wrongHint();
+
+      // Access
+      test_find_present();
+      test_find_missing();
+      test_at_everyIndex();
+      test_at_outOfRange();
+
+      // Erase
+      test_erase_middle();
+      test_erase_everything();
+
+      // Iterator
+      test_iterator_backwards();
+
+      report("IndexedList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list is a sentinel with one level
+   void test_construct_default()
+   {  // exercise
+      custom::indexed_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.numLevels == 1);
+      assertUnit(l.head.links[0].pNext == nullptr);
+      assertUnit(l.head.links[0].width == 1);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // a copy has the same elements and a sound index of its own
+   void test_construct_copy()
+   {  // setup
+      custom::indexed_list<int> lhs;
+      for (int i = 0; i < 100; i++)
+         lhs.insert((i * 37) % 100);
+      // exercise
+      custom::indexed_list<int> rhs(lhs);
+      // verify
+      assertUnit(toVector(rhs) == toVector(lhs));
+      assertUnit(isSound(rhs));
+      assertUnit(rhs.head.links[0].pNext != lhs.head.links[0].pNext);
+   }  // teardown
+
+   // the destructor frees every node
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::indexed_list<Spy> l;
+         for (int i = 0; i < 50; i++)
+            l.insert(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 50);
+      assertUnit(Spy::numDelete() == 50);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // elements come out in order whatever order they went in
+   void test_insert_sorted()
+   {  // setup
+      custom::indexed_list<int> l;
+      std::vector<int> v;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         int value = (i * 7919) % 1000;
+         l.insert(value);
+         v.push_back(value);
+      }
+      // verify
+      std::sort(v.begin(), v.end());
+      assertUnit(toVector(l) == v);
+      assertUnit(l.size() == 1000);
+      assertUnit(l.front() == 0);
+      assertUnit(l.back() == 999);
+      assertUnit(isSound(l));
+      assertUnit(l.numLevels > 1);
+   }  // teardown
+
+   // an equal element goes after those already there
+   void test_insert_duplicatesStable()
+   {  // setup
+      custom::indexed_list<Spy> l;
+      l.insert(Spy(11));
+      auto it26 = l.insert(Spy(26));
+      l.insert(Spy(31));
+      // exercise
+      auto itAgain = l.insert(Spy(26));
+      // verify
+      assertUnit(itAgain != it26);
+      auto it = it26;
+      ++it;
+      assertUnit(it == itAgain);
+      assertUnit(l.find(Spy(26)) == it26);
+   }  // teardown
+
+   // a good hint puts the element right before it
+   void test_insert_hint()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 200; i += 2)
+         l.insert(i);
+      // exercise
+      for (int i = 1; i < 200; i += 2)
+         l.insert(l.find(i + 1) == l.end() ? l.end() : l.find(i + 1), i);
+      // verify
+      std::vector<int> v = toVector(l);
+      bool inOrder = v.size() == 200;
+      for (size_t i = 0; inOrder && i < v.size(); i++)
+         inOrder = v[i] == (int)i;
+      assertUnit(inOrder);
+      assertUnit(isSound(l));
+   }  // teardown
+
+   // a bad hint is ignored
+   void test_insert_wrongHint()
+   {  // setup
+      custom::indexed_list<int> l;
+      l.insert(11);
+      l.insert(26);
+      l.insert(31);
+      // exercise
+      auto it = l.insert(l.begin(), 99);
+      // verify
+      assertUnit(*it == 99);
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31, 99 }));
+      assertUnit(isSound(l));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find lands on the element
+   void test_find_present()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 500; i++)
+         l.insert(3 * i);
+      // exercise and verify
+      bool found = true;
+      for (int i = 0; i < 500; i++)
+      {
+         auto it = l.find(3 * i);
+         found = found && it != l.end() && *it == 3 * i;
+      }
+      assertUnit(found);
+   }  // teardown
+
+   // find misses between the elements and past either end
+   void test_find_missing()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 500; i++)
+         l.insert(3 * i);
+      // exercise and verify
+      assertUnit(l.find(-1) == l.end());
+      assertUnit(l.find(1) == l.end());
+      assertUnit(l.find(1498) == l.end());
+      assertUnit(l.find(9999) == l.end());
+   }  // teardown
+
+   // at agrees with a walk from the front
+   void test_at_everyIndex()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 1000; i++)
+         l.insert((i * 7919) % 1000 * 2);
+      // exercise and verify
+      bool agrees = true;
+      size_t i = 0;
+      for (auto it = l.begin(); it != l.end(); ++it, i++)
+         agrees = agrees && &l.at(i) == &*it;
+      assertUnit(agrees);
+      assertUnit(l.at(0) == 0);
+      assertUnit(l.at(999) == 1998);
+   }  // teardown
+
+   // at past the back throws
+   void test_at_outOfRange()
+   {  // setup
+      custom::indexed_list<int> l;
+      l.insert(11);
+      // exercise
+      bool thrown = false;
+      try
+      {
+         l.at(1);
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase relinks every level and returns the next element
+   void test_erase_middle()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 300; i++)
+         l.insert(i);
+      // exercise
+      for (int i = 0; i < 300; i += 3)
+      {
+         auto it = l.erase(l.find(i));
+         assertUnit(*it == i + 1);
+      }
+      // verify
+      assertUnit(l.size() == 200);
+      assertUnit(isSound(l));
+      assertUnit(l.at(0) == 1);
+      assertUnit(l.at(2) == 4);
+      assertUnit(l.find(3) == l.end());
+   }  // teardown
+
+   // erasing every element leaves an empty list that still works
+   void test_erase_everything()
+   {  // setup
+      custom::indexed_list<Spy> l;
+      for (int i = 0; i < 100; i++)
+         l.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      while (!l.empty())
+         l.erase(l.size() % 2 ? l.begin() : l.find(l.back()));
+      // verify
+      assertUnit(Spy::numDelete() == 100);
+      assertUnit(l.numLevels == 1);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.head.links[0].width == 1);
+      l.insert(Spy(11));
+      assertUnit(l.front().get() == 11);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // the base chain is linked both ways
+   void test_iterator_backwards()
+   {  // setup
+      custom::indexed_list<int> l;
+      for (int i = 0; i < 100; i++)
+         l.insert(i);
+      // exercise
+      std::vector<int> v;
+      auto it = l.find(99);
+      for (int i = 0; i < 100; i++)
+         v.push_back(*it--);
+      // verify
+      bool descending = true;
+      for (int i = 0; i < 100; i++)
+         descending = descending && v[i] == 99 - i;
+      assertUnit(descending);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   template <class T>
+   std::vector<T> toVector(custom::indexed_list<T> & l)
+   {
+      std::vector<T> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+
+   // every level is linked both ways and its jumps add up
+   template <class T>
+   bool isSound(custom::indexed_list<T> & l)
+   {
+      typedef typename custom::indexed_list<T>::Tower Tower;
+      std::vector<Tower *> base;
+      base.push_back(&l.head);
+      for (auto * p = l.head.links[0].pNext; p; p = p->links[0].pNext)
+         base.push_back(p);
+      if (base.size() != l.size() + 1 || (l.size() && base.back() != l.pTail))
+         return false;
+
+      for (int k = 0; k < l.numLevels; k++)
+      {
+         size_t pos = 0;
+         Tower * pPrev = &l.head;
+         while (true)
+         {
+            auto * pNext = base[pos]->links[k].pNext;
+            size_t posNext = pos + base[pos]->links[k].width;
+            if (!pNext)
+            {
+               if (posNext != base.size())
+                  return false;
+               break;
+            }
+            if (posNext >= base.size() || base[posNext] != pNext ||
+                pNext->links[k].pPrev != pPrev || pNext->height <= k)
+               return false;
+            pos = posNext;
+            pPrev = pNext;
+         }
+      }
+      return true;
+   }
+};
+
+#endif // DEBUG
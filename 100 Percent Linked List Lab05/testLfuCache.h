@@ -0,0 +1,309 @@
+/***********************************************************************
+ * Header:
+ *    TEST LFU CACHE
+ * Summary:
+ *    Unit tests for lfu_cache
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lfuCache.h"
+#include "unitTest.h"
+
+#include <string>
+#include <vector>
+
+class TestLfuCache : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_reserves();
+
+      // Get and put
+      test_get_miss();
+      test_put_startsAtOne();
+      test_get_promotes();
+      test_get_aloneBucketMovesUp();
+      test_put_update();
+      test_contains_noUse();
+
+      // Eviction
+      test_evict_leastFrequent();
+      test_evict_leastRecentOfTies();
+      test_evict_recyclesNode();
+      test_capacity_zero();
+
+      // Erase
+      test_erase_key();
+      test_clear();
+
+      report("LfuCache");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the nodes and buckets are made up front
+   void test_construct_reserves()
+   {  // exercise
+      custom::lfu_cache<int, std::string> cache(100);
+      // verify
+      assertUnit(cache.empty());
+      assertUnit(cache.capacity() == 100);
+      assertUnit(cache.spare.capacity() >= 100);
+      assertUnit(cache.buckets.capacity() >= 101);
+      assertUnit(cache.index.bucket_count() >= 100);
+   }  // teardown
+
+   /***************************************
+    * GET and PUT
+    ***************************************/
+
+   // a missing key gives NULL
+   void test_get_miss()
+   {  // setup
+      custom::lfu_cache<int, std::string> cache(2);
+      cache.put(11, "eleven");
+      // exercise and verify
+      assertUnit(cache.get(26) == nullptr);
+   }  // teardown
+
+   // new keys share the bucket for one use, most recent first
+   void test_put_startsAtOne()
+   {  // exercise
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // verify
+      assertUnit(layout(cache) == "1:26,11");
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // a hit moves the same node up a bucket
+   void test_get_promotes()
+   {  // setup
+      custom::lfu_cache<int, std::string> cache(3);
+      cache.put(11, "eleven");
+      cache.put(26, "twenty-six");
+      cache.put(31, "thirty-one");
+      std::pair<int, std::string> * p26 = &*cache.index.find(26)->second.entry;
+      // exercise
+      std::string * pValue = cache.get(26);
+      // verify
+      assertUnit(pValue != nullptr);
+      assertUnit(*pValue == "twenty-six");
+      assertUnit(&cache.buckets.back().entries.front() == p26);
+      assertUnit(layout(cache) == "1:31,11 2:26");
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // a lone entry with nowhere to go takes its bucket along
+   void test_get_aloneBucketMovesUp()
+   {  // setup
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.get(11);
+      cache.put(26, 2);
+      // exercise
+      cache.get(11);
+      cache.get(26);
+      // verify
+      assertUnit(layout(cache) == "2:26 3:11");
+      assertUnit(cache.buckets.size() == 2);
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // putting a key already there updates it and counts a use
+   void test_put_update()
+   {  // setup
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise
+      cache.put(11, 99);
+      // verify
+      assertUnit(cache.size() == 2);
+      assertUnit(layout(cache) == "1:26 2:11");
+      assertUnit(*cache.get(11) == 99);
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // contains is only a peek
+   void test_contains_noUse()
+   {  // setup
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise and verify
+      assertUnit(cache.contains(11));
+      assertUnit(!cache.contains(31));
+      assertUnit(layout(cache) == "1:26,11");
+   }  // teardown
+
+   /***************************************
+    * EVICTION
+    ***************************************/
+
+   // a full cache forgets the least used
+   void test_evict_leastFrequent()
+   {  // setup
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.put(31, 3);
+      cache.get(11);
+      cache.get(31);
+      // exercise
+      cache.put(42, 4);
+      // verify
+      assertUnit(cache.size() == 3);
+      assertUnit(!cache.contains(26));
+      assertUnit(layout(cache) == "1:42 2:31,11");
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // among the least used, the least recent goes first
+   void test_evict_leastRecentOfTies()
+   {  // setup
+      custom::lfu_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.put(31, 3);
+      cache.get(11);
+      cache.get(26);
+      cache.get(31);
+      // exercise
+      cache.put(42, 4);
+      // verify
+      assertUnit(!cache.contains(11));
+      assertUnit(layout(cache) == "1:42 2:31,26");
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // the victim's node carries the new entry, and nothing is allocated
+   void test_evict_recyclesNode()
+   {  // setup
+      custom::lfu_cache<int, int> cache(2);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.get(11);
+      cache.get(26);
+      std::pair<int, int> * pVictim = &cache.buckets.front().entries.back();
+      size_t numFree = cache.spare.pool().numFree;
+      size_t numBuckets = cache.buckets.capacity();
+      // exercise
+      cache.put(31, 3);
+      cache.put(42, 4);
+      // verify
+      assertUnit(pVictim->first == 42 || pVictim->first == 31);
+      assertUnit(layout(cache) == "1:42 2:26");
+      assertUnit(cache.spare.pool().numFree == numFree);
+      assertUnit(cache.buckets.capacity() == numBuckets);
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // a cache with no room holds nothing
+   void test_capacity_zero()
+   {  // setup
+      custom::lfu_cache<int, int> cache(0);
+      // exercise
+      cache.put(11, 1);
+      // verify
+      assertUnit(cache.empty());
+      assertUnit(cache.get(11) == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erasing the last entry of a bucket lets the bucket go
+   void test_erase_key()
+   {  // setup
+      custom::lfu_cache<int, int> cache(2);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.get(11);
+      // exercise
+      bool erased = cache.erase(11);
+      bool again = cache.erase(11);
+      cache.put(31, 3);
+      // verify
+      assertUnit(erased);
+      assertUnit(!again);
+      assertUnit(layout(cache) == "1:31,26");
+      assertUnit(isSound(cache));
+   }  // teardown
+
+   // clear keeps the nodes for reuse
+   void test_clear()
+   {  // setup
+      custom::lfu_cache<int, int> cache(4);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.get(26);
+      // exercise
+      cache.clear();
+      cache.put(31, 3);
+      // verify
+      assertUnit(cache.size() == 1);
+      assertUnit(layout(cache) == "1:31");
+      assertUnit(cache.spare.pool().numFree == 3);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   // each bucket as "uses:key,key", fewest uses first
+   template <class V>
+   std::string layout(custom::lfu_cache<int, V> & cache)
+   {
+      std::string s;
+      for (auto itB = cache.buckets.begin(); itB != cache.buckets.end(); ++itB)
+      {
+         s += (s.empty() ? "" : " ") + std::to_string((*itB).uses) + ":";
+         bool first = true;
+         for (auto it = (*itB).entries.begin(); it != (*itB).entries.end(); ++it)
+         {
+            s += (first ? "" : ",") + std::to_string((*it).first);
+            first = false;
+         }
+      }
+      return s;
+   }
+
+   // buckets in order and never empty, and the index matches them
+   template <class V>
+   bool isSound(custom::lfu_cache<int, V> & cache)
+   {
+      size_t num = 0;
+      size_t uses = 0;
+      for (auto itB = cache.buckets.begin(); itB != cache.buckets.end(); ++itB)
+      {
+         if ((*itB).uses <= uses || (*itB).entries.empty())
+            return false;
+         uses = (*itB).uses;
+         for (auto it = (*itB).entries.begin(); it != (*itB).entries.end(); ++it)
+         {
+            auto itIndex = cache.index.find((*it).first);
+            if (itIndex == cache.index.end() ||
+                itIndex->second.bucket != itB || itIndex->second.entry != it)
+               return false;
+            num++;
+         }
+      }
+      return num == cache.index.size();
+   }
+};
+
+#endif // DEBUG
@@ -11,8 +11,25 @@
 #define DEBUG   
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
+ //#define BENCHMARK  // Remove this comment to run the benchmarks
 
 #include "testList.h"       // for the spy unit tests
+#include "testUnrolledList.h" // for the unrolled list unit tests
+#include "testHazard.h"       // for the hazard pointer unit tests
+#include "testConcurrentList.h" // for the lock-free list unit tests
+#include "testMpmcListQueue.h"  // for the lock-free queue unit tests
+#include "testSpscList.h"       // for the single-producer list unit tests
+#include "testLockedList.h"     // for the hand-over-hand list unit tests
+#include "testEpoch.h"          // for the epoch reclamation unit tests
+#include "testRcuList.h"        // for the read-copy-update list unit tests
+#include "testMagazine.h"       // for the node cache unit tests
+#include "testIndexedList.h"    // for the indexed list unit tests
+#include "testHash.h"           // for the hash table unit tests
+#include "testLruCache.h"       // for the LRU cache unit tests
+#include "testLfuCache.h"       // for the LFU cache unit tests
+#include "testPersistentList.h" // for the persistent list unit tests
+#include "benchList.h"      // for the benchmarks
+int Spy::counters[] = {};
 
 
 /**********************************************************************
@@ -24,7 +41,26 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestList().run();
+   TestUnrolledList().run();
+   TestHazard().run();
+   TestConcurrentList().run();
+   TestMpmcListQueue().run();
+   TestSpscList().run();
+   TestLockedList().run();
+   TestEpoch().run();
+   TestRcuList().run();
+   TestMagazine().run();
+   TestIndexedList().run();
+   TestHash().run();
+   TestLruCache().run();
+   TestLfuCache().run();
+   TestPersistentList().run();
 #endif // DEBUG
+
+#ifdef BENCHMARK
+   // timings
+   BenchList().run();
+#endif // BENCHMARK
    
    return 0;
 }
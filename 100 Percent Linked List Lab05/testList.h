@@ -14,12 +14,67 @@
 #include "list.h"
 #include <list>
 #include "unitTest.h"
+#include "spy.h"
 
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <thread>
 #include <iostream>
 
+/***************************************
+ * COUNTING ALLOCATOR
+ * A stateful allocator that records how many
+ * times the list asked it for memory
+ ***************************************/
+struct AllocCount
+{
+   int numAllocate   = 0;
+   int numDeallocate = 0;
+};
+
+template <typename T>
+struct CountingAllocator
+{
+   typedef T value_type;
+   AllocCount * pCount;
+
+   CountingAllocator(AllocCount * pCount) : pCount(pCount) {}
+   template <typename U>
+   CountingAllocator(const CountingAllocator<U> & rhs) : pCount(rhs.pCount) {}
+
+   T * allocate(size_t n)
+   {
+      pCount->numAllocate++;
+      return std::allocator<T>().allocate(n);
+   }
+   void deallocate(T * p, size_t n)
+   {
+      pCount->numDeallocate++;
+      std::allocator<T>().deallocate(p, n);
+   }
+
+   template <typename U>
+   bool operator == (const CountingAllocator<U> & rhs) const { return pCount == rhs.pCount; }
+   template <typename U>
+   bool operator != (const CountingAllocator<U> & rhs) const { return pCount != rhs.pCount; }
+};
+
+/***************************************
+ * POINT
+ * Something with no default constructor
+ ***************************************/
+struct Point
+{
+   Point(int x, int y) : x(x), y(y) {}
+   int x;
+   int y;
+};
+
+#undef assertContiguous
+#define assertContiguous(l, num) assertContiguousParameters(l, num, __LINE__, __FUNCTION__)
+
 class TestList : public UnitTest
 {
 public:
@@ -40,6 +95,10 @@ public:
       test_constructInit_standard();
       test_constructRange_empty();
       test_constructRange_standard();
+      test_construct_contiguousFill();
+      test_construct_contiguousSize();
+      test_construct_contiguousInit();
+      test_construct_contiguousRange();
       test_destructor_empty();
       test_destructor_standard();
 
@@ -49,6 +108,9 @@ public:
       test_assign_emptyToStandard();
       test_assign_smallToBig();
       test_assign_bigToSmall();
+      test_assign_reuseSameSize();
+      test_assign_reuseSmallToBig();
+      test_assign_reuseBigToSmall();
       test_assignInit_empty();
       test_assignInit_sameSize();
       test_assignInit_rightBigger();
@@ -62,6 +124,37 @@ public:
       test_iterator_dereference_read();
       test_iterator_dereference_update();
 
+      // Traverse
+      test_forEach_empty();
+      test_forEach_standard();
+      test_forEach_distances();
+      test_forEach_update();
+
+      // Sort
+      test_sort_empty();
+      test_sort_one();
+      test_sort_standard();
+      test_sort_reversed();
+      test_sort_matchesStd();
+      test_sort_stable();
+      test_sort_spy();
+
+      // Splice, merge and split
+      test_splice_emptyIntoEmpty();
+      test_splice_allFront();
+      test_splice_allEnd();
+      test_splice_rangeMiddle();
+      test_splice_rangeSameList();
+      test_splice_spy();
+      test_splice_sourceDestroyedFirst();
+      test_splice_poolsMerged();
+      test_merge_standard();
+      test_merge_stable();
+      test_merge_intoEmpty();
+      test_splitAt_middle();
+      test_splitAt_beginEnd();
+      test_splitAt_halvesOnTwoThreads();
+
       // Access
       test_front_empty();
       test_front_standardRead();
@@ -69,6 +162,12 @@ public:
       test_back_empty();
       test_back_standardRead();
       test_back_standardWrite();
+      test_at_standard();
+      test_at_outOfRange();
+      test_at_fingerNearby();
+      test_at_fingerAfterPushFront();
+      test_at_fingerAfterErase();
+      test_advance_standard();
 
       // Insert
       test_pushback_empty();
@@ -86,6 +185,15 @@ public:
       test_insertMove_empty();
       test_insertMove_standardFront();
       test_insertMove_standardMiddle();
+      test_pushback_copySpy();
+      test_pushback_moveSpy();
+      test_pushfront_moveSpy();
+      test_insertMove_spyMiddle();
+      test_insertMove_spyEnd();
+      test_emplaceback_spy();
+      test_emplacefront_spy();
+      test_emplace_spyMiddle();
+      test_emplace_noDefault();
 
       // Remove
       test_clear_empty();
@@ -105,6 +213,54 @@ public:
       test_empty_empty();
       test_empty_three();
 
+      // Allocator
+      test_allocator_pushback();
+      test_allocator_clear();
+      test_allocator_destructor();
+
+      // Node pool
+      test_reserve_empty();
+      test_reserve_smaller();
+      test_pool_churn();
+      test_pool_eraseReuse();
+      test_shrinkToFit_cleared();
+      test_shrinkToFit_partial();
+
+      // Compaction
+      test_fragmentation_fresh();
+      test_fragmentation_churned();
+      test_compact_empty();
+      test_compact_churned();
+      test_compact_spy();
+      test_compactStep_budget();
+      test_compactStep_eraseCursor();
+      test_compactStep_budgetOneMatchesCompact();
+      test_compactStep_grows();
+
+      // Reclamation
+      test_retire_eraseGuarded();
+      test_retire_popFrontPopBack();
+      test_retire_listDestroyedFirst();
+      test_retire_off();
+      test_retire_compactGuarded();
+      test_retire_compactStepGuarded();
+
+      // Copy on write
+      test_cow_offByDefault();
+      test_cow_copyShares();
+      test_cow_assignShares();
+      test_cow_readKeepsShare();
+      test_cow_rangeForKeepsShare();
+      test_cow_copyWrites();
+      test_cow_sourceWrites();
+      test_cow_eraseThroughOldIterator();
+      test_cow_assignThroughOldIterator();
+      test_cow_oldIteratorOnCopy();
+      test_cow_clearForgetsIterators();
+      test_cow_clearLetsGo();
+      test_cow_destroySourceFirst();
+      test_cow_allocatorBalanced();
+
       report("List");
    }
 
@@ -388,6 +544,46 @@ public:
    }
 
 
+   // the fill constructor lays the nodes out in one block, in order
+   void test_construct_contiguousFill()
+   {  // exercise
+      custom::list<int> l(size_t(100), 99);
+      // verify
+      assertUnit(l.numElements == 100);
+      assertUnit(l.back() == 99);
+      assertContiguous(l, 100);
+   }  // teardown
+
+   // the size constructor lays the nodes out in one block, in order
+   void test_construct_contiguousSize()
+   {  // exercise
+      custom::list<int> l(100);
+      // verify
+      assertUnit(l.numElements == 100);
+      assertUnit(l.back() == 0);
+      assertContiguous(l, 100);
+   }  // teardown
+
+   // the initializer list constructor lays the nodes out in one block
+   void test_construct_contiguousInit()
+   {  // exercise
+      custom::list<int> l{ 11, 26, 31 };
+      // verify
+      assertStandardFixture(l);
+      assertContiguous(l, 3);
+   }  // teardown
+
+   // the range constructor lays the nodes out in one block
+   void test_construct_contiguousRange()
+   {  // setup
+      std::vector<int> v(50, 7);
+      // exercise
+      custom::list<int> l(v.begin(), v.end());
+      // verify
+      assertUnit(l.numElements == 50);
+      assertContiguous(l, 50);
+   }  // teardown
+
    /***************************************
     * SIZE EMPTY 
     ***************************************/
@@ -448,6 +644,324 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // every new node comes from the list's allocator
+   void test_allocator_pushback()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      // exercise
+      l.push_back(11);
+      l.push_front(26);
+      l.insert(l.begin(), 31);
+      // verify
+      assertUnit(count.numAllocate == 1);    // one slab holds all three
+      assertUnit(count.numDeallocate == 0);
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // removed nodes stay in the pool rather than going back to the allocator
+   void test_allocator_clear()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      l.pop_front();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(count.numAllocate == 1);
+      assertUnit(count.numDeallocate == 0);
+      assertUnit(l.empty());
+      assertUnit(l.capacity() >= 3);
+   }  // teardown
+
+   // the destructor gives every slab back
+   void test_allocator_destructor()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      {
+         custom::list<int, CountingAllocator<int>> l(alloc);
+         for (int i = 0; i < 100; i++)
+            l.push_back(i);
+      } // exercise
+      // verify
+      assertUnit(count.numAllocate > 1);
+      assertUnit(count.numAllocate == count.numDeallocate);
+   }  // teardown
+
+   /***************************************
+    * NODE POOL
+    ***************************************/
+
+   // reserve carves all the nodes out of one block
+   void test_reserve_empty()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      // exercise
+      l.reserve(100);
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(count.numAllocate == 1);
+      assertUnit(l.capacity() == 100);
+      assertUnit(l.size() == 100);
+   }  // teardown
+
+   // reserving less than we have does nothing
+   void test_reserve_smaller()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      l.reserve(10);
+      // exercise
+      l.reserve(5);
+      // verify
+      assertUnit(count.numAllocate == 1);
+      assertUnit(l.capacity() == 10);
+      assertUnit(l.empty());
+   }  // teardown
+
+   // steady push_back / pop_front churn never goes to the allocator
+   void test_pool_churn()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      int numAllocate = count.numAllocate;
+      // exercise
+      for (int i = 10; i < 10000; i++)
+      {
+         l.push_back(i);
+         l.pop_front();
+      }
+      // verify
+      assertUnit(count.numAllocate == numAllocate);
+      assertUnit(count.numDeallocate == 0);
+      assertUnit(l.size() == 10);
+      assertUnit(l.front() == 9990);
+      assertUnit(l.back() == 9999);
+   }  // teardown
+
+   // erased nodes are handed out again
+   void test_pool_eraseReuse()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node * p = l.pHead->pNext;
+      custom::list<int>::iterator it;
+      it.p = p;
+      // exercise
+      l.erase(it);
+      l.push_back(99);
+      // verify
+      assertUnit(l.pTail == p);
+      assertUnit(l.pTail->data == 99);
+      assertUnit(l.size() == 3);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // shrink_to_fit releases the slabs nobody is using
+   void test_shrinkToFit_cleared()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      l.clear();
+      // exercise
+      l.shrink_to_fit();
+      // verify
+      assertUnit(count.numAllocate == count.numDeallocate);
+      assertUnit(l.capacity() == 0);
+      assertUnit(l.empty());
+   }  // teardown
+
+   // shrink_to_fit keeps any slab still holding an element
+   void test_shrinkToFit_partial()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::list<int, CountingAllocator<int>> l(alloc);
+      l.reserve(10);
+      l.push_back(11);
+      // exercise
+      l.shrink_to_fit();
+      // verify
+      assertUnit(count.numDeallocate == 0);
+      assertUnit(l.capacity() == 10);
+      assertUnit(l.front() == 11);
+   }  // teardown
+
+
+   /***************************************
+    * COMPACTION
+    ***************************************/
+
+   // a freshly built list has every node right after the last
+   void test_fragmentation_fresh()
+   {  // setup
+      custom::list<int> l(size_t(100), 99);
+      // exercise
+      double fragmentation = l.fragmentation();
+      // verify
+      assertUnit(fragmentation == 0.0);
+   }  // teardown
+
+   // churn scatters the nodes
+   void test_fragmentation_churned()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 100);
+      // exercise
+      double fragmentation = l.fragmentation();
+      // verify
+      assertUnit(fragmentation > 0.1);
+      assertUnit(fragmentation <= 1.0);
+   }  // teardown
+
+   // compacting nothing allocates nothing
+   void test_compact_empty()
+   {  // setup
+      custom::list<int> l;
+      // exercise
+      l.compact();
+      // verify
+      assertEmptyFixture(l);
+      assertUnit(l.pool().pSlabs == nullptr);
+      assertUnit(l.capacity() == 0);
+   }  // teardown
+
+   // compact puts the nodes back in order in one block
+   void test_compact_churned()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 100);
+      std::vector<int> before = toVector(l);
+      // exercise
+      l.compact();
+      // verify
+      assertUnit(toVector(l) == before);
+      assertUnit(l.fragmentation() == 0.0);
+      assertUnit(l.capacity() == l.size());
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertContiguous(l, l.size());
+   }  // teardown
+
+   // compact moves the payloads, never copies them
+   void test_compact_spy()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31, 42, 57 });
+      Spy::reset();
+      // exercise
+      l.compact();
+      // verify
+      assertUnit(Spy::numCopyMove() == 5);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(l.pHead->data.get() == 11);
+      assertUnit(l.pTail->data.get() == 57);
+   }  // teardown
+
+   // each step moves at most the budget
+   void test_compactStep_budget()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 25);
+      std::vector<int> before = toVector(l);
+      // exercise
+      bool done1 = l.compact_step(10);
+      bool done2 = l.compact_step(10);
+      bool done3 = l.compact_step(10);
+      // verify
+      assertUnit(done1 == false);
+      assertUnit(done2 == false);
+      assertUnit(done3 == true);
+      assertUnit(l.pCompact == nullptr);
+      assertUnit(toVector(l) == before);
+      assertUnit(l.fragmentation() <= 2.0 / 24.0);
+      assertUnit(l.capacity() == l.size());
+   }  // teardown
+
+   // erasing the node a step would resume at is harmless
+   void test_compactStep_eraseCursor()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 25);
+      l.compact_step(10);
+      std::vector<int> before = toVector(l);
+      before.erase(before.begin() + 10);
+      custom::list<int>::iterator it;
+      it.p = l.pCompact;
+      // exercise
+      l.erase(it);
+      while (!l.compact_step(10))
+         ;
+      // verify
+      assertUnit(toVector(l) == before);
+      assertUnit(l.size() == 24);
+   }  // teardown
+
+   // a pass one node at a time ends as contiguous as compact()
+   void test_compactStep_budgetOneMatchesCompact()
+   {  // setup
+      custom::list<int> lSteps;
+      custom::list<int> lWhole;
+      setupChurnedFixture(lSteps, 25);
+      setupChurnedFixture(lWhole, 25);
+      std::vector<int> before = toVector(lSteps);
+      // exercise
+      size_t numSteps = 1;
+      while (!lSteps.compact_step(1))
+         numSteps++;
+      lWhole.compact();
+      // verify
+      assertUnit(numSteps == 25);
+      assertUnit(lWhole.fragmentation() == 0.0);
+      assertUnit(lSteps.fragmentation() == lWhole.fragmentation());
+      assertUnit(toVector(lSteps) == before);
+      assertUnit(lSteps.capacity() == lSteps.size());
+   }  // teardown
+
+   // nodes added behind the cursor mid-pass still get room
+   void test_compactStep_grows()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 25);
+      l.compact_step(5);
+      std::vector<int> before = toVector(l);
+      // exercise
+      for (int i = 0; i < 10; i++)
+      {
+         l.push_back(100 + i);
+         before.push_back(100 + i);
+      }
+      while (!l.compact_step(5))
+         ;
+      // verify
+      assertUnit(toVector(l) == before);
+      assertUnit(l.pCompactEnd == nullptr);
+      assertUnit(l.capacity() == l.size());
+      assertUnit(l.fragmentation() <= 1.0 / 34.0);
+   }  // teardown
 
    /***************************************
     * ASSIGN
@@ -530,8 +1044,8 @@ public:
       //       | 85 | - | 99 |
       //       +----+   +----+
       custom::list<int> lDes;
-      custom::list<int>::Node* pDes1 = new custom::list<int>::Node(int(85));
-      custom::list<int>::Node* pDes2 = new custom::list<int>::Node(int(99));
+      custom::list<int>::Node* pDes1 = lDes.createNode(int(85));
+      custom::list<int>::Node* pDes2 = lDes.createNode(int(99));
       pDes1->pNext = pDes2;
       pDes2->pPrev = pDes1;
       lDes.pHead = pDes1;
@@ -576,10 +1090,10 @@ public:
       //       | 61 | - | 73 | - | 85 | - | 99 |
       //       +----+   +----+   +----+   +----+
       custom::list<int> lDes;
-      custom::list<int>::Node* lDes1 = new custom::list<int>::Node(int(61));
-      custom::list<int>::Node* lDes2 = new custom::list<int>::Node(int(73));
-      custom::list<int>::Node* lDes3 = new custom::list<int>::Node(int(85));
-      custom::list<int>::Node* lDes4 = new custom::list<int>::Node(int(99));
+      custom::list<int>::Node* lDes1 = lDes.createNode(int(61));
+      custom::list<int>::Node* lDes2 = lDes.createNode(int(73));
+      custom::list<int>::Node* lDes3 = lDes.createNode(int(85));
+      custom::list<int>::Node* lDes4 = lDes.createNode(int(99));
       lDes1->pNext = lDes2;
       lDes2->pNext = lDes3;
       lDes3->pNext = lDes4;
@@ -614,6 +1128,85 @@ public:
    }
 
 
+   // assigning onto a list of the same size reuses every node
+   void test_assign_reuseSameSize()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      custom::list<Spy> lDes;
+      setupSpyFixture(lDes, { 61, 73, 85 });
+      custom::list<Spy>::Node * p1 = lDes.pHead;
+      custom::list<Spy>::Node * p2 = p1->pNext;
+      custom::list<Spy>::Node * p3 = p2->pNext;
+      Spy::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numAssign() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(lDes.pHead == p1);
+      assertUnit(p1->pNext == p2);
+      assertUnit(p2->pNext == p3);
+      assertUnit(lDes.pTail == p3);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(p1->data.get() == 11);
+      assertUnit(p2->data.get() == 26);
+      assertUnit(p3->data.get() == 31);
+      assertUnit(p3->pNext == nullptr);
+   }  // teardown
+
+   // assigning a small list onto a big one frees only the surplus
+   void test_assign_reuseSmallToBig()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      custom::list<Spy> lDes;
+      setupSpyFixture(lDes, { 61, 73, 85, 99 });
+      custom::list<Spy>::Node * p3 = lDes.pHead->pNext->pNext;
+      Spy::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numAssign() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(lDes.pTail == p3);
+      assertUnit(lDes.pTail->pNext == nullptr);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(p3->data.get() == 31);
+   }  // teardown
+
+   // assigning a big list onto a small one allocates only the shortfall
+   void test_assign_reuseBigToSmall()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      custom::list<Spy> lDes;
+      setupSpyFixture(lDes, { 85, 99 });
+      custom::list<Spy>::Node * p1 = lDes.pHead;
+      custom::list<Spy>::Node * p2 = p1->pNext;
+      Spy::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(Spy::numAssign() == 2);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(lDes.pHead == p1);
+      assertUnit(p1->pNext == p2);
+      assertUnit(p2->pNext == lDes.pTail);
+      assertUnit(lDes.pTail->pPrev == p2);
+      assertUnit(lDes.pTail->pNext == nullptr);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(lDes.pTail->data.get() == 31);
+   }  // teardown
+
    /***************************************
     * ASSIGN INIT
     ***************************************/
@@ -661,7 +1254,7 @@ public:
       //       | 99 |
       //       +----+
       custom::list<int> l;
-      l.pHead = l.pTail = new custom::list<int>::Node(int(99));
+      l.pHead = l.pTail = l.createNode(int(99));
       l.numElements = 1;
       std::initializer_list<int> il{ int(11),int(26),int(31) };
       // exercise
@@ -684,10 +1277,10 @@ public:
       //       | 61 | - | 73 | - | 85 | - | 99 |
       //       +----+   +----+   +----+   +----+
       custom::list<int> l;
-      custom::list<int>::Node* p1 = new custom::list<int>::Node(int(61));
-      custom::list<int>::Node* p2 = new custom::list<int>::Node(int(73));
-      custom::list<int>::Node* p3 = new custom::list<int>::Node(int(85));
-      custom::list<int>::Node* p4 = new custom::list<int>::Node(int(99));
+      custom::list<int>::Node* p1 = l.createNode(int(61));
+      custom::list<int>::Node* p2 = l.createNode(int(73));
+      custom::list<int>::Node* p3 = l.createNode(int(85));
+      custom::list<int>::Node* p4 = l.createNode(int(99));
       p1->pNext = p2;
       p2->pNext = p3;
       p3->pNext = p4;
@@ -799,7 +1392,7 @@ public:
          {
             assertUnit(l.pTail->pPrev->pNext == l.pTail);
             l.pTail = l.pTail->pPrev;
-            delete l.pTail->pNext;
+            l.destroyNode(l.pTail->pNext);
             l.numElements--;
             l.pTail->pNext = nullptr;
          }
@@ -865,7 +1458,7 @@ public:
          {
             assertUnit(l.pTail->pPrev->pNext == l.pTail);
             l.pTail = l.pTail->pPrev;
-            delete l.pTail->pNext;
+            l.destroyNode(l.pTail->pNext);
             l.numElements--;
             l.pTail->pNext = nullptr;
          }
@@ -935,7 +1528,7 @@ public:
          {
             assertUnit(l.pHead->pNext->pPrev == l.pHead);
             l.pHead = l.pHead->pNext;
-            delete l.pHead->pPrev;
+            l.destroyNode(l.pHead->pPrev);
             l.numElements--;
             l.pHead->pPrev = nullptr;
          }
@@ -1001,7 +1594,7 @@ public:
          {
             assertUnit(l.pHead->pNext->pPrev == l.pHead);
             l.pHead = l.pHead->pNext;
-            delete l.pHead->pPrev;
+            l.destroyNode(l.pHead->pPrev);
             l.numElements--;
             l.pHead->pPrev = nullptr;
          }
@@ -1036,7 +1629,7 @@ public:
       //       +----+   +----+   +----+   +----+
       custom::list<int> l;
       setupStandardFixture(l);
-      custom::list<int>::Node* p = new custom::list<int>::Node(int(99));
+      custom::list<int>::Node* p = l.createNode(int(99));
       l.pTail->pNext = p;
       p->pPrev = l.pTail;
       l.pTail = p;
@@ -1080,7 +1673,7 @@ public:
       //       +----+   +----+   +----+   +----+
       custom::list<int> l;
       setupStandardFixture(l);
-      custom::list<int>::Node* p = new custom::list<int>::Node(int(99));
+      custom::list<int>::Node* p = l.createNode(int(99));
       l.pHead->pPrev = p;
       p->pNext = l.pHead;
       l.pHead = p;
@@ -1234,6 +1827,118 @@ public:
    }
 
 
+   /***************************************
+    * AT and ADVANCE
+    ***************************************/
+
+   // at reads and writes by index
+   void test_at_standard()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      l.at(1) = 99;
+      // verify
+      assertUnit(l.at(0) == 11);
+      assertUnit(l.at(1) == 99);
+      assertUnit(l.at(2) == 31);
+      assertUnit(l.pFinger == l.pTail);
+      assertUnit(l.iFinger == 2);
+      l.pHead->pNext->data = 26;
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // at past the back throws
+   void test_at_outOfRange()
+   {  // setup
+      custom::list<int> l{ 11, 26, 31 };
+      // exercise
+      bool thrown = false;
+      try
+      {
+         l.at(3);
+      }
+      catch (const char * error)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.pFinger == nullptr);
+   }  // teardown
+
+   // a lookup near the last one walks from the finger, either way
+   void test_at_fingerNearby()
+   {  // setup
+      custom::list<int> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      assertUnit(l.at(50) == 50);
+      custom::list<int>::Node * p50 = l.pFinger;
+      // exercise
+      int forward = l.at(52);
+      int back = l.at(49);
+      // verify
+      assertUnit(forward == 52);
+      assertUnit(back == 49);
+      assertUnit(l.pFinger == p50->pPrev);
+      assertUnit(l.iFinger == 49);
+   }  // teardown
+
+   // pushing on the front shifts the finger rather than losing it
+   void test_at_fingerAfterPushFront()
+   {  // setup
+      custom::list<int> l{ 11, 26, 31, 42 };
+      l.at(2);
+      custom::list<int>::Node * p31 = l.pFinger;
+      // exercise
+      l.push_front(5);
+      l.pop_front();
+      l.push_front(5);
+      l.push_back(99);
+      // verify
+      assertUnit(l.pFinger == p31);
+      assertUnit(l.iFinger == 3);
+      assertUnit(l.at(3) == 31);
+      assertUnit(l.at(1) == 11);
+   }  // teardown
+
+   // erasing forgets the finger, so nothing stale is reached
+   void test_at_fingerAfterErase()
+   {  // setup
+      custom::list<int> l{ 11, 26, 31, 42 };
+      l.at(2);
+      // exercise
+      l.erase(l.begin());
+      // verify
+      assertUnit(l.pFinger == nullptr);
+      assertUnit(l.at(2) == 42);
+      l.pop_back();
+      assertUnit(l.pFinger == nullptr);
+      assertUnit(l.at(1) == 31);
+   }  // teardown
+
+   // advance gives an iterator to walk on from, or end()
+   void test_advance_standard()
+   {  // setup
+      custom::list<int> l{ 11, 26, 31 };
+      // exercise
+      custom::list<int>::iterator it = l.advance(1);
+      custom::list<int>::iterator itEnd = l.advance(3);
+      // verify
+      assertUnit(*it == 26);
+      ++it;
+      assertUnit(*it == 31);
+      assertUnit(itEnd == l.end());
+   }  // teardown
+
+
     /***************************************
     * INSERT - Copy
     ***************************************/
@@ -1599,35 +2304,212 @@ public:
       teardownStandardFixture(l);
    }
 
+   // copying onto the back costs exactly one copy
+   void test_pushback_copySpy()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      l.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(l.pTail->data.get() == 99);
+      assertUnit(s.get() == 99);
+   }  // teardown
 
-   /***************************************
-    * ERASE
-    ***************************************/
+   // moving onto the back steals the payload: one move, no copy
+   void test_pushback_moveSpy()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      l.push_back(std::move(s));
+      // verify
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l.pTail->data.get() == 99);
+      assertUnit(s.empty());
+   }  // teardown
 
-   // erase an element from an empty list
-   void test_erase_empty()
+   // moving onto the front steals the payload: one move, no copy
+   void test_pushfront_moveSpy()
    {  // setup
-      custom::list<int> l;
-      custom::list<int>::iterator itErase;
-      custom::list<int>::iterator itReturn;
-      itErase.p = nullptr;
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      Spy s(99);
+      Spy::reset();
       // exercise
-      itReturn = l.erase(itErase);
+      l.push_front(std::move(s));
       // verify
-      assertUnit(itReturn.p == itErase.p);
-      assertUnit(itErase == l.end());
-      assertEmptyFixture(l);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l.pHead->data.get() == 99);
+      assertUnit(s.empty());
    }  // teardown
 
-   // erase the element from the front of a list
-   void test_erase_standardFront()
+   // moving into the middle steals the payload: one move, no copy
+   void test_insertMove_spyMiddle()
    {  // setup
-      custom::list<int>::iterator itErase;
-      custom::list<int>::iterator itReturn;
-      //        pHead             pTail
-      //       +----+   +----+   +----+
-      //       | 11 | - | 26 | - | 31 |
-      //       +----+   +----+   +----+
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      custom::list<Spy>::iterator it;
+      it.p = l.pHead->pNext;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      it = l.insert(it, std::move(s));
+      // verify
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(it.p == l.pHead->pNext);
+      assertUnit(it.p->data.get() == 99);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // moving onto the end steals the payload: one move, no copy
+   void test_insertMove_spyEnd()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::list<Spy>::iterator it = l.insert(l.end(), std::move(s));
+      // verify
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(it.p == l.pTail);
+      assertUnit(it.p->data.get() == 99);
+      assertUnit(s.empty());
+   }  // teardown
+
+
+   // emplacing onto the back builds the item in the node
+   void test_emplaceback_spy()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_back(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(&s == &l.pTail->data);
+      assertUnit(l.pTail->data.get() == 99);
+      assertUnit(l.pTail->pPrev->data.get() == 31);
+      assertUnit(l.numElements == 4);
+   }  // teardown
+
+   // emplacing onto the front builds the item in the node
+   void test_emplacefront_spy()
+   {  // setup
+      custom::list<Spy> l;
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_front(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(&s == &l.pHead->data);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pHead->data.get() == 99);
+      assertUnit(l.numElements == 1);
+   }  // teardown
+
+   // emplacing into the middle builds the item in the node
+   void test_emplace_spyMiddle()
+   {  // setup
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      custom::list<Spy>::iterator it;
+      it.p = l.pHead->pNext;
+      Spy::reset();
+      // exercise
+      it = l.emplace(it, 99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(it.p == l.pHead->pNext);
+      assertUnit(it.p->pPrev == l.pHead);
+      assertUnit(it.p->pNext->pPrev == it.p);
+      assertUnit(it.p->data.get() == 99);
+      assertUnit(l.numElements == 4);
+   }  // teardown
+
+   // T need not have a default constructor
+   void test_emplace_noDefault()
+   {  // setup
+      custom::list<Point> l;
+      // exercise
+      l.emplace_back(3, 4);
+      l.emplace_front(1, 2);
+      l.emplace(l.end(), 5, 6);
+      // verify
+      assertUnit(l.numElements == 3);
+      assertUnit(l.front().x == 1 && l.front().y == 2);
+      assertUnit(l.pHead->pNext->data.x == 3);
+      assertUnit(l.back().x == 5 && l.back().y == 6);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase an element from an empty list
+   void test_erase_empty()
+   {  // setup
+      custom::list<int> l;
+      custom::list<int>::iterator itErase;
+      custom::list<int>::iterator itReturn;
+      itErase.p = nullptr;
+      // exercise
+      itReturn = l.erase(itErase);
+      // verify
+      assertUnit(itReturn.p == itErase.p);
+      assertUnit(itErase == l.end());
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // erase the element from the front of a list
+   void test_erase_standardFront()
+   {  // setup
+      custom::list<int>::iterator itErase;
+      custom::list<int>::iterator itReturn;
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
       //         itErase
       custom::list<int> l;
       setupStandardFixture(l);
@@ -1909,6 +2791,953 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * FOR EACH
+    ***************************************/
+
+   // nothing to visit in an empty list
+   void test_forEach_empty()
+   {  // setup
+      custom::list<int> l;
+      int count = 0;
+      // exercise
+      l.for_each([&](int &) { count++; });
+      // verify
+      assertUnit(count == 0);
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // every element is visited front to back
+   void test_forEach_standard()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      std::vector<int> v;
+      // exercise
+      l.for_each([&](int & data) { v.push_back(data); });
+      // verify
+      assertUnit(v == std::vector<int>({ 11, 26, 31 }));
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // the prefetch distance does not change what is visited
+   void test_forEach_distances()
+   {  // setup
+      custom::list<int> l;
+      setupChurnedFixture(l, 100);
+      std::vector<int> expected = toVector(l);
+      // exercise and verify
+      for (size_t distance : { 0, 1, 4, 99, 100, 1000 })
+      {
+         std::vector<int> v;
+         l.for_each([&](int & data) { v.push_back(data); }, distance);
+         assertUnit(v == expected);
+      }
+   }  // teardown
+
+   // the function gets a reference it can change
+   void test_forEach_update()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      l.for_each([](int & data) { data += 1; });
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 12, 27, 32 }));
+      l.for_each([](int & data) { data -= 1; });
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /***************************************
+    * SORT
+    ***************************************/
+
+   // sorting nothing does nothing
+   void test_sort_empty()
+   {  // setup
+      custom::list<int> l;
+      // exercise
+      l.sort();
+      // verify
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // a single node stays put
+   void test_sort_one()
+   {  // setup
+      custom::list<int> l;
+      l.push_back(99);
+      auto pNode = l.pHead;
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(l.pHead == pNode);
+      assertUnit(l.pTail == pNode);
+      assertUnit(pNode->pNext == nullptr);
+      assertUnit(pNode->pPrev == nullptr);
+      assertUnit(l.numElements == 1);
+   }  // teardown
+
+   // the standard fixture is already sorted
+   void test_sort_standard()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      auto p11 = l.pHead;
+      auto p31 = l.pTail;
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(l.pHead == p11);
+      assertUnit(l.pTail == p31);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // the nodes themselves are relinked, back links and all
+   void test_sort_reversed()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      auto p11 = l.pHead;
+      auto p26 = l.pHead->pNext;
+      auto p31 = l.pTail;
+      l.sort([](int lhs, int rhs) { return lhs > rhs; });
+      assertUnit(toVector(l) == std::vector<int>({ 31, 26, 11 }));
+      assertUnit(l.pHead == p31);
+      assertUnit(l.pTail == p11);
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(l.pHead == p11);
+      assertUnit(l.pHead->pNext == p26);
+      assertUnit(l.pTail == p31);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // odd sizes leave a short run at the end of each pass
+   void test_sort_matchesStd()
+   {
+      unsigned int seed = 99;
+      for (int num : { 2, 3, 7, 64, 100, 1000 })
+      {  // setup
+         custom::list<int> l;
+         std::vector<int> v;
+         for (int i = 0; i < num; i++)
+         {
+            seed = seed * 1103515245 + 12345;
+            int value = (int)((seed >> 16) % 50);
+            l.push_back(value);
+            v.push_back(value);
+         }
+         std::sort(v.begin(), v.end());
+         // exercise
+         l.sort();
+         // verify
+         assertUnit(toVector(l) == v);
+         assertUnit(l.numElements == (size_t)num);
+         size_t count = 0;
+         for (auto p = l.pTail; p; p = p->pPrev)
+            count++;
+         assertUnit(count == (size_t)num);
+      }  // teardown
+   }
+
+   // equal keys keep their original order
+   void test_sort_stable()
+   {  // setup
+      custom::list<std::pair<int, int>> l;
+      std::vector<std::pair<int, int>> v;
+      for (int i = 0; i < 200; i++)
+      {
+         l.push_back(std::make_pair((i * 37) % 10, i));
+         v.push_back(std::make_pair((i * 37) % 10, i));
+      }
+      auto byKey = [](const std::pair<int, int> & lhs, const std::pair<int, int> & rhs)
+      {
+         return lhs.first < rhs.first;
+      };
+      std::stable_sort(v.begin(), v.end(), byKey);
+      // exercise
+      l.sort(byKey);
+      // verify
+      std::vector<std::pair<int, int>> sorted;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         sorted.push_back(*it);
+      assertUnit(sorted == v);
+   }  // teardown
+
+   // sort only compares; nothing is copied, moved, assigned or allocated
+   void test_sort_spy()
+   {  // setup
+      const int num = 256;
+      custom::list<Spy> l;
+      for (int i = 0; i < num; i++)
+         l.push_back(Spy((i * 97) % num));
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numSwap() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numLessthan() > 0);
+      assertUnit(Spy::numLessthan() <= num * 8);   // n log2 n
+      int prev = -1;
+      for (auto it = l.begin(); it != l.end(); ++it)
+      {
+         assertUnit(prev < (*it).get());
+         prev = (*it).get();
+      }
+   }  // teardown
+
+   /***************************************
+    * SPLICE, MERGE and SPLIT
+    ***************************************/
+
+   // nothing moves between two empty lists
+   void test_splice_emptyIntoEmpty()
+   {  // setup
+      custom::list<int> lDes;
+      custom::list<int> lSrc;
+      // exercise
+      lDes.splice(lDes.end(), lSrc);
+      // verify
+      assertEmptyFixture(lDes);
+      assertEmptyFixture(lSrc);
+   }  // teardown
+
+   // the whole source goes in front of the first node
+   void test_splice_allFront()
+   {  // setup
+      custom::list<int> lDes{ 11, 26, 31 };
+      custom::list<int> lSrc{ 1, 2 };
+      auto p1 = lSrc.pHead;
+      auto p2 = lSrc.pTail;
+      auto p11 = lDes.pHead;
+      // exercise
+      lDes.splice(lDes.begin(), lSrc);
+      // verify
+      assertUnit(toVector(lDes) == std::vector<int>({ 1, 2, 11, 26, 31 }));
+      assertUnit(lDes.numElements == 5);
+      assertUnit(lDes.pHead == p1);
+      assertUnit(p1->pPrev == nullptr);
+      assertUnit(p2->pNext == p11);
+      assertUnit(p11->pPrev == p2);
+      assertEmptyFixture(lSrc);
+   }  // teardown
+
+   // the whole source goes on the end
+   void test_splice_allEnd()
+   {  // setup
+      custom::list<int> lDes{ 11, 26, 31 };
+      custom::list<int> lSrc{ 1, 2 };
+      auto p2 = lSrc.pTail;
+      // exercise
+      lDes.splice(lDes.end(), lSrc);
+      // verify
+      assertUnit(toVector(lDes) == std::vector<int>({ 11, 26, 31, 1, 2 }));
+      assertUnit(lDes.numElements == 5);
+      assertUnit(lDes.pTail == p2);
+      assertUnit(lDes.pTail->pNext == nullptr);
+      assertUnit(lDes.pTail->pPrev->data == 1);
+      assertEmptyFixture(lSrc);
+   }  // teardown
+
+   // part of the source moves into the middle
+   void test_splice_rangeMiddle()
+   {  // setup
+      custom::list<int> lDes{ 11, 26, 31 };
+      custom::list<int> lSrc{ 1, 2, 3, 4, 5 };
+      auto first = lSrc.begin();
+      ++first;
+      auto last = first;
+      ++last;
+      ++last;
+      auto pos = lDes.begin();
+      ++pos;
+      // exercise
+      lDes.splice(pos, lSrc, first, last);
+      // verify
+      assertUnit(toVector(lDes) == std::vector<int>({ 11, 2, 3, 26, 31 }));
+      assertUnit(lDes.numElements == 5);
+      assertUnit(toVector(lSrc) == std::vector<int>({ 1, 4, 5 }));
+      assertUnit(lSrc.numElements == 3);
+      assertUnit(lSrc.pHead->pNext->pPrev == lSrc.pHead);
+      assertUnit(lDes.pTail->pPrev->pPrev->data == 3);
+   }  // teardown
+
+   // a range can move within the same list
+   void test_splice_rangeSameList()
+   {  // setup
+      custom::list<int> l{ 1, 2, 3, 4, 5 };
+      auto first = l.begin();
+      ++first;
+      ++first;
+      // exercise
+      l.splice(l.begin(), l, first, l.end());
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 3, 4, 5, 1, 2 }));
+      assertUnit(l.numElements == 5);
+      assertUnit(l.pHead->data == 3);
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.pTail->data == 2);
+      assertUnit(l.pTail->pNext == nullptr);
+   }  // teardown
+
+   // no element is copied, built or destroyed
+   void test_splice_spy()
+   {  // setup
+      custom::list<Spy> lDes;
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lDes, { 1, 5, 9 });
+      setupSpyFixture(lSrc, { 2, 3, 7, 8 });
+      Spy::reset();
+      // exercise
+      lDes.merge(lSrc);
+      custom::list<Spy> lSplit = lDes.split_at(lDes.begin());
+      lDes.splice(lDes.end(), lSplit);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(lDes.size() == 7);
+      assertUnit(lSrc.empty());
+      assertUnit(lSplit.empty());
+   }  // teardown
+
+   // the nodes survive the list they were carved from
+   void test_splice_sourceDestroyedFirst()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      {
+         custom::list<int, CountingAllocator<int>> lDes(alloc);
+         {
+            custom::list<int, CountingAllocator<int>> lSrc(alloc);
+            for (int i = 0; i < 20; i++)
+               lSrc.push_back(i);
+            // exercise
+            lDes.splice(lDes.end(), lSrc, lSrc.begin(), lSrc.end());
+            lSrc.push_back(99);
+         }
+         // verify
+         assertUnit(lDes.size() == 20);
+         assertUnit(lDes.back() == 19);
+         lDes.clear();
+         lDes.shrink_to_fit();
+         assertUnit(lDes.capacity() == 0);
+      }
+      assertUnit(count.numAllocate == count.numDeallocate);
+   }  // teardown
+
+   // four lists end up drawing from one pool
+   void test_splice_poolsMerged()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      {
+         custom::list<int, CountingAllocator<int>> lA(alloc);
+         custom::list<int, CountingAllocator<int>> lD(alloc);
+         {
+            custom::list<int, CountingAllocator<int>> lB(alloc);
+            custom::list<int, CountingAllocator<int>> lC(alloc);
+            lA.push_back(1);
+            lB.push_back(2);
+            lC.push_back(3);
+            lD.push_back(4);
+            // exercise
+            lA.splice(lA.end(), lB);
+            lD.splice(lD.end(), lC);
+            lB.push_back(5);
+            lC.push_back(6);
+            lB.splice(lB.end(), lC);
+            // verify
+            assertUnit(&lA.pool() == &lD.pool());
+            assertUnit(lA.capacity() - lA.size() == lD.capacity() - lD.size());
+            lD.splice(lD.end(), lB);
+         }
+         assertUnit(toVector(lA) == std::vector<int>({ 1, 2 }));
+         assertUnit(toVector(lD) == std::vector<int>({ 4, 3, 5, 6 }));
+         assertUnit(count.numAllocate > count.numDeallocate);
+      }
+      assertUnit(count.numAllocate == count.numDeallocate);
+   }  // teardown
+
+   // two sorted lists become one
+   void test_merge_standard()
+   {  // setup
+      custom::list<int> lDes{ 11, 26, 31 };
+      custom::list<int> lSrc{ 5, 20, 30, 40, 50 };
+      // exercise
+      lDes.merge(lSrc);
+      // verify
+      assertUnit(toVector(lDes) == std::vector<int>({ 5, 11, 20, 26, 30, 31, 40, 50 }));
+      assertUnit(lDes.numElements == 8);
+      assertUnit(lDes.pHead->pPrev == nullptr);
+      assertUnit(lDes.pTail->data == 50);
+      assertUnit(lDes.pTail->pNext == nullptr);
+      assertUnit(lDes.pTail->pPrev->data == 40);
+      assertEmptyFixture(lSrc);
+   }  // teardown
+
+   // on a tie our element goes first
+   void test_merge_stable()
+   {  // setup
+      custom::list<std::pair<int, int>> lDes{ { 1, 0 }, { 2, 0 }, { 3, 0 } };
+      custom::list<std::pair<int, int>> lSrc{ { 1, 1 }, { 3, 1 }, { 4, 1 } };
+      auto byKey = [](const std::pair<int, int> & lhs, const std::pair<int, int> & rhs)
+      {
+         return lhs.first < rhs.first;
+      };
+      // exercise
+      lDes.merge(lSrc, byKey);
+      // verify
+      std::vector<std::pair<int, int>> merged;
+      for (auto it = lDes.begin(); it != lDes.end(); ++it)
+         merged.push_back(*it);
+      std::vector<std::pair<int, int>> expected
+         { { 1, 0 }, { 1, 1 }, { 2, 0 }, { 3, 0 }, { 3, 1 }, { 4, 1 } };
+      assertUnit(merged == expected);
+      assertUnit(lDes.pTail->data.first == 4);
+   }  // teardown
+
+   // merging into an empty list takes everything
+   void test_merge_intoEmpty()
+   {  // setup
+      custom::list<int> lDes;
+      custom::list<int> lSrc{ 11, 26, 31 };
+      // exercise
+      lDes.merge(lSrc);
+      // verify
+      assertStandardFixture(lDes);
+      assertEmptyFixture(lSrc);
+   }  // teardown
+
+   // cut in the middle, the back half in a new list
+   void test_splitAt_middle()
+   {
+      for (int at = 1; at < 6; at++)
+      {  // setup
+         custom::list<int> l{ 0, 1, 2, 3, 4, 5 };
+         auto it = l.begin();
+         for (int i = 0; i < at; i++)
+            ++it;
+         auto pNode = it.p;
+         // exercise
+         custom::list<int> lSplit = l.split_at(it);
+         // verify
+         assertUnit(l.numElements == (size_t)at);
+         assertUnit(lSplit.numElements == (size_t)(6 - at));
+         assertUnit(l.pTail->data == at - 1);
+         assertUnit(l.pTail->pNext == nullptr);
+         assertUnit(lSplit.pHead == pNode);
+         assertUnit(lSplit.pHead->pPrev == nullptr);
+         assertUnit(lSplit.pTail->data == 5);
+         // the halves still work as lists
+         lSplit.push_back(6);
+         l.splice(l.end(), lSplit);
+         assertUnit(toVector(l) == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6 }));
+      }  // teardown
+   }
+
+   // cutting at either end leaves one side empty
+   void test_splitAt_beginEnd()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      custom::list<int> lNone = l.split_at(l.end());
+      // verify
+      assertEmptyFixture(lNone);
+      assertStandardFixture(l);
+      // exercise
+      custom::list<int> lAll = l.split_at(l.begin());
+      // verify
+      assertEmptyFixture(l);
+      assertStandardFixture(lAll);
+   }  // teardown
+
+   // the halves share a pool, yet each can be used on its own thread
+   void test_splitAt_halvesOnTwoThreads()
+   {  // setup
+      custom::list<int> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      auto it = l.begin();
+      for (int i = 0; i < 50; i++)
+         ++it;
+      custom::list<int> lSplit = l.split_at(it);
+      assertUnit(l.pPool == lSplit.pPool);
+      auto churn = [](custom::list<int> * pl)
+      {
+         for (int i = 0; i < 2000; i++)
+         {
+            pl->push_back(pl->front());
+            pl->pop_front();
+            if (i % 100 == 0)
+               pl->reserve(pl->capacity() + 16);
+         }
+      };
+      // exercise
+      std::thread t(churn, &lSplit);
+      churn(&l);
+      t.join();
+      // verify
+      assertUnit(l.size() == 50);
+      assertUnit(lSplit.size() == 50);
+      assertUnit(l.front() == 0);
+      assertUnit(lSplit.front() == 50);
+      assertUnit(l.capacity() - l.size() == lSplit.capacity() - lSplit.size());
+   }  // teardown
+
+   /***************************************
+    * RECLAMATION
+    ***************************************/
+
+   // a guarded node is neither destroyed nor reused until let go
+   void test_retire_eraseGuarded()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::list<Spy> l;
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      l.push_back(Spy(31));
+      l.retire_into(&domain);
+      custom::list<Spy>::Node * p26 = l.pHead->pNext;
+      size_t numFree = l.pool().numFree;
+      {
+         custom::hazard_pointer hp(domain);
+         hp.set(p26);
+         Spy::reset();
+         // exercise
+         custom::list<Spy>::iterator it(p26);
+         l.erase(it);
+         domain.scan();
+         // verify
+         assertUnit(Spy::numDestructor() == 0);
+         assertUnit(p26->data.get() == 26);
+         assertUnit(l.pool().numFree == numFree);
+         assertUnit(l.size() == 2);
+         assertUnit(l.pHead->pNext->data.get() == 31);
+      }
+      domain.scan();
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(l.pool().numFree == numFree + 1);
+      assertUnit(l.pool().pFree == p26);
+   }  // teardown
+
+   // both ends retire, and an unguarded node comes back on a scan
+   void test_retire_popFrontPopBack()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::list<int> l;
+      setupStandardFixture(l);
+      l.retire_into(&domain);
+      size_t capacity = l.capacity();
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(l.capacity() == capacity - 2);
+      domain.scan();
+      assertUnit(l.capacity() == capacity);
+      assertUnit(toVector(l) == std::vector<int>({ 26 }));
+   }  // teardown
+
+   // a node still guarded when its list goes away is freed later
+   void test_retire_listDestroyedFirst()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      custom::hazard_domain domain;
+      {
+         custom::hazard_pointer hp(domain);
+         {
+            custom::list<int, CountingAllocator<int>> l(alloc);
+            l.push_back(11);
+            l.push_back(26);
+            l.retire_into(&domain);
+            hp.set(l.pHead);
+            // exercise
+         }
+         domain.scan();
+         // verify
+         assertUnit(count.numAllocate > count.numDeallocate);
+      }
+      domain.scan();
+      assertUnit(count.numAllocate == count.numDeallocate);
+   }  // teardown
+
+   // with no domain, erase frees at once again
+   void test_retire_off()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::list<Spy> l;
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      l.retire_into(&domain);
+      l.pop_front();
+      Spy::reset();
+      // exercise
+      l.retire_into(nullptr);
+      l.pop_front();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(l.pRetirement == nullptr);
+      domain.scan();
+      assertUnit(Spy::numDestructor() == 2);
+   }  // teardown
+
+   // compact leaves a guarded node readable, copying rather than moving
+   void test_retire_compactGuarded()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::list<Spy> l;
+      setupSpyFixture(l, { 11, 26, 31 });
+      l.retire_into(&domain);
+      custom::list<Spy>::Node * p26 = l.pHead->pNext;
+      {
+         custom::hazard_pointer hp(domain);
+         hp.set(p26);
+         Spy::reset();
+         // exercise
+         l.compact();
+         domain.scan();
+         // verify
+         assertUnit(Spy::numCopy() == 3);
+         assertUnit(Spy::numCopyMove() == 0);
+         assertUnit(Spy::numDestructor() == 2);
+         assertUnit(p26->data.get() == 26);
+         assertUnit(l.pHead->pNext != p26);
+         assertUnit(l.pHead->pNext->data.get() == 26);
+         assertUnit(l.fragmentation() == 0.0);
+      }
+      domain.scan();
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(l.pool().pFree == p26);
+   }  // teardown
+
+   // so does a step of incremental compaction
+   void test_retire_compactStepGuarded()
+   {  // setup
+      custom::hazard_domain domain;
+      custom::list<int> l;
+      setupStandardFixture(l);
+      l.retire_into(&domain);
+      custom::list<int>::Node * p11 = l.pHead;
+      {
+         custom::hazard_pointer hp(domain);
+         hp.set(p11);
+         // exercise
+         while (!l.compact_step(1))
+            ;
+         domain.scan();
+         // verify
+         assertUnit(p11->data == 11);
+         assertUnit(l.pHead != p11);
+         assertStandardFixture(l);
+      }
+      domain.scan();
+      assertUnit(l.pool().pFree == p11);
+   }  // teardown
+
+   /***************************************
+    * COPY ON WRITE
+    ***************************************/
+
+   // without asking, a copy is a deep copy
+   void test_cow_offByDefault()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      Spy::reset();
+      // exercise
+      custom::list<Spy> lDes(lSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(lDes.pHead != lSrc.pHead);
+      assertUnit(!lSrc.shares_nodes());
+   }  // teardown
+
+   // a copy takes the nodes as they are and is in the mode too
+   void test_cow_copyShares()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      Spy::reset();
+      // exercise
+      custom::list<Spy> lDes(lSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(lDes.pHead == lSrc.pHead);
+      assertUnit(lDes.pTail == lSrc.pTail);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(lDes.copyOnWrite);
+      assertUnit(lSrc.shares_nodes());
+      assertUnit(lDes.shares_nodes());
+      assertUnit(lSrc.pShare->numRefs == 2);
+   }  // teardown
+
+   // assigning lets go of our nodes and shares the source's
+   void test_cow_assignShares()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy> lDes;
+      setupSpyFixture(lDes, { 61, 73, 85, 97 });
+      Spy::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(lDes.pHead == lSrc.pHead);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(lSrc.pShare->numRefs == 2);
+   }  // teardown
+
+   // reading through a constant reference copies nothing
+   void test_cow_readKeepsShare()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy> lDes(lSrc);
+      const custom::list<Spy> & lRead = lDes;
+      Spy::reset();
+      // exercise
+      int sum = 0;
+      for (auto it = lRead.cbegin(); it != lRead.cend(); ++it)
+         sum += (*it).get();
+      int front = lRead.front().get();
+      int back = lRead.back().get();
+      // verify
+      assertUnit(sum == 68);
+      assertUnit(front == 11);
+      assertUnit(back == 31);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(lDes.pHead == lSrc.pHead);
+   }  // teardown
+
+   // a range-for over a constant list uses the const begin() and end()
+   void test_cow_rangeForKeepsShare()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy> lDes(lSrc);
+      const custom::list<Spy> & lRead = lDes;
+      Spy::reset();
+      // exercise
+      int sum = 0;
+      for (const Spy & spy : lRead)
+         sum += spy.get();
+      // verify
+      assertUnit(sum == 68);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(!lDes.leaked);
+      assertUnit(lDes.pHead == lSrc.pHead);
+      assertUnit(lDes.shares_nodes());
+   }  // teardown
+
+   // the copy changes first: it gets nodes of its own
+   void test_cow_copyWrites()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy>::Node * p1 = lSrc.pHead;
+      custom::list<Spy> lDes(lSrc);
+      Spy::reset();
+      // exercise
+      lDes.push_back(Spy(42));
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(lSrc.pHead == p1);
+      assertUnit(lDes.pHead != p1);
+      assertUnit(lSrc.numElements == 3);
+      assertUnit(lDes.numElements == 4);
+      assertUnit(lDes.pTail->pPrev->data.get() == 31);
+      assertUnit(!lSrc.shares_nodes());
+      assertUnit(!lDes.shares_nodes());
+   }  // teardown
+
+   // the source changes first: the copy keeps the old nodes
+   void test_cow_sourceWrites()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy>::Node * p1 = lSrc.pHead;
+      custom::list<Spy> lDes(lSrc);
+      Spy::reset();
+      // exercise
+      lSrc.pop_front();
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(lDes.pHead == p1);
+      assertUnit(lDes.numElements == 3);
+      assertUnit(lSrc.numElements == 2);
+      assertUnit(lSrc.pHead->data.get() == 26);
+      assertUnit(lSrc.pHead != p1->pNext);
+   }  // teardown
+
+   // an iterator from before the copy still erases from the source alone
+   void test_cow_eraseThroughOldIterator()
+   {  // setup
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      lSrc.copy_on_write();
+      auto it = ++lSrc.begin();
+      custom::list<int> lDes(lSrc);
+      // exercise
+      lSrc.erase(it);
+      // verify
+      assertUnit(toVector(lSrc) == std::vector<int>({ 11, 31 }));
+      assertStandardFixture(lDes);
+      assertUnit(lDes.pHead != lSrc.pHead);
+      assertUnit(!lSrc.shares_nodes());
+   }  // teardown
+
+   // and writing through it changes the source alone
+   void test_cow_assignThroughOldIterator()
+   {  // setup
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      lSrc.copy_on_write();
+      auto it = lSrc.begin();
+      int & back = lSrc.back();
+      custom::list<int> lDes(lSrc);
+      // exercise
+      *it = 99;
+      back = 98;
+      // verify
+      assertUnit(toVector(lSrc) == std::vector<int>({ 99, 26, 98 }));
+      assertStandardFixture(lDes);
+   }  // teardown
+
+   // the same holds for a copy that is copied in turn
+   void test_cow_oldIteratorOnCopy()
+   {  // setup
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      lSrc.copy_on_write();
+      custom::list<int> lCopy(lSrc);
+      auto it = ++lCopy.begin();
+      custom::list<int> lCopyOfCopy(lCopy);
+      // exercise
+      *it = 99;
+      assertUnit(toVector(lCopy) == std::vector<int>({ 11, 99, 31 }));
+      lCopy.erase(it);
+      // verify
+      assertUnit(toVector(lCopy) == std::vector<int>({ 11, 31 }));
+      assertStandardFixture(lCopyOfCopy);
+      assertStandardFixture(lSrc);
+   }  // teardown
+
+   // once cleared, no old iterator is good, so copies share again
+   void test_cow_clearForgetsIterators()
+   {  // setup
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      lSrc.copy_on_write();
+      lSrc.begin();
+      custom::list<int> lDeep(lSrc);
+      // exercise
+      lSrc.clear();
+      setupStandardFixture(lSrc);
+      custom::list<int> lDes(lSrc);
+      // verify
+      assertUnit(lDeep.pHead != lSrc.pHead);
+      assertUnit(lDes.pHead == lSrc.pHead);
+      assertUnit(lDes.shares_nodes());
+   }  // teardown
+
+   // clearing a shared list copies nothing and frees nothing
+   void test_cow_clearLetsGo()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupSpyFixture(lSrc, { 11, 26, 31 });
+      lSrc.copy_on_write();
+      custom::list<Spy> lDes(lSrc);
+      Spy::reset();
+      // exercise
+      lDes.clear();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(lDes.empty());
+      assertUnit(lDes.pShare == nullptr);
+      assertUnit(lSrc.numElements == 3);
+      assertUnit(!lSrc.shares_nodes());
+   }  // teardown
+
+   // the nodes outlive the list they came from
+   void test_cow_destroySourceFirst()
+   {  // setup
+      custom::list<Spy> * pSrc = new custom::list<Spy>;
+      setupSpyFixture(*pSrc, { 11, 26, 31 });
+      pSrc->copy_on_write();
+      custom::list<Spy> * pDes = new custom::list<Spy>(*pSrc);
+      Spy::reset();
+      // exercise
+      delete pSrc;
+      int numAfterSource = Spy::numDestructor();
+      pDes->push_back(Spy(42));
+      // verify
+      assertUnit(numAfterSource == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(pDes->numElements == 4);
+      assertUnit(pDes->pHead->data.get() == 11);
+      delete pDes;
+      assertUnit(Spy::numDestructor() == 4 + 1); // and the temporary
+   }  // teardown
+
+   // every node and count goes back however the copies end
+   void test_cow_allocatorBalanced()
+   {  // setup
+      AllocCount count;
+      CountingAllocator<int> alloc(&count);
+      {
+         custom::list<int, CountingAllocator<int>> lSrc(alloc);
+         for (int i = 0; i < 100; i++)
+            lSrc.push_back(i);
+         lSrc.copy_on_write();
+         // exercise
+         custom::list<int, CountingAllocator<int>> lCopy1(lSrc);
+         custom::list<int, CountingAllocator<int>> lCopy2(lSrc);
+         custom::list<int, CountingAllocator<int>> lCopy3(alloc);
+         lCopy3 = lCopy1;
+         lCopy1.push_front(-1);
+         lSrc.clear();
+         lCopy2 = std::move(lCopy3);
+      }
+      // verify
+      assertUnit(count.numAllocate == count.numDeallocate);
+   }  // teardown
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
@@ -1919,9 +3748,9 @@ public:
    void setupStandardFixture(custom::list<int>& l)
    {
       // allocat
-      custom::list<int>::Node* p1 = new custom::list<int>::Node(int(11));
-      custom::list<int>::Node* p2 = new custom::list<int>::Node(int(26));
-      custom::list<int>::Node* p3 = new custom::list<int>::Node(int(31));
+      custom::list<int>::Node* p1 = l.createNode(int(11));
+      custom::list<int>::Node* p2 = l.createNode(int(26));
+      custom::list<int>::Node* p3 = l.createNode(int(31));
 
       // hook up pointers
       p1->pNext = p2;
@@ -1935,6 +3764,67 @@ public:
       l.numElements = 3;
    }
 
+   /****************************************************************
+    * Assert Contiguous
+    * Every node sits right after the one before it, all in one slab
+    ****************************************************************/
+   void assertContiguousParameters(const custom::list<int>& l, size_t num,
+                                   int line, const char* function)
+   {
+      assertIndirect(l.pool().pSlabs != nullptr);
+      if (l.pool().pSlabs)
+      {
+         assertIndirect(l.pool().pSlabs->pNext == nullptr);
+         assertIndirect(l.pool().pSlabs->numNodes == num);
+      }
+      size_t count = 0;
+      for (custom::list<int>::Node * p = l.pHead; p && p->pNext; p = p->pNext, count++)
+         assertIndirect(p->pNext == p + 1);
+      assertIndirect(count + 1 == num);
+   }
+
+   /****************************************************************
+    * Setup Churned Fixture
+    * num elements whose nodes have been reused out of order
+    ****************************************************************/
+   void setupChurnedFixture(custom::list<int>& l, int num)
+   {
+      for (int i = 0; i < num; i++)
+         l.push_back(i);
+      custom::list<int>::iterator it = l.begin();
+      for (int i = 0; i < num; i++)
+         if (i % 3 == 0)
+         {
+            it = l.erase(it);
+            l.push_back(num + i);
+         }
+         else
+            ++it;
+   }
+
+   /****************************************************************
+    * To Vector
+    * The elements of a list, front to back
+    ****************************************************************/
+   template <class A>
+   std::vector<int> toVector(custom::list<int, A>& l)
+   {
+      std::vector<int> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+
+   /****************************************************************
+    * Setup Spy Fixture
+    * A list of spies holding the given values
+    ****************************************************************/
+   void setupSpyFixture(custom::list<Spy>& l, const std::initializer_list<int> & values)
+   {
+      for (int value : values)
+         l.push_back(Spy(value));
+   }
+
    /****************************************************************
     * Teardown Standard Fixture
     *        pHead             pTail
@@ -1953,14 +3843,14 @@ public:
                if (l.pHead->pNext->pNext->pNext && l.pHead->pNext->pNext->pNext != l.pHead && l.pHead->pNext->pNext->pNext != l.pHead->pNext && l.pHead->pNext->pNext->pNext != l.pHead->pNext->pNext)
                {
                   if (l.pHead->pNext->pNext->pNext->pNext && l.pHead->pNext->pNext->pNext->pNext != l.pHead && l.pHead->pNext->pNext->pNext->pNext != l.pHead->pNext && l.pHead->pNext->pNext->pNext->pNext != l.pHead->pNext->pNext && l.pHead->pNext->pNext->pNext->pNext != l.pHead->pNext->pNext->pNext)
-                     delete l.pHead->pNext->pNext->pNext->pNext;
-                  delete l.pHead->pNext->pNext->pNext;
+                     l.destroyNode(l.pHead->pNext->pNext->pNext->pNext);
+                  l.destroyNode(l.pHead->pNext->pNext->pNext);
                }
-               delete l.pHead->pNext->pNext;
+               l.destroyNode(l.pHead->pNext->pNext);
             }
-            delete l.pHead->pNext;
+            l.destroyNode(l.pHead->pNext);
          }
-         delete l.pHead;
+         l.destroyNode(l.pHead);
          l.pHead = l.pTail = nullptr;
          l.numElements = 0;
       }
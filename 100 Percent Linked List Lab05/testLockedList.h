@@ -0,0 +1,384 @@
+/***********************************************************************
+ * Header:
+ *    TEST LOCKED LIST
+ * Summary:
+ *    Unit tests for locked_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lockedList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestLockedList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_spy();
+
+      // Iterator
+      test_iterator_locksWindow();
+      test_iterator_handOverHand();
+      test_iterator_releasedAtEnd();
+
+      // Find
+      test_find_present();
+      test_find_missing();
+
+      // Insert
+      test_pushfront_order();
+      test_pushback_order();
+      test_insert_middle();
+      test_insert_end();
+
+      // Erase
+      test_erase_middle();
+      test_erase_last();
+
+      // Threads
+      test_threads_pushBack();
+      test_threads_insertErase();
+
+      report("LockedList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list is just the sentinel
+   void test_construct_default()
+   {  // exercise
+      custom::locked_list<int> l;
+      // verify
+      assertUnit(l.head.pNext == nullptr);
+      assertUnit(!l.head.lock.isLocked());
+      assertUnit(l.empty());
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // the destructor frees every node
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::locked_list<Spy> l;
+         for (int i = 0; i < 5; i++)
+            l.push_back(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 5);
+      assertUnit(Spy::numDelete() == 5);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // begin holds the sentinel and the first node
+   void test_iterator_locksWindow()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      {
+         // exercise
+         auto it = l.begin();
+         // verify
+         assertUnit(*it == 11);
+         assertUnit(l.head.lock.isLocked());
+         assertUnit(l.head.pNext->lock.isLocked());
+         assertUnit(!l.head.pNext->pNext->lock.isLocked());
+      }
+      assertUnit(!l.head.lock.isLocked());
+      assertUnit(!l.head.pNext->lock.isLocked());
+   }  // teardown
+
+   // moving on takes the next lock and drops the one behind
+   void test_iterator_handOverHand()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      auto p11 = l.head.pNext;
+      auto p26 = p11->pNext;
+      auto p31 = p26->pNext;
+      auto it = l.begin();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(*it == 26);
+      assertUnit(!l.head.lock.isLocked());
+      assertUnit(p11->lock.isLocked());
+      assertUnit(p26->lock.isLocked());
+      assertUnit(!p31->lock.isLocked());
+   }  // teardown
+
+   // walking off the end keeps only the last node until let go
+   void test_iterator_releasedAtEnd()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      auto p26 = l.head.pNext->pNext;
+      auto it = l.begin();
+      // exercise
+      ++it;
+      ++it;
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(it.pPrev == p26);
+      assertUnit(p26->lock.isLocked());
+      assertUnit(!l.head.pNext->lock.isLocked());
+      it.release();
+      assertUnit(!p26->lock.isLocked());
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // find stops on the element with its window held
+   void test_find_present()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // exercise
+      auto it = l.find(26);
+      // verify
+      assertUnit(it != l.end());
+      assertUnit(*it == 26);
+      assertUnit(it.pPrev == l.head.pNext);
+      assertUnit(it.pCurr->lock.isLocked());
+   }  // teardown
+
+   // a miss holds nothing
+   void test_find_missing()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      // exercise
+      auto it = l.find(99);
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(it.pPrev == nullptr);
+      assertUnit(!l.head.lock.isLocked());
+      assertUnit(!l.head.pNext->lock.isLocked());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_front puts each new element first
+   void test_pushfront_order()
+   {  // setup
+      custom::locked_list<int> l;
+      // exercise
+      l.push_front(31);
+      l.push_front(26);
+      l.push_front(11);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // push_back puts each new element last
+   void test_pushback_order()
+   {  // setup
+      custom::locked_list<int> l;
+      // exercise
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // insert goes before the iterator and lands on the new element
+   void test_insert_middle()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(31);
+      {
+         // exercise
+         auto it = l.insert(l.find(31), 26);
+         // verify
+         assertUnit(*it == 26);
+         assertUnit(it.pCurr->lock.isLocked());
+         assertUnit(!it.pCurr->pNext->lock.isLocked());
+      }
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // inserting at end() appends
+   void test_insert_end()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      // exercise
+      l.insert(l.end(), 26);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26 }));
+      assertUnit(!l.head.lock.isLocked());
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase relinks around the element and moves onto the next
+   void test_erase_middle()
+   {  // setup
+      custom::locked_list<Spy> l;
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      l.push_back(Spy(31));
+      Spy::reset();
+      {
+         // exercise
+         auto it = l.erase(l.find(Spy(26)));
+         // verify
+         assertUnit((*it).get() == 31);
+         assertUnit(Spy::numDestructor() == 2);   // 26 and the temporary
+      }
+      assertUnit(l.size() == 2);
+      assertUnit(l.head.pNext->pNext->data.get() == 31);
+   }  // teardown
+
+   // erasing the last element leaves an end iterator
+   void test_erase_last()
+   {  // setup
+      custom::locked_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      // exercise
+      auto it = l.erase(l.find(26));
+      // verify
+      assertUnit(it == l.end());
+      it.release();
+      assertUnit(toVector(l) == std::vector<int>({ 11 }));
+      assertUnit(l.head.pNext->pNext == nullptr);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // nothing is lost when threads append at once
+   void test_threads_pushBack()
+   {  // setup
+      const int numThreads = 4;
+      const int num = 300;
+      custom::locked_list<int> l;
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&l, t]()
+         {
+            for (int i = 0; i < num; i++)
+               l.push_back(t * num + i);
+         }));
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      std::vector<int> v = toVector(l);
+      std::sort(v.begin(), v.end());
+      bool inOrder = v.size() == numThreads * num;
+      for (size_t i = 0; inOrder && i < v.size(); i++)
+         inOrder = v[i] == (int)i;
+      assertUnit(inOrder);
+      assertUnit(l.size() == numThreads * num);
+   }  // teardown
+
+   // inserters, erasers and readers share the list safely
+   void test_threads_insertErase()
+   {  // setup
+      const int numThreads = 4;
+      const int num = 200;
+      custom::locked_list<int> l;
+      for (int i = 0; i < numThreads * num; i++)
+         l.push_back(2 * i);
+      std::atomic<int> numInserted(0);
+      std::atomic<int> numErased(0);
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+      {
+         // each thread puts an odd number after each of its evens
+         threads.push_back(std::thread([&l, &numInserted, t]()
+         {
+            for (int i = t * num; i < (t + 1) * num; i++)
+            {
+               auto it = l.find(2 * i);
+               if (it != l.end())
+               {
+                  ++it;
+                  l.insert(std::move(it), 2 * i + 1);
+                  numInserted++;
+               }
+            }
+         }));
+         // and another erases the evens of a different stretch
+         threads.push_back(std::thread([&l, &numErased, t]()
+         {
+            int u = (t + 1) % numThreads;
+            for (int i = u * num; i < (u + 1) * num; i++)
+            {
+               auto it = l.find(2 * i);
+               if (it != l.end())
+               {
+                  l.erase(std::move(it));
+                  numErased++;
+               }
+            }
+         }));
+      }
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      int n = numThreads * num;
+      assertUnit(numErased.load() == n);
+      assertUnit((int)l.size() == n - numErased.load() + numInserted.load());
+      std::vector<int> v = toVector(l);
+      bool ascending = std::is_sorted(v.begin(), v.end());
+      assertUnit(ascending);
+      assertUnit(!l.head.lock.isLocked());
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   std::vector<int> toVector(custom::locked_list<int> & l)
+   {
+      std::vector<int> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+};
+
+#endif // DEBUG
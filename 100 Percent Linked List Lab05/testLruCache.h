@@ -0,0 +1,217 @@
+/***********************************************************************
+ * Header:
+ *    TEST LRU CACHE
+ * Summary:
+ *    Unit tests for lru_cache
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lruCache.h"
+#include "unitTest.h"
+
+#include <string>
+#include <vector>
+
+class TestLruCache : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_reserves();
+
+      // Get and put
+      test_get_miss();
+      test_get_hitMovesToFront();
+      test_get_frontStaysPut();
+      test_put_update();
+      test_contains_leavesOrder();
+
+      // Eviction
+      test_evict_leastRecent();
+      test_evict_recyclesNode();
+      test_capacity_zero();
+
+      // Erase
+      test_erase_key();
+
+      report("LruCache");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the nodes and buckets are made up front
+   void test_construct_reserves()
+   {  // exercise
+      custom::lru_cache<int, std::string> cache(100);
+      // verify
+      assertUnit(cache.empty());
+      assertUnit(cache.capacity() == 100);
+      assertUnit(cache.entries.capacity() >= 100);
+      assertUnit(cache.index.bucket_count() >= 100);
+   }  // teardown
+
+   /***************************************
+    * GET and PUT
+    ***************************************/
+
+   // a missing key gives NULL
+   void test_get_miss()
+   {  // setup
+      custom::lru_cache<int, std::string> cache(2);
+      cache.put(11, "eleven");
+      // exercise and verify
+      assertUnit(cache.get(26) == nullptr);
+   }  // teardown
+
+   // a hit relinks the same node to the front
+   void test_get_hitMovesToFront()
+   {  // setup
+      custom::lru_cache<int, std::string> cache(3);
+      cache.put(11, "eleven");
+      cache.put(26, "twenty-six");
+      cache.put(31, "thirty-one");
+      std::pair<int, std::string> * p11 = &cache.entries.back();
+      // exercise
+      std::string * pValue = cache.get(11);
+      // verify
+      assertUnit(pValue != nullptr);
+      assertUnit(*pValue == "eleven");
+      assertUnit(&cache.entries.front() == p11);
+      assertUnit(keys(cache) == std::vector<int>({ 11, 31, 26 }));
+   }  // teardown
+
+   // a hit on the front changes nothing
+   void test_get_frontStaysPut()
+   {  // setup
+      custom::lru_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise
+      cache.get(26);
+      cache.get(26);
+      // verify
+      assertUnit(keys(cache) == std::vector<int>({ 26, 11 }));
+      assertUnit(cache.entries.pTail->data.first == 11);
+   }  // teardown
+
+   // putting a key already there updates it in place
+   void test_put_update()
+   {  // setup
+      custom::lru_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise
+      cache.put(11, 99);
+      // verify
+      assertUnit(cache.size() == 2);
+      assertUnit(*cache.get(11) == 99);
+      assertUnit(keys(cache) == std::vector<int>({ 11, 26 }));
+   }  // teardown
+
+   // contains is only a peek
+   void test_contains_leavesOrder()
+   {  // setup
+      custom::lru_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise and verify
+      assertUnit(cache.contains(11));
+      assertUnit(!cache.contains(31));
+      assertUnit(keys(cache) == std::vector<int>({ 26, 11 }));
+   }  // teardown
+
+   /***************************************
+    * EVICTION
+    ***************************************/
+
+   // a full cache forgets the least recently used
+   void test_evict_leastRecent()
+   {  // setup
+      custom::lru_cache<int, int> cache(3);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      cache.put(31, 3);
+      cache.get(11);
+      // exercise
+      cache.put(42, 4);
+      // verify
+      assertUnit(cache.size() == 3);
+      assertUnit(cache.get(26) == nullptr);
+      assertUnit(keys(cache) == std::vector<int>({ 42, 11, 31 }));
+      assertUnit(cache.index.size() == 3);
+   }  // teardown
+
+   // the evicted node carries the new entry
+   void test_evict_recyclesNode()
+   {  // setup
+      custom::lru_cache<int, int> cache(2);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      std::pair<int, int> * pBack = &cache.entries.back();
+      size_t numFree = cache.entries.pool().numFree;
+      // exercise
+      cache.put(31, 3);
+      // verify
+      assertUnit(&cache.entries.front() == pBack);
+      assertUnit(pBack->first == 31);
+      assertUnit(pBack->second == 3);
+      assertUnit(cache.entries.pool().numFree == numFree);
+   }  // teardown
+
+   // a cache with no room holds nothing
+   void test_capacity_zero()
+   {  // setup
+      custom::lru_cache<int, int> cache(0);
+      // exercise
+      cache.put(11, 1);
+      // verify
+      assertUnit(cache.empty());
+      assertUnit(cache.get(11) == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erasing makes room without evicting
+   void test_erase_key()
+   {  // setup
+      custom::lru_cache<int, int> cache(2);
+      cache.put(11, 1);
+      cache.put(26, 2);
+      // exercise
+      bool erased = cache.erase(11);
+      bool again = cache.erase(11);
+      cache.put(31, 3);
+      // verify
+      assertUnit(erased);
+      assertUnit(!again);
+      assertUnit(keys(cache) == std::vector<int>({ 31, 26 }));
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   // most recently used first
+   template <class V>
+   std::vector<int> keys(custom::lru_cache<int, V> & cache)
+   {
+      std::vector<int> v;
+      for (auto it = cache.entries.begin(); it != cache.entries.end(); ++it)
+         v.push_back((*it).first);
+      return v;
+   }
+};
+
+#endif // DEBUG
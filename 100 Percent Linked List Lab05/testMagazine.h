@@ -0,0 +1,208 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAGAZINE
+ * Summary:
+ *    Unit tests for magazine_cache and magazine_allocator
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "magazine.h"
+#include "list.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+class TestMagazine : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Cache
+      test_allocate_reusesLastFreed();
+      test_allocate_sizeClasses();
+      test_allocate_tooBig();
+      test_deallocate_flipsToSpare();
+      test_deallocate_spillsToDepot();
+      test_threads_crossThreadFree();
+      test_threads_exitWithPartial();
+
+      // Allocator
+      test_allocator_list();
+
+      report("Magazine");
+   }
+
+   /***************************************
+    * CACHE
+    ***************************************/
+
+   // the last block freed is the next one handed out
+   void test_allocate_reusesLastFreed()
+   {  // setup
+      void * p = custom::magazine_cache::allocate(24);
+      custom::magazine_cache::deallocate(p, 24);
+      // exercise
+      void * pAgain = custom::magazine_cache::allocate(24);
+      // verify
+      assertUnit(pAgain == p);
+      custom::magazine_cache::deallocate(pAgain, 24);
+   }  // teardown
+
+   // sizes in the same grain share magazines, others do not
+   void test_allocate_sizeClasses()
+   {  // setup
+      void * p = custom::magazine_cache::allocate(17);
+      custom::magazine_cache::deallocate(p, 17);
+      // exercise
+      void * pOther = custom::magazine_cache::allocate(16);
+      void * pSame = custom::magazine_cache::allocate(32);
+      // verify
+      assertUnit(pOther != p);
+      assertUnit(pSame == p);
+      assertUnit(custom::magazine_cache::sizeClass(16) == 0);
+      assertUnit(custom::magazine_cache::sizeClass(17) == 1);
+      custom::magazine_cache::deallocate(pOther, 16);
+      custom::magazine_cache::deallocate(pSame, 32);
+   }  // teardown
+
+   // big or over-aligned blocks are not the cache's business
+   void test_allocate_tooBig()
+   {  // exercise and verify
+      assertUnit(custom::magazine_cache::cached(1024, 8));
+      assertUnit(!custom::magazine_cache::cached(1025, 8));
+      assertUnit(!custom::magazine_cache::cached(64, 2 * alignof(std::max_align_t)));
+      custom::magazine_allocator<char> alloc;
+      char * p = alloc.allocate(4096);
+      p[4095] = 'x';
+      alloc.deallocate(p, 4096);
+   }  // teardown
+
+   // a full magazine is set aside as the spare, not sent off
+   void test_deallocate_flipsToSpare()
+   {  // setup
+      const size_t size = 200;   // a class no other test uses
+      size_t c = custom::magazine_cache::sizeClass(size);
+      auto & cache = custom::magazine_cache::owner().caches[c];
+      std::vector<void *> blocks;
+      for (int i = 0; i < custom::magazine_cache::ROUNDS + 1; i++)
+         blocks.push_back(custom::magazine_cache::allocate(size));
+      // exercise
+      for (void * p : blocks)
+         custom::magazine_cache::deallocate(p, size);
+      // verify
+      assertUnit(cache.pPrevious != nullptr);
+      assertUnit(cache.pPrevious->num == custom::magazine_cache::ROUNDS);
+      assertUnit(cache.pLoaded->num == 1);
+      for (size_t i = 0; i < blocks.size(); i++)
+         blocks[i] = custom::magazine_cache::allocate(size);
+      assertUnit(cache.pLoaded->num == 0);
+      for (void * p : blocks)
+         custom::magazine_cache::deallocate(p, size);
+   }  // teardown
+
+   // with both magazines full, one goes to the depot
+   void test_deallocate_spillsToDepot()
+   {  // setup
+      const size_t size = 300;   // a class no other test uses
+      size_t c = custom::magazine_cache::sizeClass(size);
+      auto & depot = custom::magazine_cache::depot(c);
+      size_t numFull = depot.numFull;
+      std::vector<void *> blocks;
+      for (int i = 0; i < 2 * custom::magazine_cache::ROUNDS + 1; i++)
+         blocks.push_back(custom::magazine_cache::allocate(size));
+      // exercise
+      for (void * p : blocks)
+         custom::magazine_cache::deallocate(p, size);
+      // verify
+      assertUnit(depot.numFull == numFull + 1);
+      for (size_t i = 0; i < blocks.size(); i++)
+         blocks[i] = custom::magazine_cache::allocate(size);
+      assertUnit(depot.numFull == numFull);
+      for (void * p : blocks)
+         custom::magazine_cache::deallocate(p, size);
+   }  // teardown
+
+   // blocks freed on another thread come back through the depot
+   void test_threads_crossThreadFree()
+   {  // setup
+      const size_t size = 400;   // a class no other test uses
+      const int num = 4 * custom::magazine_cache::ROUNDS;
+      std::vector<void *> blocks;
+      for (int i = 0; i < num; i++)
+         blocks.push_back(custom::magazine_cache::allocate(size));
+      // exercise
+      std::thread([&]()
+      {
+         for (void * p : blocks)
+            custom::magazine_cache::deallocate(p, size);
+      }).join();
+      // verify
+      std::vector<void *> again;
+      for (int i = 0; i < num; i++)
+         again.push_back(custom::magazine_cache::allocate(size));
+      std::sort(blocks.begin(), blocks.end());
+      std::sort(again.begin(), again.end());
+      assertUnit(again == blocks);
+      for (void * p : again)
+         custom::magazine_cache::deallocate(p, size);
+   }  // teardown
+
+   // an exiting thread hands the depot only full magazines
+   void test_threads_exitWithPartial()
+   {  // setup
+      const size_t size = 500;   // a class no other test uses
+      const int num = custom::magazine_cache::ROUNDS + 5;
+      size_t c = custom::magazine_cache::sizeClass(size);
+      auto & depot = custom::magazine_cache::depot(c);
+      size_t numFull = depot.numFull;
+      std::vector<void *> blocks;
+      for (int i = 0; i < num; i++)
+         blocks.push_back(custom::magazine_cache::allocate(size));
+      // exercise
+      std::thread([&]()
+      {
+         for (void * p : blocks)
+            custom::magazine_cache::deallocate(p, size);
+      }).join();
+      // verify
+      assertUnit(depot.numFull == numFull + 1);
+      for (auto p = depot.pFull; p; p = p->pNext)
+         assertUnit(p->num == custom::magazine_cache::ROUNDS);
+      assertUnit(depot.pEmpty != nullptr);
+      assertUnit(depot.pEmpty->num == 0);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // a list runs on the allocator, small slabs and all
+   void test_allocator_list()
+   {  // setup
+      {
+         custom::list<Spy, custom::magazine_allocator<Spy>> l;
+         Spy::reset();
+         // exercise
+         for (int i = 0; i < 20; i++)
+            l.push_back(Spy(i));
+         l.pop_front();
+         // verify
+         assertUnit(l.size() == 19);
+         assertUnit(l.front().get() == 1);
+         assertUnit(l.back().get() == 19);
+      }
+      assertUnit(Spy::numDestructor() == Spy::numCopyMove() + Spy::numNondefault());
+   }  // teardown
+};
+
+#endif // DEBUG
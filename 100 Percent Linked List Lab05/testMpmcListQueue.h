@@ -0,0 +1,375 @@
+/***********************************************************************
+ * Header:
+ *    TEST MPMC LIST QUEUE
+ * Summary:
+ *    Unit tests for mpmc_list_queue
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mpmcListQueue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <atomic>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <vector>
+
+class TestMpmcListQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_spy();
+
+      // Push and pop
+      test_tryPush_one();
+      test_tryPop_empty();
+      test_tryPushPop_fifo();
+      test_tryPush_capacity();
+      test_tryPushPop_spy();
+
+      // Batches
+      test_pushN_chain();
+      test_popN_partial();
+      test_popN_passesTail();
+
+      // Recycling
+      test_recycle_steadyState();
+      test_reserve_noAllocate();
+
+      // Threads
+      test_threads_producersConsumers();
+      test_threads_queuesOutlivedByWorker();
+
+      report("MpmcListQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty queue is one dummy node
+   void test_construct_default()
+   {  // exercise
+      custom::mpmc_list_queue<int> q;
+      // verify
+      assertUnit(q.pHead.load() != nullptr);
+      assertUnit(q.pHead.load() == q.pTail.load());
+      assertUnit(q.pHead.load()->pNext.load() == nullptr);
+      assertUnit(q.pFree.load() == nullptr);
+      assertUnit(q.numNodes.load() == 1);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // the destructor destroys what was never popped
+   void test_destructor_spy()
+   {  // setup
+      Spy value;
+      {
+         custom::mpmc_list_queue<Spy> q;
+         for (int i = 0; i < 5; i++)
+            q.try_push(Spy(i));
+         q.try_pop(value);
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(Spy::numDelete() == 4);
+   }  // teardown
+
+   /***************************************
+    * PUSH and POP
+    ***************************************/
+
+   // one push hangs a node off the dummy
+   void test_tryPush_one()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      auto pDummy = q.pHead.load();
+      // exercise
+      bool pushed = q.try_push(99);
+      // verify
+      assertUnit(pushed);
+      assertUnit(q.size() == 1);
+      assertUnit(q.pHead.load() == pDummy);
+      assertUnit(pDummy->pNext.load() == q.pTail.load());
+      assertUnit(*q.pTail.load()->data() == 99);
+   }  // teardown
+
+   // popping nothing leaves the destination alone
+   void test_tryPop_empty()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      int value = 99;
+      // exercise
+      bool popped = q.try_pop(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // first in, first out
+   void test_tryPushPop_fifo()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      q.try_push(11);
+      q.try_push(26);
+      q.try_push(31);
+      // exercise
+      std::vector<int> v;
+      int value;
+      while (q.try_pop(value))
+         v.push_back(value);
+      // verify
+      assertUnit(v == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(q.empty());
+      assertUnit(q.pHead.load() == q.pTail.load());
+   }  // teardown
+
+   // a full queue turns pushes away until something is popped
+   void test_tryPush_capacity()
+   {  // setup
+      custom::mpmc_list_queue<int> q(2);
+      // exercise
+      bool pushed1 = q.try_push(1);
+      bool pushed2 = q.try_push(2);
+      bool pushed3 = q.try_push(3);
+      // verify
+      assertUnit(pushed1 && pushed2 && !pushed3);
+      assertUnit(q.size() == 2);
+      int values[] = { 4, 5, 6 };
+      assertUnit(q.push_n(values, 3) == 0);
+      int value;
+      q.try_pop(value);
+      assertUnit(q.push_n(values, 3) == 1);
+      assertUnit(q.size() == 2);
+   }  // teardown
+
+   // elements are moved in and moved out
+   void test_tryPushPop_spy()
+   {  // setup
+      custom::mpmc_list_queue<Spy> q;
+      Spy value(99);
+      Spy result;
+      Spy::reset();
+      // exercise
+      q.try_push(std::move(value));
+      q.try_pop(result);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numAssignMove() == 1);
+      assertUnit(result.get() == 99);
+   }  // teardown
+
+   /***************************************
+    * BATCHES
+    ***************************************/
+
+   // push_n links the whole chain in order
+   void test_pushN_chain()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      q.try_push(1);
+      std::vector<int> values{ 2, 3, 4, 5 };
+      // exercise
+      size_t num = q.push_n(values.begin(), values.size());
+      // verify
+      assertUnit(num == 4);
+      assertUnit(q.size() == 5);
+      assertUnit(*q.pTail.load()->data() == 5);
+      std::vector<int> v(5);
+      assertUnit(q.pop_n(v.begin(), 5) == 5);
+      assertUnit(v == std::vector<int>({ 1, 2, 3, 4, 5 }));
+   }  // teardown
+
+   // pop_n takes what there is when asked for more
+   void test_popN_partial()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      int values[] = { 1, 2, 3 };
+      q.push_n(values, 3);
+      std::vector<int> v;
+      // exercise
+      size_t num = q.pop_n(std::back_inserter(v), 10);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(v == std::vector<int>({ 1, 2, 3 }));
+      assertUnit(q.empty());
+      assertUnit(q.pop_n(std::back_inserter(v), 10) == 0);
+   }  // teardown
+
+   // a lagging tail is helped along before the head passes it
+   void test_popN_passesTail()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      int values[] = { 1, 2, 3 };
+      q.push_n(values, 3);
+      auto pDummy = q.pHead.load();
+      q.pTail.store(pDummy);   // as if the pusher had not swung it yet
+      std::vector<int> v;
+      // exercise
+      size_t num = q.pop_n(std::back_inserter(v), 3);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(v == std::vector<int>({ 1, 2, 3 }));
+      assertUnit(q.pHead.load() == q.pTail.load());
+   }  // teardown
+
+   /***************************************
+    * RECYCLING
+    ***************************************/
+
+   // once warm, pushing and popping reuses the same nodes
+   void test_recycle_steadyState()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      int values[8] = {};
+      int out[8];
+      for (int i = 0; i < 100; i++)
+      {
+         q.push_n(values, 8);
+         q.pop_n(out, 8);
+      }
+      size_t numNodes = q.numNodes.load();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         q.push_n(values, 8);
+         q.pop_n(out, 8);
+      }
+      // verify
+      assertUnit(q.numNodes.load() == numNodes);
+      assertUnit(numNodes < 100);
+   }  // teardown
+
+   // reserved nodes are used before any new ones
+   void test_reserve_noAllocate()
+   {  // setup
+      custom::mpmc_list_queue<int> q;
+      // exercise
+      q.reserve(10);
+      // verify
+      assertUnit(q.numNodes.load() == 11);
+      for (int i = 0; i < 10; i++)
+         q.try_push(i);
+      assertUnit(q.numNodes.load() == 11);
+      assertUnit(q.pFree.load() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // every element arrives once, each producer's in order
+   void test_threads_producersConsumers()
+   {  // setup
+      const int numThreads = 4;
+      const int num = 2000;
+      custom::mpmc_list_queue<int> q;
+      std::atomic<int> numPopped(0);
+      std::atomic<long long> total(0);
+      std::atomic<bool> inOrder(true);
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+      {
+         threads.push_back(std::thread([&q, t]()
+         {
+            std::vector<int> batch;
+            for (int i = 0; i < num; i++)
+            {
+               batch.push_back(t * num + i);
+               if (batch.size() == 7 || i == num - 1)
+               {
+                  q.push_n(batch.begin(), batch.size());
+                  batch.clear();
+               }
+            }
+         }));
+         threads.push_back(std::thread([&]()
+         {
+            std::vector<int> last(numThreads, -1);
+            int values[5];
+            while (numPopped.load() < numThreads * num)
+            {
+               size_t got = q.pop_n(values, 5);
+               for (size_t i = 0; i < got; i++)
+               {
+                  int producer = values[i] / num;
+                  if (values[i] <= last[producer])
+                     inOrder = false;
+                  last[producer] = values[i];
+                  total += values[i];
+               }
+               numPopped += (int)got;
+               if (!got)
+                  std::this_thread::yield();
+            }
+         }));
+      }
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      long long n = numThreads * num;
+      assertUnit(numPopped.load() == n);
+      assertUnit(total.load() == n * (n - 1) / 2);
+      assertUnit(inOrder.load());
+      assertUnit(q.empty());
+   }  // teardown
+
+   // a worker that outlives many queues, each built where the last
+   // one was, never reaches back into a queue that is gone
+   void test_threads_queuesOutlivedByWorker()
+   {  // setup
+      typedef custom::mpmc_list_queue<int> Queue;
+      const int numQueues = 50;
+      alignas(Queue) unsigned char buffer[sizeof(Queue)];
+      std::atomic<Queue *> pQueue(nullptr);
+      std::atomic<int> numStarted(0);
+      std::atomic<int> numDone(0);
+      std::atomic<bool> allPopped(true);
+      std::thread worker([&]()
+      {
+         for (int round = 1; round <= numQueues; round++)
+         {
+            while (numStarted.load() < round)
+               std::this_thread::yield();
+            Queue * q = pQueue.load();
+            int value = 0;
+            q->try_push(round);
+            if (!q->try_pop(value) || value != round)
+               allPopped = false;
+            numDone.store(round);
+         }
+      });
+      // exercise
+      for (int round = 1; round <= numQueues; round++)
+      {
+         pQueue.store(new (buffer) Queue);
+         numStarted.store(round);
+         while (numDone.load() < round)
+            std::this_thread::yield();
+         pQueue.load()->~Queue();
+      }
+      worker.join();
+      // verify
+      assertUnit(allPopped.load());
+   }  // teardown
+};
+
+#endif // DEBUG
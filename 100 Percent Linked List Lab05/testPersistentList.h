@@ -0,0 +1,371 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT LIST
+ * Summary:
+ *    Unit tests for persistent_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistentList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <deque>
+#include <vector>
+
+class TestPersistentList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_construct_copySharesNodes();
+
+      // Push and pop
+      test_pushFront_copyUnchanged();
+      test_pushBack_copyUnchanged();
+      test_pop_empty();
+      test_pop_splitsChain();
+      test_pushPop_againstDeque();
+
+      // Insert
+      test_insert_nearFrontShares();
+      test_insert_nearBackShares();
+      test_insert_end();
+      test_insert_beginOfPushedBack();
+      test_insert_beginOfPushedFront();
+
+      // Access
+      test_front_empty();
+
+      // Destruct
+      test_destructor_lastCopy();
+      test_destructor_longChain();
+
+      report("PersistentList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list has no chains
+   void test_construct_default()
+   {  // exercise
+      custom::persistent_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pFront == nullptr);
+      assertUnit(l.pBack == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // the elements come out in the order they went in
+   void test_construct_initializerList()
+   {  // exercise
+      custom::persistent_list<int> l{ 11, 26, 31, 42, 57 };
+      // verify
+      assertUnit(l.size() == 5);
+      assertUnit(l.front() == 11);
+      assertUnit(l.back() == 57);
+      assertUnit(elements(l) == std::vector<int>({ 11, 26, 31, 42, 57 }));
+      assertUnit(isSound(l));
+   }  // teardown
+
+   // a copy is a snapshot: no elements are copied
+   void test_construct_copySharesNodes()
+   {  // setup
+      custom::persistent_list<Spy> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      custom::persistent_list<Spy> copy(l);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(copy.pFront == l.pFront);
+      assertUnit(copy.pBack == l.pBack);
+      assertUnit(copy.size() == 100);
+      assertUnit(l.pFront->numRefs == 2);
+   }  // teardown
+
+   /***************************************
+    * PUSH and POP
+    ***************************************/
+
+   // the new node points at the shared chain
+   void test_pushFront_copyUnchanged()
+   {  // setup
+      custom::persistent_list<int> l{ 26, 31, 42 };
+      custom::persistent_list<int> copy(l);
+      // exercise
+      copy.push_front(11);
+      // verify
+      assertUnit(elements(l) == std::vector<int>({ 26, 31, 42 }));
+      assertUnit(elements(copy) == std::vector<int>({ 11, 26, 31, 42 }));
+      assertUnit(copy.pFront->pNext == l.pFront);
+      assertUnit(copy.pBack == l.pBack);
+   }  // teardown
+
+   // the same at the other end
+   void test_pushBack_copyUnchanged()
+   {  // setup
+      custom::persistent_list<int> l{ 11, 26, 31 };
+      custom::persistent_list<int> copy(l);
+      // exercise
+      copy.push_back(42);
+      // verify
+      assertUnit(elements(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(elements(copy) == std::vector<int>({ 11, 26, 31, 42 }));
+      assertUnit(copy.pFront == l.pFront);
+      assertUnit(copy.pBack->pNext == l.pBack);
+      assertUnit(isSound(l));
+      assertUnit(isSound(copy));
+   }  // teardown
+
+   // popping nothing does nothing, as with custom::list
+   void test_pop_empty()
+   {  // setup
+      custom::persistent_list<int> l{ 11 };
+      // exercise
+      l.pop_back();
+      l.pop_back();
+      l.pop_front();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(isSound(l));
+   }  // teardown
+
+   // running one chain dry splits the other
+   void test_pop_splitsChain()
+   {  // setup
+      custom::persistent_list<int> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      custom::persistent_list<int> copy(l);
+      size_t numFront = l.numFront;
+      // exercise
+      for (size_t i = 0; i < numFront; i++)
+         copy.pop_front();
+      // verify
+      assertUnit(copy.size() == 10 - numFront);
+      assertUnit(copy.numFront != 0 && copy.numBack != 0);
+      assertUnit(copy.front() == (int)numFront);
+      assertUnit(copy.back() == 9);
+      assertUnit(isSound(copy));
+      assertUnit(elements(l) == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+   }  // teardown
+
+   // every version, old and new, matches a deque that was copied for real
+   void test_pushPop_againstDeque()
+   {  // setup
+      std::vector<custom::persistent_list<int>> versions(1);
+      std::vector<std::deque<int>> expected(1);
+      unsigned int seed = 7;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         size_t from = (seed >> 8) % versions.size();
+         custom::persistent_list<int> l(versions[from]);
+         std::deque<int> d(expected[from]);
+         switch ((seed >> 20) % 4)
+         {
+            case 0: l.push_front(i); d.push_front(i); break;
+            case 1: l.push_back(i);  d.push_back(i);  break;
+            case 2: l.pop_front(); if (!d.empty()) d.pop_front(); break;
+            case 3: l.pop_back();  if (!d.empty()) d.pop_back();  break;
+         }
+         versions.push_back(l);
+         expected.push_back(d);
+      }
+      // verify
+      bool same = true;
+      for (size_t i = 0; i < versions.size(); i++)
+         same = same && isSound(versions[i]) &&
+                elements(versions[i]) == std::vector<int>(expected[i].begin(), expected[i].end());
+      assertUnit(same);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the nodes ahead are built again, the rest are shared
+   void test_insert_nearFrontShares()
+   {  // setup
+      custom::persistent_list<int> l{ 11, 26, 31, 42, 57, 63, 71, 80 };
+      custom::persistent_list<int> copy(l);
+      auto it = copy.begin();
+      ++it;
+      ++it;
+      // exercise
+      copy.insert(it, 99);
+      // verify
+      assertUnit(elements(l) == std::vector<int>({ 11, 26, 31, 42, 57, 63, 71, 80 }));
+      assertUnit(elements(copy) == std::vector<int>({ 11, 26, 99, 31, 42, 57, 63, 71, 80 }));
+      assertUnit(copy.pFront->pNext->pNext->pNext == l.pFront->pNext->pNext);
+      assertUnit(copy.pBack == l.pBack);
+      assertUnit(isSound(copy));
+   }  // teardown
+
+   // the nodes behind are built again, the rest are shared
+   void test_insert_nearBackShares()
+   {  // setup
+      custom::persistent_list<int> l{ 11, 26, 31, 42, 57, 63, 71, 80 };
+      custom::persistent_list<int> copy(l);
+      auto it = copy.begin();
+      for (int i = 0; i < 6; i++)
+         ++it;
+      // exercise
+      copy.insert(it, 99);
+      // verify
+      assertUnit(elements(l) == std::vector<int>({ 11, 26, 31, 42, 57, 63, 71, 80 }));
+      assertUnit(elements(copy) == std::vector<int>({ 11, 26, 31, 42, 57, 63, 99, 71, 80 }));
+      assertUnit(copy.pFront == l.pFront);
+      assertUnit(copy.pBack->pNext->pNext->pNext == l.pBack->pNext->pNext);
+      assertUnit(isSound(copy));
+   }  // teardown
+
+   // inserting at the end is pushing on the back
+   void test_insert_end()
+   {  // setup
+      custom::persistent_list<int> l;
+      // exercise
+      l.insert(l.end(), 26);
+      l.insert(l.begin(), 11);
+      l.insert(l.end(), 31);
+      // verify
+      assertUnit(elements(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(isSound(l));
+   }  // teardown
+
+   // a second element, put in front of one on the back chain, splits
+   void test_insert_beginOfPushedBack()
+   {  // setup
+      custom::persistent_list<int> l;
+      l.push_back(26);
+      // exercise
+      l.insert(l.begin(), 11);
+      // verify
+      assertUnit(isSound(l));
+      assertUnit(l.front() == 11);
+      assertUnit(l.back() == 26);
+      l.pop_front();
+      assertUnit(l.size() == 1);
+      assertUnit(elements(l) == std::vector<int>({ 26 }));
+   }  // teardown
+
+   // and so does one put in front of one on the front chain
+   void test_insert_beginOfPushedFront()
+   {  // setup
+      custom::persistent_list<int> l;
+      l.push_front(26);
+      // exercise
+      l.insert(l.begin(), 11);
+      // verify
+      assertUnit(isSound(l));
+      assertUnit(l.front() == 11);
+      assertUnit(l.back() == 26);
+      l.pop_back();
+      assertUnit(l.size() == 1);
+      assertUnit(elements(l) == std::vector<int>({ 11 }));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // there is no front of nothing
+   void test_front_empty()
+   {  // setup
+      custom::persistent_list<int> l;
+      bool thrownFront = false;
+      bool thrownBack = false;
+      // exercise
+      try { l.front(); } catch (const char *) { thrownFront = true; }
+      try { l.back();  } catch (const char *) { thrownBack = true;  }
+      // verify
+      assertUnit(thrownFront);
+      assertUnit(thrownBack);
+   }  // teardown
+
+   /***************************************
+    * DESTRUCTOR
+    ***************************************/
+
+   // a node goes when the last copy holding it goes
+   void test_destructor_lastCopy()
+   {  // setup
+      custom::persistent_list<Spy> * pList = new custom::persistent_list<Spy>;
+      for (int i = 0; i < 20; i++)
+         pList->push_front(Spy(i));
+      custom::persistent_list<Spy> * pCopy = new custom::persistent_list<Spy>(*pList);
+      pCopy->pop_front();
+      Spy::reset();
+      // exercise
+      delete pList;
+      int numAfterFirst = Spy::numDestructor();
+      delete pCopy;
+      // verify
+      assertUnit(numAfterFirst == 1);
+      assertUnit(Spy::numDestructor() == 20);
+      assertUnit(Spy::numDelete() == 20);
+   }  // teardown
+
+   // letting go of a long chain is a loop, not a recursion
+   void test_destructor_longChain()
+   {  // setup
+      custom::persistent_list<int> * pList = new custom::persistent_list<int>;
+      for (int i = 0; i < 1000000; i++)
+         pList->push_front(i);
+      // exercise
+      delete pList;
+      // verify
+      assertUnit(true);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   // every element, front to back
+   template <class T>
+   std::vector<T> elements(custom::persistent_list<T> & l)
+   {
+      std::vector<T> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+
+   // the counts match the chains, and both chains have some
+   // of the elements once there are two or more
+   template <class T>
+   bool isSound(custom::persistent_list<T> & l)
+   {
+      size_t num = 0;
+      for (auto p = l.pFront; p; p = p->pNext)
+         num++;
+      if (num != l.numFront)
+         return false;
+      num = 0;
+      for (auto p = l.pBack; p; p = p->pNext)
+         num++;
+      if (num != l.numBack)
+         return false;
+      return l.size() < 2 || (l.numFront != 0 && l.numBack != 0);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,290 @@
+/***********************************************************************
+ * Header:
+ *    TEST RCU LIST
+ * Summary:
+ *    Unit tests for rcu_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "rcuList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestRcuList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_spy();
+
+      // Read
+      test_find_present();
+      test_findIf_copiesOut();
+
+      // Write
+      test_pushfront_order();
+      test_pushback_order();
+      test_replace_middle();
+      test_replace_tail();
+      test_erase_tail();
+      test_erase_retires();
+      test_clear_retires();
+
+      // Threads
+      test_threads_readWhileWriting();
+
+      report("RcuList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list has no nodes
+   void test_construct_default()
+   {  // exercise
+      custom::rcu_list<int> l;
+      // verify
+      assertUnit(l.pHead.load() == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.empty());
+      assertUnit(&l.domain == &custom::epoch_domain::global());
+   }  // teardown
+
+   // the destructor frees everything still linked
+   void test_destructor_spy()
+   {  // setup
+      custom::epoch_domain domain;
+      {
+         custom::rcu_list<Spy> l(domain);
+         for (int i = 0; i < 5; i++)
+            l.push_back(Spy(i));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 5);
+      assertUnit(Spy::numDelete() == 5);
+   }  // teardown
+
+   /***************************************
+    * READ
+    ***************************************/
+
+   // find sees what is there and not what is not
+   void test_find_present()
+   {  // setup
+      custom::rcu_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      // exercise and verify
+      assertUnit(l.find(11));
+      assertUnit(l.find(26));
+      assertUnit(!l.find(31));
+   }  // teardown
+
+   // find_if copies the match out
+   void test_findIf_copiesOut()
+   {  // setup
+      custom::rcu_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      int result = 0;
+      // exercise
+      bool found = l.find_if([](int value) { return value > 20; }, result);
+      // verify
+      assertUnit(found);
+      assertUnit(result == 26);
+      assertUnit(!l.find_if([](int value) { return value > 99; }, result));
+      assertUnit(result == 26);
+   }  // teardown
+
+   /***************************************
+    * WRITE
+    ***************************************/
+
+   // push_front puts each new element first
+   void test_pushfront_order()
+   {  // setup
+      custom::rcu_list<int> l;
+      // exercise
+      l.push_front(31);
+      l.push_front(26);
+      l.push_front(11);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.pTail->data == 31);
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // push_back puts each new element last
+   void test_pushback_order()
+   {  // setup
+      custom::rcu_list<int> l;
+      // exercise
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // replace swaps in a copy; the old node keeps its link
+   void test_replace_middle()
+   {  // setup
+      custom::epoch_domain domain;
+      custom::rcu_list<int> l(domain);
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      auto pOld = l.pHead.load()->pNext.load();
+      auto p31 = pOld->pNext.load();
+      // exercise
+      bool replaced;
+      {
+         custom::epoch_guard guard(domain);   // as if a reader stood on 26
+         replaced = l.replace(26, 99);
+         // verify
+         assertUnit(pOld->data == 26);
+         assertUnit(pOld->pNext.load() == p31);
+      }
+      assertUnit(replaced);
+      assertUnit(toVector(l) == std::vector<int>({ 11, 99, 31 }));
+      assertUnit(l.size() == 3);
+      assertUnit(!l.replace(26, 0));
+   }  // teardown
+
+   // replacing the last node moves the tail to the copy
+   void test_replace_tail()
+   {  // setup
+      custom::rcu_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      // exercise
+      l.replace(26, 99);
+      l.push_back(31);
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 11, 99, 31 }));
+   }  // teardown
+
+   // erasing the last node moves the tail back
+   void test_erase_tail()
+   {  // setup
+      custom::rcu_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      // exercise
+      bool erased = l.erase(26);
+      l.push_back(31);
+      // verify
+      assertUnit(erased);
+      assertUnit(toVector(l) == std::vector<int>({ 11, 31 }));
+      assertUnit(!l.erase(26));
+      l.erase(11);
+      l.erase(31);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.empty());
+   }  // teardown
+
+   // an erased node waits in the domain for readers to leave
+   void test_erase_retires()
+   {  // setup
+      custom::epoch_domain domain;
+      custom::rcu_list<Spy> l(domain);
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      Spy::reset();
+      // exercise
+      l.erase(Spy(11));
+      // verify
+      assertUnit(Spy::numDestructor() == 1);   // just the temporary
+      domain.synchronize();
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(l.size() == 1);
+   }  // teardown
+
+   // clear empties the list at once and retires the nodes
+   void test_clear_retires()
+   {  // setup
+      custom::epoch_domain domain;
+      custom::rcu_list<Spy> l(domain);
+      for (int i = 0; i < 5; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.pHead.load() == nullptr);
+      assertUnit(l.empty());
+      assertUnit(Spy::numDestructor() == 0);
+      domain.synchronize();
+      assertUnit(Spy::numDestructor() == 5);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // readers always see a whole list while a writer replaces
+   void test_threads_readWhileWriting()
+   {  // setup
+      const int num = 64;
+      const int numReaders = 4;
+      custom::rcu_list<int> l;
+      for (int i = 0; i < num; i++)
+         l.push_back(i);
+      std::atomic<bool> done(false);
+      std::atomic<bool> whole(true);
+      // exercise
+      std::vector<std::thread> readers;
+      for (int t = 0; t < numReaders; t++)
+         readers.push_back(std::thread([&]()
+         {
+            while (!done)
+            {
+               int count = 0;
+               l.for_each([&](int) { count++; });
+               if (count != num)
+                  whole = false;
+            }
+         }));
+      for (int round = 0; round < 20; round++)
+         for (int i = 0; i < num; i++)
+            l.replace(round * num + i, (round + 1) * num + i);
+      done = true;
+      for (auto & reader : readers)
+         reader.join();
+      // verify
+      assertUnit(whole.load());
+      assertUnit(l.find(20 * num));
+      assertUnit(l.size() == num);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+
+   std::vector<int> toVector(const custom::rcu_list<int> & l)
+   {
+      std::vector<int> v;
+      l.for_each([&](const int & value) { v.push_back(value); });
+      return v;
+   }
+};
+
+#endif // DEBUG
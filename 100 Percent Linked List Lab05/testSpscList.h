@@ -0,0 +1,299 @@
+/***********************************************************************
+ * Header:
+ *    TEST SPSC LIST
+ * Summary:
+ *    Unit tests for spsc_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "spscList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class TestSpscList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_layout();
+      test_destructor_spy();
+
+      // Producer
+      test_pushback_one();
+      test_pushback_spy();
+
+      // Consumer
+      test_front_empty();
+      test_popfront_empty();
+      test_popfront_fifo();
+      test_size_popCountedFirst();
+      test_empty_pushCountedFirst();
+
+      // Node cache
+      test_cache_reused();
+      test_cache_steadyState();
+
+      // Threads
+      test_threads_producerConsumer();
+
+      report("SpscList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty list is one dummy node
+   void test_construct_default()
+   {  // exercise
+      custom::spsc_list<int> l;
+      // verify
+      assertUnit(l.pHead.load() != nullptr);
+      assertUnit(l.pHead.load() == l.pTail);
+      assertUnit(l.pFirst == l.pTail);
+      assertUnit(l.pTail->pNext.load() == nullptr);
+      assertUnit(l.numNodes == 1);
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+   }  // teardown
+
+   // the two threads' members sit on different cache lines
+   void test_construct_layout()
+   {  // exercise
+      custom::spsc_list<int> l;
+      // verify
+      uintptr_t consumer = reinterpret_cast<uintptr_t>(&l.pHead);
+      uintptr_t producer = reinterpret_cast<uintptr_t>(&l.pTail);
+      assertUnit(producer - consumer >= 64);
+      assertUnit(consumer / 64 != reinterpret_cast<uintptr_t>(&l.numPushed) / 64);
+   }  // teardown
+
+   // the destructor destroys only what was never popped
+   void test_destructor_spy()
+   {  // setup
+      {
+         custom::spsc_list<Spy> l;
+         for (int i = 0; i < 5; i++)
+            l.push_back(Spy(i));
+         l.pop_front();
+         l.pop_front();
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+   }  // teardown
+
+   /***************************************
+    * PRODUCER
+    ***************************************/
+
+   // one push hangs a node off the dummy
+   void test_pushback_one()
+   {  // setup
+      custom::spsc_list<int> l;
+      auto pDummy = l.pHead.load();
+      // exercise
+      l.push_back(99);
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(l.pHead.load() == pDummy);
+      assertUnit(pDummy->pNext.load() == l.pTail);
+      assertUnit(*l.pTail->data() == 99);
+      assertUnit(l.front() == 99);
+   }  // teardown
+
+   // elements are copied or moved in, never both
+   void test_pushback_spy()
+   {  // setup
+      custom::spsc_list<Spy> l;
+      Spy s1(11);
+      Spy s2(26);
+      Spy::reset();
+      // exercise
+      l.push_back(s1);
+      l.push_back(std::move(s2));
+      // verify
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(l.front().get() == 11);
+   }  // teardown
+
+   /***************************************
+    * CONSUMER
+    ***************************************/
+
+   // front of nothing throws, as list's does
+   void test_front_empty()
+   {  // setup
+      custom::spsc_list<int> l;
+      // exercise
+      bool thrown = false;
+      try
+      {
+         l.front();
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // popping nothing does nothing
+   void test_popfront_empty()
+   {  // setup
+      custom::spsc_list<int> l;
+      auto pDummy = l.pHead.load();
+      // exercise
+      l.pop_front();
+      // verify
+      assertUnit(l.pHead.load() == pDummy);
+      assertUnit(l.size() == 0);
+   }  // teardown
+
+   // first in, first out
+   void test_popfront_fifo()
+   {  // setup
+      custom::spsc_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // exercise
+      std::vector<int> v;
+      while (!l.empty())
+      {
+         v.push_back(l.front());
+         l.pop_front();
+      }
+      // verify
+      assertUnit(v == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.pHead.load() == l.pTail);
+   }  // teardown
+
+   // a reader that sees the pop counted before the push is told the
+   // list is empty, not that it holds nearly 2^64 elements
+   void test_size_popCountedFirst()
+   {  // setup
+      custom::spsc_list<int> l;
+      l.push_back(11);
+      l.pop_front();
+      // exercise
+      l.numPushed.store(0);
+      // verify
+      assertUnit(l.size() == 0);
+      assertUnit(l.empty());
+   }  // teardown
+
+   // a push that is counted but not yet linked is not there to pop
+   void test_empty_pushCountedFirst()
+   {  // setup
+      custom::spsc_list<int> l;
+      l.push_back(11);
+      l.pop_front();
+      // exercise
+      l.numPushed.store(2);
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead.load()->pNext.load() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * NODE CACHE
+    ***************************************/
+
+   // a consumed node is the next one the producer uses
+   void test_cache_reused()
+   {  // setup
+      custom::spsc_list<int> l;
+      auto pDummy = l.pHead.load();
+      l.push_back(11);
+      l.pop_front();
+      // exercise
+      l.push_back(26);
+      // verify
+      assertUnit(l.pTail == pDummy);
+      assertUnit(l.numNodes == 2);
+      assertUnit(l.front() == 26);
+   }  // teardown
+
+   // once warm, pushing and popping allocates nothing
+   void test_cache_steadyState()
+   {  // setup
+      custom::spsc_list<int> l;
+      for (int i = 0; i < 8; i++)
+         l.push_back(i);
+      for (int i = 0; i < 8; i++)
+         l.pop_front();
+      size_t numNodes = l.numNodes;
+      // exercise
+      for (int round = 0; round < 1000; round++)
+      {
+         for (int i = 0; i < 8; i++)
+            l.push_back(i);
+         for (int i = 0; i < 8; i++)
+            l.pop_front();
+      }
+      // verify
+      assertUnit(l.numNodes == numNodes);
+      assertUnit(numNodes == 9);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // everything arrives once and in order
+   void test_threads_producerConsumer()
+   {  // setup
+      const int num = 20000;
+      custom::spsc_list<int> l;
+      bool inOrder = true;
+      long long total = 0;
+      // exercise
+      std::thread producer([&l]()
+      {
+         for (int i = 0; i < num; i++)
+            l.push_back(i);
+      });
+      std::thread consumer([&]()
+      {
+         for (int expected = 0; expected < num; )
+            if (l.empty())
+               std::this_thread::yield();
+            else
+            {
+               if (l.front() != expected)
+                  inOrder = false;
+               total += l.front();
+               l.pop_front();
+               expected++;
+            }
+      });
+      producer.join();
+      consumer.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(total == (long long)num * (num - 1) / 2);
+      assertUnit(l.empty());
+      assertUnit(l.numNodes <= num + 1);
+   }  // teardown
+};
+
+#endif // DEBUG
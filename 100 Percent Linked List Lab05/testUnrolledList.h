@@ -0,0 +1,386 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for unrolled_list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolledList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <vector>
+
+// an element whose copy fails when its value is negative
+struct Picky
+{
+   explicit Picky(int value) : value(value) {}
+   Picky(const Picky & rhs) : value(rhs.value)
+   {
+      if (value < 0)
+         throw("ERROR: unable to copy a negative value");
+   }
+   int value;
+};
+
+class TestUnrolledList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit_standard();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Insert
+      test_pushback_fillsBlocks();
+      test_pushfront_splits();
+      test_insert_middleSplit();
+      test_insert_returnsNew();
+      test_insert_throwsMiddle();
+      test_insert_throwsNewBlock();
+
+      // Remove
+      test_erase_middle();
+      test_erase_mergesBlocks();
+      test_erase_emptiesBlock();
+      test_popfront_popback();
+      test_clear_spy();
+
+      // Iterator
+      test_iterator_forwardBackward();
+      test_iterator_matchesVector();
+
+      report("UnrolledList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no blocks
+   void test_construct_default()
+   {  // exercise
+      custom::unrolled_list<int, 4> l;
+      // verify
+      assertUnit(l.numElements == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // six elements fill one block of four and half of another
+   void test_constructInit_standard()
+   {  // exercise
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6 };
+      // verify
+      assertUnit(l.numElements == 6);
+      assertUnit(l.pHead != nullptr);
+      assertUnit(l.pHead->count == 4);
+      assertUnit(l.pHead->pNext == l.pTail);
+      assertUnit(l.pTail->count == 2);
+      assertUnit(l.pTail->pPrev == l.pHead);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertUnit(toVector(l) == std::vector<int>({ 1, 2, 3, 4, 5, 6 }));
+   }  // teardown
+
+   // copies share no blocks
+   void test_constructCopy_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> lSrc{ 1, 2, 3, 4, 5, 6 };
+      // exercise
+      custom::unrolled_list<int, 4> lDes(lSrc);
+      // verify
+      assertUnit(lDes.pHead != lSrc.pHead);
+      assertUnit(lDes.numElements == 6);
+      assertUnit(toVector(lDes) == toVector(lSrc));
+   }  // teardown
+
+   // the move constructor steals the blocks
+   void test_constructMove_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> lSrc{ 1, 2, 3, 4, 5, 6 };
+      auto pHead = lSrc.pHead;
+      // exercise
+      custom::unrolled_list<int, 4> lDes(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(lSrc.numElements == 0);
+      assertUnit(lDes.pHead == pHead);
+      assertUnit(lDes.numElements == 6);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back only starts a new block when the last is full
+   void test_pushback_fillsBlocks()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(countBlocks(l) == 3);
+      assertUnit(l.pHead->count == 4);
+      assertUnit(l.pTail->count == 1);
+      assertUnit(l.back() == 8);
+      assertUnit(l.front() == 0);
+   }  // teardown
+
+   // push_front into a full block splits it
+   void test_pushfront_splits()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      // exercise
+      l.push_front(0);
+      // verify
+      assertUnit(countBlocks(l) == 2);
+      assertUnit(l.pHead->count == 3);
+      assertUnit(l.pTail->count == 2);
+      assertUnit(toVector(l) == std::vector<int>({ 0, 1, 2, 3, 4 }));
+   }  // teardown
+
+   // inserting into the upper half of a full block lands in the new block
+   void test_insert_middleSplit()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      custom::unrolled_list<int, 4>::iterator it(l.pHead, 3);
+      // exercise
+      it = l.insert(it, 99);
+      // verify
+      assertUnit(countBlocks(l) == 2);
+      assertUnit(it.p == l.pTail);
+      assertUnit(*it == 99);
+      assertUnit(toVector(l) == std::vector<int>({ 1, 2, 3, 99, 4 }));
+   }  // teardown
+
+   // insert returns an iterator to what it inserted
+   void test_insert_returnsNew()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3 };
+      custom::unrolled_list<int, 4>::iterator it(l.pHead, 1);
+      // exercise
+      it = l.insert(it, 99);
+      // verify
+      assertUnit(*it == 99);
+      assertUnit(it.i == 1);
+      assertUnit(countBlocks(l) == 1);
+      assertUnit(toVector(l) == std::vector<int>({ 1, 99, 2, 3 }));
+   }  // teardown
+
+   // an element that fails to build leaves the block as it was
+   void test_insert_throwsMiddle()
+   {  // setup
+      custom::unrolled_list<Picky, 4> l;
+      for (int i = 0; i < 3; i++)
+         l.push_back(Picky(i));
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.insert(custom::unrolled_list<Picky, 4>::iterator(l.pHead, 1), Picky(-1));
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.size() == 3);
+      assertUnit(l.pHead->count == 3);
+      assertUnit((*l.pHead)[0].value == 0);
+      assertUnit((*l.pHead)[1].value == 1);
+      assertUnit((*l.pHead)[2].value == 2);
+   }  // teardown
+
+   // a block opened for an element that fails to build goes away again
+   void test_insert_throwsNewBlock()
+   {  // setup
+      custom::unrolled_list<Picky, 4> l;
+      for (int i = 0; i < 4; i++)
+         l.push_back(Picky(i));
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.push_back(Picky(-1));
+      }
+      catch (const char *)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.size() == 4);
+      assertUnit(countBlocks(l) == 1);
+      assertUnit(l.pHead == l.pTail);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase slides the rest of the block down
+   void test_erase_middle()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      custom::unrolled_list<int, 4>::iterator it(l.pHead, 1);
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(l.numElements == 3);
+      assertUnit(toVector(l) == std::vector<int>({ 1, 3, 4 }));
+   }  // teardown
+
+   // a block less than half full absorbs its neighbor
+   void test_erase_mergesBlocks()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6 };
+      l.erase(custom::unrolled_list<int, 4>::iterator(l.pHead, 0));
+      l.erase(custom::unrolled_list<int, 4>::iterator(l.pHead, 0));
+      assertUnit(countBlocks(l) == 2);
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it =
+         l.erase(custom::unrolled_list<int, 4>::iterator(l.pHead, 1));
+      // verify
+      assertUnit(countBlocks(l) == 1);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(*it == 5);
+      assertUnit(toVector(l) == std::vector<int>({ 3, 5, 6 }));
+   }  // teardown
+
+   // erasing the last element of a block frees the block
+   void test_erase_emptiesBlock()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5 };
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it =
+         l.erase(custom::unrolled_list<int, 4>::iterator(l.pTail, 0));
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(countBlocks(l) == 1);
+      assertUnit(l.pTail == l.pHead);
+      assertUnit(l.back() == 4);
+   }  // teardown
+
+   // pop both ends down to nothing
+   void test_popfront_popback()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6, 7 };
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(toVector(l) == std::vector<int>({ 2, 3, 4, 5, 6 }));
+      while (!l.empty())
+         l.pop_back();
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // clear destroys every element it built
+   void test_clear_spy()
+   {  // setup
+      custom::unrolled_list<Spy, 4> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(Spy(i));
+      l.erase(custom::unrolled_list<Spy, 4>::iterator(l.pHead, 2));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 9);
+      assertUnit(Spy::numDelete() == 9);
+      assertUnit(l.empty());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward across blocks then back
+   void test_iterator_forwardBackward()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6 };
+      custom::unrolled_list<int, 4>::iterator it = l.begin();
+      // exercise
+      for (int i = 0; i < 5; i++)
+         ++it;
+      // verify
+      assertUnit(*it == 6);
+      it--;
+      it--;
+      assertUnit(*it == 4);
+      assertUnit(it.p == l.pHead);
+      ++it;
+      ++it;
+      ++it;
+      assertUnit(it == l.end());
+   }  // teardown
+
+   // a mix of inserts and erases keeps the same order as a vector
+   void test_iterator_matchesVector()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      std::vector<int> v;
+      unsigned int seed = 7;
+      // exercise
+      for (int i = 0; i < 500; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         size_t pos = v.empty() ? 0 : (seed >> 8) % (v.size() + 1);
+         custom::unrolled_list<int, 4>::iterator it = l.begin();
+         for (size_t j = 0; j < pos; j++)
+            ++it;
+         if (((seed >> 4) & 3) == 0 && pos < v.size())
+         {
+            l.erase(it);
+            v.erase(v.begin() + pos);
+         }
+         else
+         {
+            l.insert(it, i);
+            v.insert(v.begin() + pos, i);
+         }
+      }
+      // verify
+      assertUnit(l.size() == v.size());
+      assertUnit(toVector(l) == v);
+   }  // teardown
+
+   /****************************************************************
+    * Helpers
+    ****************************************************************/
+   template <size_t N>
+   std::vector<int> toVector(custom::unrolled_list<int, N> & l)
+   {
+      std::vector<int> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+
+   template <class T, size_t N>
+   size_t countBlocks(custom::unrolled_list<T, N> & l)
+   {
+      size_t num = 0;
+      for (auto p = l.pHead; p; p = p->pNext)
+         num++;
+      return num;
+   }
+};
+
+#endif // DEBUG
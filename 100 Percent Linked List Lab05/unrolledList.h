@@ -0,0 +1,666 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A linked list that keeps up to N elements in each node, so a
+ *    traversal takes one cache miss per block rather than per element.
+ *    It has the same interface as custom::list.
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list : A class that represents an unrolled list
+ *        iterator      : An iterator through the unrolled list
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <memory>      // for std::allocator
+#include <new>         // for placement new
+#include <type_traits> // for std::aligned_storage
+#include <utility>     // for std::move
+
+class TestUnrolledList;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * UNROLLED LIST
+ * Just like custom::list, except each Block holds up
+ * to N elements in a contiguous array.  Blocks are
+ * split when an insert overflows them and merged
+ * with their neighbor when an erase leaves them
+ * less than half full.
+ *
+ * Inserting invalidates the iterators into the
+ * block being changed.  Erasing does too, and when
+ * that block absorbs its successor, the iterators
+ * into the successor as well.  The iterator that
+ * is returned is always valid.
+ **************************************************/
+template <typename T, size_t N = 16, typename A = std::allocator<T>>
+class unrolled_list
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   static_assert(N >= 2, "a block must hold at least two elements");
+public:
+   //
+   // Construct
+   //
+
+   unrolled_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+   unrolled_list(const unrolled_list & rhs);
+   unrolled_list(unrolled_list && rhs);
+   unrolled_list(size_t num, const T & t);
+   unrolled_list(const std::initializer_list<T> & il);
+   template <class Iterator>
+   unrolled_list(Iterator first, Iterator last);
+  ~unrolled_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   unrolled_list & operator = (const unrolled_list & rhs);
+   unrolled_list & operator = (unrolled_list && rhs);
+   unrolled_list & operator = (const std::initializer_list<T> & il);
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() { return iterator(pHead, 0); }
+   iterator end()   { return iterator(nullptr, 0); }
+
+   //
+   // Access
+   //
+
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  data) { insert(begin(), data);            }
+   void push_front(      T && data) { insert(begin(), std::move(data)); }
+   void push_back (const T &  data);
+   void push_back (      T && data);
+   iterator insert(iterator it, const T &  data);
+   iterator insert(iterator it,       T && data);
+
+   //
+   // Remove
+   //
+
+   void pop_back();
+   void pop_front();
+   void clear();
+   iterator erase(const iterator & it);
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+   // nested block class
+   class Block;
+
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Block> BlockAlloc;
+   typedef std::allocator_traits<BlockAlloc> BlockTraits;
+
+   Block * createBlock();
+   void destroyBlock(Block * pBlock);
+   Block * splitBlock(Block * pBlock);
+   void mergeNext(Block * pBlock);
+   void removeBlock(Block * pBlock);
+   template <class U>
+   iterator insertValue(iterator it, U && data);
+
+   // member variables
+   size_t numElements; // total number of elements in every block
+   Block * pHead;      // the first block
+   Block * pTail;      // the last block
+   BlockAlloc alloc;   // where the blocks come from
+};
+
+/*************************************************
+ * BLOCK
+ * One node of the unrolled list: a small array of
+ * elements.  The slots [0, count) are constructed,
+ * the rest are raw storage.
+ *************************************************/
+template <typename T, size_t N, typename A>
+class unrolled_list <T, N, A> :: Block
+{
+public:
+   Block() : count(0), pNext(nullptr), pPrev(nullptr) {}
+
+   T & operator [] (size_t i) { return *reinterpret_cast<T *>(&slots[i]); }
+
+   // build an element in raw slot i
+   template <class U>
+   void construct(size_t i, U && data) { new (&slots[i]) T(std::forward<U>(data)); }
+
+   // move the element in slot iFrom to the raw slot iTo of pTo
+   void relocate(size_t iFrom, Block * pTo, size_t iTo)
+   {
+      pTo->construct(iTo, std::move((*this)[iFrom]));
+      (*this)[iFrom].~T();
+   }
+
+   // open a hole at slot i by sliding [i, count) up one
+   void openGap(size_t i)
+   {
+      assert(count < N);
+      for (size_t j = count; j > i; j--)
+         relocate(j - 1, this, j);
+   }
+
+   // close the hole at slot i by sliding (i, count) down one
+   void closeGap(size_t i)
+   {
+      for (size_t j = i + 1; j < count; j++)
+         relocate(j, this, j - 1);
+   }
+
+   typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[N];
+   size_t count;  // number of elements in this block
+   Block * pNext; // pointer to the next block
+   Block * pPrev; // pointer to the previous block
+};
+
+/*************************************************
+ * UNROLLED LIST ITERATOR
+ * A block and a position within it
+ *************************************************/
+template <typename T, size_t N, typename A>
+class unrolled_list <T, N, A> :: iterator
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   friend class unrolled_list;
+public:
+   // constructors, destructors, and assignment operator
+   iterator()                            : p(nullptr), i(0) {}
+   iterator(Block * p, size_t i)         : p(p), i(i)       {}
+   iterator(const iterator & rhs)        : p(rhs.p), i(rhs.i) {}
+   iterator & operator = (const iterator & rhs)
+   {
+      p = rhs.p;
+      i = rhs.i;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p && i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs);          }
+
+   // dereference operator, fetch an element
+   T & operator * () { return (*p)[i]; }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      if (++i == p->count)
+      {
+         p = p->pNext;
+         i = 0;
+      }
+      return *this;
+   }
+
+   // postfix increment
+   iterator operator ++ (int)
+   {
+      iterator itOld = *this;
+      ++(*this);
+      return itOld;
+   }
+
+   // prefix decrement
+   iterator & operator -- ()
+   {
+      if (i == 0)
+      {
+         p = p->pPrev;
+         i = p ? p->count - 1 : 0;
+      }
+      else
+         i--;
+      return *this;
+   }
+
+   // postfix decrement
+   iterator operator -- (int)
+   {
+      iterator itOld = *this;
+      --(*this);
+      return itOld;
+   }
+
+private:
+   Block * p;  // the block we are in
+   size_t i;   // the slot in that block
+};
+
+/*****************************************
+ * UNROLLED LIST :: COPY constructor
+ ****************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> ::unrolled_list(const unrolled_list & rhs) :
+   numElements(0), pHead(nullptr), pTail(nullptr),
+   alloc(BlockTraits::select_on_container_copy_construction(rhs.alloc))
+{
+   *this = rhs;
+}
+
+/*****************************************
+ * UNROLLED LIST :: MOVE constructor
+ * Steal the blocks from the RHS
+ ****************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> ::unrolled_list(unrolled_list && rhs) :
+   numElements(rhs.numElements), pHead(rhs.pHead), pTail(rhs.pTail),
+   alloc(std::move(rhs.alloc))
+{
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+}
+
+/*****************************************
+ * UNROLLED LIST :: FILL constructor
+ ****************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> ::unrolled_list(size_t num, const T & t) :
+   numElements(0), pHead(nullptr), pTail(nullptr)
+{
+   for (size_t i = 0; i < num; i++)
+      push_back(t);
+}
+
+/*****************************************
+ * UNROLLED LIST :: INITIALIZER constructor
+ ****************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> ::unrolled_list(const std::initializer_list<T> & il) :
+   numElements(0), pHead(nullptr), pTail(nullptr)
+{
+   for (const T & t : il)
+      push_back(t);
+}
+
+/*****************************************
+ * UNROLLED LIST :: RANGE constructor
+ ****************************************/
+template <typename T, size_t N, typename A>
+template <class Iterator>
+unrolled_list <T, N, A> ::unrolled_list(Iterator first, Iterator last) :
+   numElements(0), pHead(nullptr), pTail(nullptr)
+{
+   for (Iterator it = first; it != last; ++it)
+      push_back(*it);
+}
+
+/**********************************************
+ * UNROLLED LIST :: assignment operator
+ * Copy one list onto another.  The blocks come
+ * out packed full regardless of the RHS's shape.
+ *     INPUT  : a list to be copied
+ *     OUTPUT :
+ *     COST   : O(n)
+ *********************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> & unrolled_list <T, N, A> :: operator = (const unrolled_list & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   for (Block * pBlock = rhs.pHead; pBlock; pBlock = pBlock->pNext)
+      for (size_t i = 0; i < pBlock->count; i++)
+         push_back((*pBlock)[i]);
+   return *this;
+}
+
+/**********************************************
+ * UNROLLED LIST :: assignment operator - MOVE
+ *     INPUT  : a list to be moved
+ *     OUTPUT :
+ *     COST   : O(n) with respect to the size of the LHS
+ *********************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> & unrolled_list <T, N, A> :: operator = (unrolled_list && rhs)
+{
+   clear();
+   alloc = std::move(rhs.alloc);
+
+   pHead = rhs.pHead;
+   pTail = rhs.pTail;
+   numElements = rhs.numElements;
+
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+   return *this;
+}
+
+/**********************************************
+ * UNROLLED LIST :: assignment operator - INITIALIZER
+ *     INPUT  : the values to be copied
+ *     OUTPUT :
+ *     COST   : O(n)
+ *********************************************/
+template <typename T, size_t N, typename A>
+unrolled_list <T, N, A> & unrolled_list <T, N, A> :: operator = (const std::initializer_list<T> & il)
+{
+   clear();
+   for (const T & t : il)
+      push_back(t);
+   return *this;
+}
+
+/*********************************************
+ * UNROLLED LIST :: FRONT and BACK
+ * retrieve the first or the last element
+ *     INPUT  :
+ *     OUTPUT : the element
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t N, typename A>
+T & unrolled_list <T, N, A> :: front()
+{
+   if (pHead)
+      return (*pHead)[0];
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+template <typename T, size_t N, typename A>
+T & unrolled_list <T, N, A> :: back()
+{
+   if (pTail)
+      return (*pTail)[pTail->count - 1];
+   else
+      throw("ERROR: unable to access data from an empty list");
+}
+
+/*********************************************
+ * UNROLLED LIST :: PUSH BACK
+ * add an element to the end, opening a new block
+ * only when the last one is full
+ *    INPUT  : data to be added to the list
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: push_back(const T & data)
+{
+   insertValue(end(), data);
+}
+
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: push_back(T && data)
+{
+   insertValue(end(), std::move(data));
+}
+
+/******************************************
+ * UNROLLED LIST :: INSERT
+ * add an element before the iterator
+ *     INPUT  : an iterator to the location where it is to be inserted
+ *              data to be added to the list
+ *     OUTPUT : iterator to the new element
+ *     COST   : O(N)
+ ******************************************/
+template <typename T, size_t N, typename A>
+typename unrolled_list <T, N, A> :: iterator
+unrolled_list <T, N, A> :: insert(iterator it, const T & data)
+{
+   return insertValue(it, data);
+}
+
+template <typename T, size_t N, typename A>
+typename unrolled_list <T, N, A> :: iterator
+unrolled_list <T, N, A> :: insert(iterator it, T && data)
+{
+   return insertValue(it, std::move(data));
+}
+
+template <typename T, size_t N, typename A>
+template <class U>
+typename unrolled_list <T, N, A> :: iterator
+unrolled_list <T, N, A> :: insertValue(iterator it, U && data)
+{
+   // inserting at the end means appending to the last block
+   if (it.p == nullptr)
+   {
+      if (!pTail || pTail->count == N)
+      {
+         Block * pNew = createBlock();
+         pNew->pPrev = pTail;
+         if (pTail)
+            pTail->pNext = pNew;
+         else
+            pHead = pNew;
+         pTail = pNew;
+      }
+      it = iterator(pTail, pTail->count);
+   }
+
+   // no room in this block: give half of it to a new neighbor
+   if (it.p->count == N)
+   {
+      Block * pNew = splitBlock(it.p);
+      if (it.i > it.p->count)
+         it = iterator(pNew, it.i - it.p->count);
+   }
+
+   // if the element cannot be built, slide the rest back over the hole
+   it.p->openGap(it.i);
+   it.p->count++;
+   try
+   {
+      it.p->construct(it.i, std::forward<U>(data));
+   }
+   catch (...)
+   {
+      it.p->closeGap(it.i);
+      if (--it.p->count == 0)
+         removeBlock(it.p);
+      throw;
+   }
+   numElements++;
+   return it;
+}
+
+/*********************************************
+ * UNROLLED LIST :: POP BACK and POP FRONT
+ * remove an element from either end
+ *    INPUT  :
+ *    OUTPUT :
+ *    COST   : O(1) and O(N)
+ *********************************************/
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: pop_back()
+{
+   if (pTail)
+      erase(iterator(pTail, pTail->count - 1));
+}
+
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: pop_front()
+{
+   if (pHead)
+      erase(begin());
+}
+
+/*********************************************
+ * UNROLLED LIST :: CLEAR
+ * remove every element and free every block
+ *     INPUT  :
+ *     OUTPUT :
+ *     COST   : O(n)
+ *********************************************/
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: clear()
+{
+   while (pHead)
+   {
+      Block * pDelete = pHead;
+      pHead = pHead->pNext;
+      for (size_t i = 0; i < pDelete->count; i++)
+         (*pDelete)[i].~T();
+      destroyBlock(pDelete);
+   }
+
+   pHead = pTail = nullptr;
+   numElements = 0;
+}
+
+/******************************************
+ * UNROLLED LIST :: ERASE
+ * remove an element, then merge the block with its
+ * successor if it is less than half full and the
+ * two fit in one
+ *     INPUT  : an iterator to the element being removed
+ *     OUTPUT : iterator to the element that followed it
+ *     COST   : O(N)
+ ******************************************/
+template <typename T, size_t N, typename A>
+typename unrolled_list <T, N, A> :: iterator
+unrolled_list <T, N, A> :: erase(const iterator & it)
+{
+   if (empty() || it.p == nullptr)
+      return end();
+
+   Block * pBlock = it.p;
+   size_t i = it.i;
+
+   (*pBlock)[i].~T();
+   pBlock->closeGap(i);
+   pBlock->count--;
+   numElements--;
+
+   // an empty block goes away entirely
+   if (pBlock->count == 0)
+   {
+      Block * pNext = pBlock->pNext;
+      removeBlock(pBlock);
+      return iterator(pNext, 0);
+   }
+
+   // a sparse block absorbs its successor
+   if (pBlock->count < N / 2 && pBlock->pNext &&
+       pBlock->count + pBlock->pNext->count <= N)
+      mergeNext(pBlock);
+
+   if (i < pBlock->count)
+      return iterator(pBlock, i);
+   return iterator(pBlock->pNext, 0);
+}
+
+/*********************************************
+ * UNROLLED LIST :: CREATE BLOCK and DESTROY BLOCK
+ * get an empty block from the allocator and give it back
+ *********************************************/
+template <typename T, size_t N, typename A>
+typename unrolled_list <T, N, A> :: Block * unrolled_list <T, N, A> :: createBlock()
+{
+   Block * pBlock = BlockTraits::allocate(alloc, 1);
+   BlockTraits::construct(alloc, pBlock);
+   return pBlock;
+}
+
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: destroyBlock(Block * pBlock)
+{
+   BlockTraits::destroy(alloc, pBlock);
+   BlockTraits::deallocate(alloc, pBlock, 1);
+}
+
+/*********************************************
+ * UNROLLED LIST :: REMOVE BLOCK
+ * unlink an empty block and give it back
+ *    INPUT  : a block holding no elements
+ *    OUTPUT :
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: removeBlock(Block * pBlock)
+{
+   assert(pBlock->count == 0);
+   if (pBlock->pPrev)
+      pBlock->pPrev->pNext = pBlock->pNext;
+   else
+      pHead = pBlock->pNext;
+   if (pBlock->pNext)
+      pBlock->pNext->pPrev = pBlock->pPrev;
+   else
+      pTail = pBlock->pPrev;
+   destroyBlock(pBlock);
+}
+
+/*********************************************
+ * UNROLLED LIST :: SPLIT BLOCK
+ * move the upper half of a full block into a new
+ * block linked in right after it
+ *    INPUT  : a full block
+ *    OUTPUT : the new block
+ *    COST   : O(N)
+ *********************************************/
+template <typename T, size_t N, typename A>
+typename unrolled_list <T, N, A> :: Block * unrolled_list <T, N, A> :: splitBlock(Block * pBlock)
+{
+   Block * pNew = createBlock();
+
+   size_t keep = pBlock->count / 2;
+   for (size_t j = keep; j < pBlock->count; j++)
+      pBlock->relocate(j, pNew, j - keep);
+   pNew->count = pBlock->count - keep;
+   pBlock->count = keep;
+
+   pNew->pPrev = pBlock;
+   pNew->pNext = pBlock->pNext;
+   if (pBlock->pNext)
+      pBlock->pNext->pPrev = pNew;
+   else
+      pTail = pNew;
+   pBlock->pNext = pNew;
+   return pNew;
+}
+
+/*********************************************
+ * UNROLLED LIST :: MERGE NEXT
+ * move every element of the following block onto
+ * the end of this one and free the following block
+ *    INPUT  : a block with room for its successor
+ *    OUTPUT :
+ *    COST   : O(N)
+ *********************************************/
+template <typename T, size_t N, typename A>
+void unrolled_list <T, N, A> :: mergeNext(Block * pBlock)
+{
+   Block * pNext = pBlock->pNext;
+   assert(pNext && pBlock->count + pNext->count <= N);
+
+   for (size_t j = 0; j < pNext->count; j++)
+      pNext->relocate(j, pBlock, pBlock->count + j);
+   pBlock->count += pNext->count;
+
+   pBlock->pNext = pNext->pNext;
+   if (pNext->pNext)
+      pNext->pNext->pPrev = pBlock;
+   else
+      pTail = pBlock;
+   destroyBlock(pNext);
+}
+
+}; // namespace custom